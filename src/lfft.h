@@ -40,8 +40,19 @@ extern "C" {
 #endif
 
 #include "lfft_config.h"
+#include "lfft_plan.h"
 #include "lfft_fft.h"
 #include "lfft_fft2.h"
+#include "lfft_batch.h"
+#include "lfft_large.h"
+#include "lfft_q15.h"
+#include "lfft_float.h"
+#include "lfft_pruned.h"
+#include "lfft_sdft.h"
+#include "lfft_stft.h"
+#include "lfft_conv.h"
+#include "lfft_partitioned.h"
+#include "lfft_spectrum.h"
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,493 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains a header-only C++ layer of the library.
+ *
+ * lfft::Plan<N, QBits, Sample> calculates ffts with N samples of the type
+ * Sample. Integer samples are fixed point values with QBits decimal places,
+ * floating point samples ignore QBits. The radix-2 kernel is instantiated for
+ * every format, so all shifts are constants and the number of steps and
+ * butterflies is known at compile time and the compiler can unroll the loops.
+ * Plans with different formats can be used side by side in one program. The
+ * switching table is taken from the shared plans of lfft_plan.h.
+ * lfft::Plan<N> uses the format of the C library (LFFT_RHS_BITS, int32_t) and
+ * its result is the same as the result of lfft_fft_inplace().
+ *
+ * lfft::Fft owns a lfft_Fft struct of the C library. It can be passed to all
+ * C functions with get(). The const member functions take a workspace with
+ * workspace() elements, so several threads can share one lfft::Fft.
+ *
+ * Both classes release their memory in the destructor. They can be moved,
+ * but not copied. If there is not enough memory, std::bad_alloc is thrown.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#ifndef _LFFT_HPP
+#define _LFFT_HPP
+
+#include "lfft.h"
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <stdexcept>
+
+namespace lfft
+{
+
+namespace detail
+{
+
+/*!
+ * Integer type of the products of two samples.
+ */
+template<typename Sample>
+struct Product
+{
+    typedef Sample type;
+};
+
+template<>
+struct Product<int8_t>
+{
+    typedef int16_t type;
+};
+
+template<>
+struct Product<int16_t>
+{
+    typedef int32_t type;
+};
+
+template<>
+struct Product<int32_t>
+{
+    typedef int64_t type;
+};
+
+/*!
+ * Arithmetic of fixed point samples with QBits decimal places.
+ */
+template<typename Sample, unsigned QBits, bool Integer = std::numeric_limits<Sample>::is_integer>
+struct Arithmetic
+{
+    static_assert(QBits < std::numeric_limits<Sample>::digits, "wk values need one bit for the integer part");
+
+    //! returns value with QBits decimal places, truncated like the wk values of lfft_plan.h
+    static Sample wk(double value)
+    {
+        return static_cast<Sample>(value*(1L<<QBits));
+    }
+
+    //! returns (a*b)>>QBits
+    static Sample mul(Sample a, Sample b)
+    {
+        return static_cast<Sample>((static_cast<typename Product<Sample>::type>(a)*b)>>QBits);
+    }
+
+    //! returns a/2^steps
+    static Sample divide(Sample a, unsigned steps)
+    {
+        return static_cast<Sample>(a>>steps);
+    }
+};
+
+/*!
+ * Arithmetic of floating point samples.
+ */
+template<typename Sample, unsigned QBits>
+struct Arithmetic<Sample, QBits, false>
+{
+    //! returns value
+    static Sample wk(double value)
+    {
+        return static_cast<Sample>(value);
+    }
+
+    //! returns a*b
+    static Sample mul(Sample a, Sample b)
+    {
+        return a*b;
+    }
+
+    //! returns a/2^steps
+    static Sample divide(Sample a, unsigned steps)
+    {
+        return a/static_cast<Sample>(1UL<<steps);
+    }
+};
+
+/*!
+ * Radix-2 steps from Space to N/2 with reordered data.
+ * wk_real and wk_imag contain the wk values of the step Space at element Space.
+ */
+template<uint32_t N, unsigned QBits, typename Sample, uint32_t Space, bool Done = (Space >= N)>
+struct Steps
+{
+    static void run(const Sample wk_real[], const Sample wk_imag[], Sample real[], Sample imag[], bool calculate_ifft)
+    {
+        typedef Arithmetic<Sample, QBits> A;
+
+        uint32_t j;
+        uint32_t k;
+        Sample real_wk;
+        Sample imag_wk;
+        Sample wk_imag_k;
+
+        for(j = 0; j < N; j += 2*Space)
+        {
+            for(k = 0; k < Space; k++)
+            {
+                // -sin(x) == sin(-x)
+                wk_imag_k = calculate_ifft ? -wk_imag[Space+k] : wk_imag[Space+k];
+
+                // every product is shifted separately like in lfft_fft.c
+                real_wk = A::mul(real[j+k+Space], wk_real[Space+k])-A::mul(imag[j+k+Space], wk_imag_k);
+                imag_wk = A::mul(imag[j+k+Space], wk_real[Space+k])+A::mul(real[j+k+Space], wk_imag_k);
+
+                real[j+k+Space] = real[j+k]-real_wk;
+                imag[j+k+Space] = imag[j+k]-imag_wk;
+                real[j+k] = real[j+k]+real_wk;
+                imag[j+k] = imag[j+k]+imag_wk;
+            }
+        }
+
+        Steps<N, QBits, Sample, 2*Space>::run(wk_real, wk_imag, real, imag, calculate_ifft);
+    }
+};
+
+template<uint32_t N, unsigned QBits, typename Sample, uint32_t Space>
+struct Steps<N, QBits, Sample, Space, true>
+{
+    static void run(const Sample [], const Sample [], Sample [], Sample [], bool)
+    {
+    }
+};
+
+/*!
+ * Returns log2(n) of a power of 2.
+ */
+constexpr uint8_t log2(uint32_t n)
+{
+    return (n <= 1) ? 0 : static_cast<uint8_t>(1+log2(n>>1));
+}
+
+} // namespace detail
+
+/*!
+ * Fft with N samples of the type Sample with QBits decimal places.
+ * The tables are calculated in the constructor.
+ * All calculations take a const plan, so several threads can use one plan
+ * with their own arrays.
+ */
+template<uint32_t N, unsigned QBits = LFFT_RHS_BITS, typename Sample = int32_t>
+class Plan
+{
+    static_assert((N > 0) && ((N&(N-1)) == 0), "N must be to the power of 2");
+
+public:
+    static const uint32_t samples = N; //!< number of samples
+    static const uint8_t steps = detail::log2(N); //!< number of steps
+
+    /*!
+     * Acquires the shared plan and calculates the wk values.
+     * \throw std::bad_alloc not enough memory
+     */
+    Plan() : plan_(lfft_plan_acquire(N)), wk_real_(NULL), wk_imag_(NULL)
+    {
+        uint32_t half;
+        uint32_t k;
+        double angle;
+
+        if(plan_ == NULL)
+        {
+            throw std::bad_alloc();
+        }
+
+        try
+        {
+            wk_real_ = new Sample[N];
+            wk_imag_ = new Sample[N];
+        }
+        catch(...)
+        {
+            release();
+            throw;
+        }
+
+        // wk = e^(-j*2*pi*k/(2*half)), calculated like the wk values of lfft_plan.h
+        wk_real_[0] = 0;
+        wk_imag_[0] = 0;
+        for(half = 1; half < N; half <<= 1)
+        {
+            for(k = 0; k < half; k++)
+            {
+                angle = (2.0f*M_PI*(k*(N/(2*half))))/N;
+                wk_real_[half+k] = detail::Arithmetic<Sample, QBits>::wk(cos(angle));
+                wk_imag_[half+k] = detail::Arithmetic<Sample, QBits>::wk(-sin(angle));
+            }
+        }
+    }
+
+    Plan(Plan && other) noexcept : plan_(other.plan_), wk_real_(other.wk_real_), wk_imag_(other.wk_imag_)
+    {
+        other.plan_ = NULL;
+        other.wk_real_ = NULL;
+        other.wk_imag_ = NULL;
+    }
+
+    Plan & operator=(Plan && other) noexcept
+    {
+        if(this != &other)
+        {
+            release();
+            plan_ = other.plan_;
+            wk_real_ = other.wk_real_;
+            wk_imag_ = other.wk_imag_;
+            other.plan_ = NULL;
+            other.wk_real_ = NULL;
+            other.wk_imag_ = NULL;
+        }
+        return *this;
+    }
+
+    Plan(const Plan &) = delete;
+    Plan & operator=(const Plan &) = delete;
+
+    ~Plan()
+    {
+        release();
+    }
+
+    /*!
+     * Calculates the fft in place.
+     * \param real N real values; replaced by the real result
+     * \param imag N imaginary values; replaced by the imaginary result
+     */
+    void fft(Sample real[], Sample imag[]) const
+    {
+        reorder(real, imag);
+        detail::Steps<N, QBits, Sample, 1>::run(wk_real_, wk_imag_, real, imag, false);
+    }
+
+    /*!
+     * Calculates the inverse-fft in place.
+     * \param real N real values; replaced by the real result
+     * \param imag N imaginary values; replaced by the imaginary result
+     */
+    void ifft(Sample real[], Sample imag[]) const
+    {
+        uint32_t i;
+
+        reorder(real, imag);
+        detail::Steps<N, QBits, Sample, 1>::run(wk_real_, wk_imag_, real, imag, true);
+
+        // divide the results by the fft size (N)
+        for(i = 0; i < N; i++)
+        {
+            real[i] = detail::Arithmetic<Sample, QBits>::divide(real[i], steps);
+            imag[i] = detail::Arithmetic<Sample, QBits>::divide(imag[i], steps);
+        }
+    }
+
+    /*!
+     * Returns the shared plan of the C library.
+     */
+    const lfft_Plan * plan() const
+    {
+        return plan_;
+    }
+
+private:
+    //! reorders the data by swapping the elements with the switching table
+    void reorder(Sample real[], Sample imag[]) const
+    {
+        uint32_t i;
+        uint32_t j;
+        Sample temp;
+
+        // a fft with one sample has nothing to reorder
+        for(i = 0; (N > 1) && (i < N); i++)
+        {
+            j = plan_->switching_table[i];
+            if(i < j)
+            {
+                temp = real[i];
+                real[i] = real[j];
+                real[j] = temp;
+
+                temp = imag[i];
+                imag[i] = imag[j];
+                imag[j] = temp;
+            }
+        }
+    }
+
+    //! releases the plan and the wk values
+    void release()
+    {
+        if(plan_ != NULL)
+        {
+            lfft_plan_release(plan_);
+        }
+        delete[] wk_real_;
+        delete[] wk_imag_;
+        plan_ = NULL;
+        wk_real_ = NULL;
+        wk_imag_ = NULL;
+    }
+
+    lfft_Plan * plan_; //!< shared plan containing the switching table
+    Sample * wk_real_; //!< real wk values of every step; step half starts at element half
+    Sample * wk_imag_; //!< imaginary wk values of every step; step half starts at element half
+};
+
+template<uint32_t N, unsigned QBits, typename Sample>
+const uint32_t Plan<N, QBits, Sample>::samples;
+
+template<uint32_t N, unsigned QBits, typename Sample>
+const uint8_t Plan<N, QBits, Sample>::steps;
+
+/*!
+ * Owner of a lfft_Fft struct of the C library.
+ * The number of samples is set at runtime, every size is possible.
+ */
+class Fft
+{
+public:
+    /*!
+     * Initializes the lfft_Fft struct, see lfft_fft_new_kernel().
+     * \param samples number of samples
+     * \param kernel butterfly algorithm
+     * \throw std::invalid_argument samples is 0 or the kernel is unknown
+     * \throw std::bad_alloc not enough memory
+     */
+    explicit Fft(uint32_t samples, lfft_Kernel kernel = LFFT_KERNEL_RADIX_2) : valid_(false)
+    {
+        switch(lfft_fft_new_kernel(&fft_, samples, kernel))
+        {
+            case 0:
+                valid_ = true;
+                break;
+            case 3:
+                throw std::bad_alloc();
+            default:
+                throw std::invalid_argument("lfft::Fft: invalid number of samples or kernel");
+        }
+    }
+
+    Fft(Fft && other) noexcept : fft_(other.fft_), valid_(other.valid_)
+    {
+        other.valid_ = false;
+    }
+
+    Fft & operator=(Fft && other) noexcept
+    {
+        if(this != &other)
+        {
+            if(valid_)
+            {
+                lfft_fft_delete(&fft_);
+            }
+            fft_ = other.fft_;
+            valid_ = other.valid_;
+            other.valid_ = false;
+        }
+        return *this;
+    }
+
+    Fft(const Fft &) = delete;
+    Fft & operator=(const Fft &) = delete;
+
+    ~Fft()
+    {
+        if(valid_)
+        {
+            lfft_fft_delete(&fft_);
+        }
+    }
+
+    //! returns the lfft_Fft struct for the functions of the C library
+    lfft_Fft * get()
+    {
+        return &fft_;
+    }
+
+    //! returns the lfft_Fft struct for the functions of the C library
+    const lfft_Fft * get() const
+    {
+        return &fft_;
+    }
+
+    //! returns the number of samples
+    uint32_t samples() const
+    {
+        return fft_.samples;
+    }
+
+    //! returns the number of int32_t elements of the workspace, see LFFT_FFT_WORKSPACE()
+    size_t workspace() const
+    {
+        return LFFT_FFT_WORKSPACE(&fft_);
+    }
+
+    //! calculates the fft in place with the workspace of the struct, see lfft_fft_inplace()
+    void fft(int32_t real[], int32_t imag[])
+    {
+        lfft_fft_inplace(&fft_, real, imag, fft_.workspace);
+    }
+
+    //! calculates the fft in place with a caller provided workspace, see lfft_fft_inplace()
+    void fft(int32_t real[], int32_t imag[], int32_t workspace[]) const
+    {
+        lfft_fft_inplace(&fft_, real, imag, workspace);
+    }
+
+    //! calculates the inverse-fft in place with the workspace of the struct, see lfft_ifft_inplace()
+    void ifft(int32_t real[], int32_t imag[])
+    {
+        lfft_ifft_inplace(&fft_, real, imag, fft_.workspace);
+    }
+
+    //! calculates the inverse-fft in place with a caller provided workspace, see lfft_ifft_inplace()
+    void ifft(int32_t real[], int32_t imag[], int32_t workspace[]) const
+    {
+        lfft_ifft_inplace(&fft_, real, imag, workspace);
+    }
+
+private:
+    lfft_Fft fft_; //!< struct of the C library
+    bool valid_; //!< false if fft_ is not initialized or moved
+};
+
+} // namespace lfft
+
+#endif /* _LFFT_HPP */
@@ -0,0 +1,317 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains functions to calculate many ffts of the same size with
+ * one call. LFFT_BATCH_LANES signals are interleaved, i.e. the n-th sample of
+ * every signal is stored next to each other. All signals share the wk values
+ * and the loop control of a butterfly, and the innermost loop over the signals
+ * is vectorized by the compiler even for small ffts.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#include "lfft_batch.h"
+
+#include <stdlib.h>
+
+#ifdef LFFT_USE_AVX2
+#include <immintrin.h>
+#endif /* LFFT_USE_AVX2 */
+
+/*!
+ * Calculates the fft or ifft of count signals.
+ * \param fft initialized lfft_Fft struct
+ * \param count number of signals
+ * \param real real input data
+ * \param imag imaginary input data; NULL if the imaginary part is 0
+ * \param in_stride distance between the first samples of two signals
+ * \param result_real array for the real results
+ * \param result_imag array for the imaginary results
+ * \param out_stride distance between the first results of two signals
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ * \return 0: successful 3: not enough memory
+ */
+static lfft_errno _lfft_fft_batch(const lfft_Fft * fft, uint32_t count,
+        const int32_t real[], const int32_t imag[], uint32_t in_stride,
+        int32_t result_real[], int32_t result_imag[], uint32_t out_stride, bool calculate_ifft);
+
+/*!
+ * Calculates the radix-2 butterflies of LFFT_BATCH_LANES interleaved signals.
+ * The arithmetic is the same as in lfft_fft.c, so the results match the
+ * results of a single fft.
+ * \param fft initialized lfft_Fft struct
+ * \param real reordered interleaved real data; replaced by the real result
+ * \param imag reordered interleaved imaginary data; replaced by the imaginary result
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+static void _lfft_batch_radix2(const lfft_Fft * fft, int32_t * real, int32_t * imag, bool calculate_ifft);
+
+#if defined(LFFT_USE_AVX2) && (LFFT_BATCH_LANES == 8)
+/*!
+ * Calculates one radix-2 butterfly in 8 interleaved signals.
+ * \param real_1 real part of the first operants; replaced by the result
+ * \param imag_1 imaginary part of the first operants; replaced by the result
+ * \param real_2 real part of the second operants; replaced by the result
+ * \param imag_2 imaginary part of the second operants; replaced by the result
+ * \param wk_real real wk value in every lane
+ * \param wk_imag imaginary wk value in every lane
+ */
+static void _lfft_batch_butterfly_avx2(int32_t * real_1, int32_t * imag_1,
+        int32_t * real_2, int32_t * imag_2, __m256i wk_real, __m256i wk_imag);
+#endif /* LFFT_USE_AVX2 */
+
+lfft_errno lfft_fft_batch(const lfft_Fft * fft, uint32_t count,
+        const int32_t real[], uint32_t in_stride,
+        int32_t result_real[], int32_t result_imag[], uint32_t out_stride)
+{
+    return _lfft_fft_batch(fft, count, real, NULL, in_stride, result_real, result_imag, out_stride, false);
+}
+
+lfft_errno lfft_fft_batch_complex(const lfft_Fft * fft, uint32_t count,
+        const int32_t real[], const int32_t imag[], uint32_t in_stride,
+        int32_t result_real[], int32_t result_imag[], uint32_t out_stride)
+{
+    return _lfft_fft_batch(fft, count, real, imag, in_stride, result_real, result_imag, out_stride, false);
+}
+
+lfft_errno lfft_ifft_batch(const lfft_Fft * fft, uint32_t count,
+        const int32_t real[], uint32_t in_stride,
+        int32_t result_real[], int32_t result_imag[], uint32_t out_stride)
+{
+    return _lfft_fft_batch(fft, count, real, NULL, in_stride, result_real, result_imag, out_stride, true);
+}
+
+lfft_errno lfft_ifft_batch_complex(const lfft_Fft * fft, uint32_t count,
+        const int32_t real[], const int32_t imag[], uint32_t in_stride,
+        int32_t result_real[], int32_t result_imag[], uint32_t out_stride)
+{
+    return _lfft_fft_batch(fft, count, real, imag, in_stride, result_real, result_imag, out_stride, true);
+}
+
+static lfft_errno _lfft_fft_batch(const lfft_Fft * fft, uint32_t count,
+        const int32_t real[], const int32_t imag[], uint32_t in_stride,
+        int32_t result_real[], int32_t result_imag[], uint32_t out_stride, bool calculate_ifft)
+{
+    int32_t * workspace = (int32_t *) malloc(LFFT_BATCH_WORKSPACE(fft->samples)*sizeof(int32_t));
+
+    if(workspace == NULL)
+    {
+        return 3;
+    }
+
+    _lfft_fft_batch_calculation(fft, count, real, imag, in_stride,
+            result_real, result_imag, out_stride, calculate_ifft, workspace);
+
+    free(workspace);
+
+    return 0;
+}
+
+void _lfft_fft_batch_calculation(const lfft_Fft * fft, uint32_t count,
+        const int32_t real[], const int32_t imag[], uint32_t in_stride,
+        int32_t result_real[], int32_t result_imag[], uint32_t out_stride, bool calculate_ifft,
+        int32_t workspace[])
+{
+    uint32_t b;
+    uint32_t i;
+    uint32_t l;
+    uint32_t lanes;
+    size_t offset; // element offsets of count signals can exceed 32 bits
+
+    // interleaved data of LFFT_BATCH_LANES signals
+    // the n-th sample of lane l is stored at batch_real[n*LFFT_BATCH_LANES+l]
+    int32_t * batch_real = workspace;
+    int32_t * batch_imag = &workspace[(size_t) fft->samples*LFFT_BATCH_LANES];
+
+    // the mixed radix and bluestein calculations are not interleaved; the
+    // bluestein fft of 2*samples-1 <= inner < 4*samples elements needs less
+    // than 8*samples elements of the workspace
+    if((fft->plan->radix_count > 0)||(fft->plan->inner != NULL))
+    {
+        for(b = 0; b < count; b++)
+        {
+            for(i = 0; i < fft->samples; i++)
+            {
+                offset = (size_t) b*in_stride+fft->switching_table[i];
+                result_real[(size_t) b*out_stride+i] = real[offset]<<LFFT_RHS_BITS;
+                result_imag[(size_t) b*out_stride+i] = (imag == NULL) ? 0 : imag[offset]<<LFFT_RHS_BITS;
+            }
+
+            _lfft_fft_calculation_buffer(fft, &result_real[(size_t) b*out_stride], &result_imag[(size_t) b*out_stride],
+                    calculate_ifft, workspace);
+        }
+        return;
+    }
+
+    for(b = 0; b < count; b += LFFT_BATCH_LANES)
+    {
+        lanes = (count-b < LFFT_BATCH_LANES) ? (uint32_t) (count-b) : LFFT_BATCH_LANES;
+
+        // reorder and interleave the input data and multiply with 2^LFFT_RHS_BITS
+        // unused lanes of the last batch are set to 0
+        for(i = 0; i < fft->samples; i++)
+        {
+            for(l = 0; l < LFFT_BATCH_LANES; l++)
+            {
+                if(l < lanes)
+                {
+                    offset = (size_t) (b+l)*in_stride+fft->switching_table[i];
+                    batch_real[i*LFFT_BATCH_LANES+l] = real[offset]<<LFFT_RHS_BITS;
+                    batch_imag[i*LFFT_BATCH_LANES+l] = (imag == NULL) ? 0 : imag[offset]<<LFFT_RHS_BITS;
+                }
+                else
+                {
+                    batch_real[i*LFFT_BATCH_LANES+l] = 0;
+                    batch_imag[i*LFFT_BATCH_LANES+l] = 0;
+                }
+            }
+        }
+
+        _lfft_batch_radix2(fft, batch_real, batch_imag, calculate_ifft);
+
+        // deinterleave the results and divide the results of the ifft by
+        // the fft size, x/fft->samples == x>>fft->steps
+        for(l = 0; l < lanes; l++)
+        {
+            offset = (size_t) (b+l)*out_stride;
+            for(i = 0; i < fft->samples; i++)
+            {
+                if(calculate_ifft)
+                {
+                    result_real[offset+i] = batch_real[i*LFFT_BATCH_LANES+l]>>fft->steps;
+                    result_imag[offset+i] = batch_imag[i*LFFT_BATCH_LANES+l]>>fft->steps;
+                }
+                else
+                {
+                    result_real[offset+i] = batch_real[i*LFFT_BATCH_LANES+l];
+                    result_imag[offset+i] = batch_imag[i*LFFT_BATCH_LANES+l];
+                }
+            }
+        }
+    }
+}
+
+static void _lfft_batch_radix2(const lfft_Fft * fft, int32_t * real, int32_t * imag, bool calculate_ifft)
+{
+    uint8_t i;
+    uint32_t j;
+    uint32_t k;
+
+    // temporary variables
+    int32_t * real_1;
+    int32_t * imag_1;
+    int32_t * real_2;
+    int32_t * imag_2;
+    int32_t wk_real;
+    int32_t wk_imag;
+#if !defined(LFFT_USE_AVX2) || (LFFT_BATCH_LANES != 8)
+    uint32_t l;
+    int32_t real_a[LFFT_BATCH_LANES];
+    int32_t imag_a[LFFT_BATCH_LANES];
+    int32_t real_wk[LFFT_BATCH_LANES];
+    int32_t imag_wk[LFFT_BATCH_LANES];
+#endif /* LFFT_USE_AVX2 */
+
+    uint32_t space_butterfly_operant = 1; // space between operants of butterfly graph
+    const int32_t * wk; // contiguous wk values of the step, see LFFT_STEP_WK()
+
+    for(i = 0; i < fft->steps; i++)
+    {
+        // all butterflies with the same wk value are calculated one after
+        // another, so the wk value is loaded only once per step
+        wk = &fft->step_wk[LFFT_STEP_WK(space_butterfly_operant)];
+        for(k = 0; k < space_butterfly_operant; k++)
+        {
+            wk_real = wk[2*k];
+            // -sin(x) == sin(-x)
+            wk_imag = calculate_ifft ? -wk[2*k+1] : wk[2*k+1];
+
+            for(j = k; j < fft->samples; j += 2*space_butterfly_operant)
+            {
+                real_1 = &real[j*LFFT_BATCH_LANES];
+                imag_1 = &imag[j*LFFT_BATCH_LANES];
+                real_2 = &real[(j+space_butterfly_operant)*LFFT_BATCH_LANES];
+                imag_2 = &imag[(j+space_butterfly_operant)*LFFT_BATCH_LANES];
+
+                // same butterfly in every lane
+#if defined(LFFT_USE_AVX2) && (LFFT_BATCH_LANES == 8)
+                // the same operations as in _lfft_butterfly_avx2() of lfft_fft.c,
+                // gcc doesn't vectorize the loop below by itself
+                _lfft_batch_butterfly_avx2(real_1, imag_1, real_2, imag_2,
+                        _mm256_set1_epi32(wk_real), _mm256_set1_epi32(wk_imag));
+#else
+                // all lanes are loaded before the first store, so the
+                // compiler doesn't have to check if the operants overlap
+                for(l = 0; l < LFFT_BATCH_LANES; l++)
+                {
+                    real_a[l]  = real_1[l];
+                    imag_a[l]  = imag_1[l];
+                    real_wk[l] = ((real_2[l]*wk_real)>>LFFT_RHS_BITS)-((imag_2[l]*wk_imag)>>LFFT_RHS_BITS);
+                    imag_wk[l] = ((imag_2[l]*wk_real)>>LFFT_RHS_BITS)+((real_2[l]*wk_imag)>>LFFT_RHS_BITS);
+                }
+                for(l = 0; l < LFFT_BATCH_LANES; l++)
+                {
+                    real_1[l] = real_a[l]+real_wk[l];
+                    imag_1[l] = imag_a[l]+imag_wk[l];
+                    real_2[l] = real_a[l]-real_wk[l];
+                    imag_2[l] = imag_a[l]-imag_wk[l];
+                }
+#endif /* LFFT_USE_AVX2 */
+            }
+        }
+        // space_butterfly_operant = space_butterfly_operant*2
+        space_butterfly_operant <<= 1;
+    }
+}
+
+#if defined(LFFT_USE_AVX2) && (LFFT_BATCH_LANES == 8)
+static void _lfft_batch_butterfly_avx2(int32_t * real_1, int32_t * imag_1,
+        int32_t * real_2, int32_t * imag_2, __m256i wk_real, __m256i wk_imag)
+{
+    __m256i r_1 = _mm256_loadu_si256((__m256i *) real_1);
+    __m256i i_1 = _mm256_loadu_si256((__m256i *) imag_1);
+    __m256i r_2 = _mm256_loadu_si256((__m256i *) real_2);
+    __m256i i_2 = _mm256_loadu_si256((__m256i *) imag_2);
+    __m256i t_real;
+    __m256i t_imag;
+
+    // t = operant_2*wk, every product is shifted by LFFT_RHS_BITS
+    t_real = _mm256_sub_epi32(
+            _mm256_srai_epi32(_mm256_mullo_epi32(r_2, wk_real), LFFT_RHS_BITS),
+            _mm256_srai_epi32(_mm256_mullo_epi32(i_2, wk_imag), LFFT_RHS_BITS));
+    t_imag = _mm256_add_epi32(
+            _mm256_srai_epi32(_mm256_mullo_epi32(i_2, wk_real), LFFT_RHS_BITS),
+            _mm256_srai_epi32(_mm256_mullo_epi32(r_2, wk_imag), LFFT_RHS_BITS));
+
+    _mm256_storeu_si256((__m256i *) real_1, _mm256_add_epi32(r_1, t_real));
+    _mm256_storeu_si256((__m256i *) imag_1, _mm256_add_epi32(i_1, t_imag));
+    _mm256_storeu_si256((__m256i *) real_2, _mm256_sub_epi32(r_1, t_real));
+    _mm256_storeu_si256((__m256i *) imag_2, _mm256_sub_epi32(i_1, t_imag));
+}
+#endif /* LFFT_USE_AVX2 */
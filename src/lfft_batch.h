@@ -0,0 +1,154 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains functions to calculate many ffts of the same size with
+ * one call. LFFT_BATCH_LANES signals are interleaved, i.e. the n-th sample of
+ * every signal is stored next to each other. All signals share the wk values
+ * and the loop control of a butterfly, and the innermost loop over the signals
+ * is vectorized by the compiler even for small ffts.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#ifndef _LFFT_BATCH_H
+#define _LFFT_BATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lfft_config.h"
+#include "lfft_fft.h"
+
+/*!
+ * number of int32_t elements of the workspace of _lfft_fft_batch_calculation()
+ */
+#define LFFT_BATCH_WORKSPACE(samples) (2*LFFT_BATCH_LANES*(size_t) (samples))
+
+/*!
+ * Calculates the fft of count signals.
+ * It uses only real input data, the imaginary part is set to 0.
+ * The n-th sample of signal b is real[b*in_stride+n] and the n-th result of
+ * signal b is result_real[b*out_stride+n]. The result has LFFT_RHS_BITS decimal
+ * places like lfft_fft_out(). The batch functions always use radix-2
+ * butterflies, the kernel of fft is ignored. Sizes which are not to the power
+ * of 2 are calculated one signal after the other.
+ * \param fft initialized lfft_Fft struct
+ * \param count number of signals
+ * \param real real input data for fft; must not overlap with the result
+ * \param in_stride distance between the first samples of two signals
+ * \param result_real array for the real results
+ * \param result_imag array for the imaginary results
+ * \param out_stride distance between the first results of two signals
+ * \return 0: successful 3: not enough memory
+ */
+lfft_errno lfft_fft_batch(const lfft_Fft * fft, uint32_t count,
+        const int32_t real[], uint32_t in_stride,
+        int32_t result_real[], int32_t result_imag[], uint32_t out_stride);
+
+/*!
+ * Calculates the fft of count signals.
+ * It uses real input and imaginary input data.
+ * See lfft_fft_batch().
+ * \param fft initialized lfft_Fft struct
+ * \param count number of signals
+ * \param real real input data for fft; must not overlap with the result
+ * \param imag imaginary input data for fft; must not overlap with the result
+ * \param in_stride distance between the first samples of two signals
+ * \param result_real array for the real results
+ * \param result_imag array for the imaginary results
+ * \param out_stride distance between the first results of two signals
+ * \return 0: successful 3: not enough memory
+ */
+lfft_errno lfft_fft_batch_complex(const lfft_Fft * fft, uint32_t count,
+        const int32_t real[], const int32_t imag[], uint32_t in_stride,
+        int32_t result_real[], int32_t result_imag[], uint32_t out_stride);
+
+/*!
+ * Calculates the inverse-fft of count signals.
+ * It uses only real input data, the imaginary part is set to 0.
+ * See lfft_fft_batch().
+ * \param fft initialized lfft_Fft struct
+ * \param count number of signals
+ * \param real real input data for ifft; must not overlap with the result
+ * \param in_stride distance between the first samples of two signals
+ * \param result_real array for the real results
+ * \param result_imag array for the imaginary results
+ * \param out_stride distance between the first results of two signals
+ * \return 0: successful 3: not enough memory
+ */
+lfft_errno lfft_ifft_batch(const lfft_Fft * fft, uint32_t count,
+        const int32_t real[], uint32_t in_stride,
+        int32_t result_real[], int32_t result_imag[], uint32_t out_stride);
+
+/*!
+ * Calculates the inverse-fft of count signals.
+ * It uses real input and imaginary input data.
+ * See lfft_fft_batch().
+ * \param fft initialized lfft_Fft struct
+ * \param count number of signals
+ * \param real real input data for ifft; must not overlap with the result
+ * \param imag imaginary input data for ifft; must not overlap with the result
+ * \param in_stride distance between the first samples of two signals
+ * \param result_real array for the real results
+ * \param result_imag array for the imaginary results
+ * \param out_stride distance between the first results of two signals
+ * \return 0: successful 3: not enough memory
+ */
+lfft_errno lfft_ifft_batch_complex(const lfft_Fft * fft, uint32_t count,
+        const int32_t real[], const int32_t imag[], uint32_t in_stride,
+        int32_t result_real[], int32_t result_imag[], uint32_t out_stride);
+
+/*!
+ * Calculates the fft or ifft of count signals in a caller provided workspace.
+ * The batch functions above allocate the workspace for every call, this
+ * function is used if the workspace is reused (e.g. by the workers of a
+ * lfft_Pool). Don't use this function if it is possible to use the above
+ * functions.
+ * \param fft initialized lfft_Fft struct
+ * \param count number of signals
+ * \param real real input data; must not overlap with the result
+ * \param imag imaginary input data; must not overlap with the result; NULL if the imaginary part is 0
+ * \param in_stride distance between the first samples of two signals
+ * \param result_real array for the real results
+ * \param result_imag array for the imaginary results
+ * \param out_stride distance between the first results of two signals
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ * \param workspace array with LFFT_BATCH_WORKSPACE(fft->samples) elements
+ */
+void _lfft_fft_batch_calculation(const lfft_Fft * fft, uint32_t count,
+        const int32_t real[], const int32_t imag[], uint32_t in_stride,
+        int32_t result_real[], int32_t result_imag[], uint32_t out_stride, bool calculate_ifft,
+        int32_t workspace[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LFFT_BATCH_H */
@@ -69,6 +69,27 @@ extern "C" {
  */
 #define LFFT_RHS_BITS 8
 
+/*!
+ * number of signals which are interleaved by the batch functions
+ * (8 lanes fill a 256 bit vector register with int32_t values)
+ */
+#define LFFT_BATCH_LANES 8
+
+/*!
+ * alignment in bytes of the wk values of the steps
+ * (32 bytes are a 256 bit vector register)
+ */
+#define LFFT_ALIGNMENT 32
+
+/*!
+ * use AVX2 instructions for the radix-2 butterflies if the compiler
+ * generates them (e.g. gcc -mavx2, see the cmake option ENABLE_AVX2)
+ * define LFFT_NO_SIMD to use the portable calculation only
+ */
+#if defined(__AVX2__) && !defined(LFFT_NO_SIMD)
+#define LFFT_USE_AVX2
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,287 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*! \file
+ * This file contains functions to calculate the convolution and the
+ * correlation of a stream of integer input data with a fixed filter by the
+ * fast convolution with the overlap-add or the overlap-save method.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#include "lfft_conv.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*!
+ * Initializes the convolution, see lfft_conv_new().
+ * \param conv pointer to struct to be initialized
+ * \param filter integer filter taps
+ * \param taps number of elements of filter
+ * \param block number of samples of every block; 0 to select the block size
+ * \param overlap method to split the input stream
+ * \param reverse true: the filter taps are used in reverse order (correlation)
+ * \return 0: successful 1: (block+1)/2+taps-1 is too big 2: taps is 0 or unknown overlap 3: not enough memory
+ */
+static lfft_errno _lfft_conv_init(lfft_Conv * conv, const int32_t filter[], uint32_t taps, uint32_t block,
+        lfft_Overlap overlap, bool reverse);
+
+/*!
+ * Selects the fft size with the least operations per output sample.
+ * A block needs two ffts with samples/2*log2(samples) butterflies and
+ * samples complex multiplications and gives 2*(samples-taps+1) output
+ * samples.
+ * \param taps number of filter taps
+ * \return fft size; to the power of 2; 0 if taps is too big
+ */
+static uint32_t _lfft_conv_samples(uint32_t taps);
+
+lfft_errno lfft_conv_new(lfft_Conv * conv, const int32_t filter[], uint32_t taps, uint32_t block,
+        lfft_Overlap overlap)
+{
+    return _lfft_conv_init(conv, filter, taps, block, overlap, false);
+}
+
+lfft_errno lfft_conv_new_correlation(lfft_Conv * conv, const int32_t reference[], uint32_t taps, uint32_t block,
+        lfft_Overlap overlap)
+{
+    return _lfft_conv_init(conv, reference, taps, block, overlap, true);
+}
+
+void lfft_conv_delete(lfft_Conv * conv)
+{
+    lfft_fft_delete(&conv->fft);
+    free(conv->filter_real);
+    free(conv->filter_imag);
+    free(conv->history);
+}
+
+void lfft_conv_reset(lfft_Conv * conv)
+{
+    uint32_t length = (conv->overlap == LFFT_OVERLAP_ADD) ? conv->taps-1 : conv->samples-conv->half;
+
+    memset(conv->history, 0, length*sizeof(int32_t));
+}
+
+void lfft_conv_process(lfft_Conv * conv, const int32_t input[], int32_t output[])
+{
+    uint32_t i;
+    uint32_t n;
+    uint32_t offset; // first input sample of the imaginary part relative to the real part
+    uint32_t history = conv->samples-conv->half; // LFFT_OVERLAP_SAVE: number of previous input samples
+    uint32_t tail = conv->taps-1; // LFFT_OVERLAP_ADD: number of samples which overlap the next block
+    uint32_t length_real = conv->half+tail; // LFFT_OVERLAP_ADD: result samples of the real part
+    uint32_t length_imag = conv->block-conv->half+tail; // LFFT_OVERLAP_ADD: result samples of the imaginary part
+    uint8_t shift = LFFT_RHS_BITS+conv->steps; // removes the decimal places of the filter and divides by samples
+    int32_t * real = conv->fft.result_real;
+    int32_t * imag = conv->fft.result_imag;
+    int64_t product_real;
+    int64_t product_imag;
+
+    // the filter is real, so the real and the imaginary part are filtered
+    // independently; the real part calculates the first conv->half output
+    // samples of the block, the imaginary part the remaining samples
+    if(conv->overlap == LFFT_OVERLAP_SAVE)
+    {
+        // samples input samples which end with the last sample of the part
+        offset = conv->block-conv->half;
+        for(i = 0; i < conv->samples; i++)
+        {
+            real[i] = ((i < history) ? conv->history[i] : input[i-history])<<LFFT_RHS_BITS;
+            n = i+offset;
+            imag[i] = ((n < history) ? conv->history[n] : input[n-history])<<LFFT_RHS_BITS;
+        }
+    }
+    else
+    {
+        // the parts followed by zeros
+        offset = conv->half;
+        for(i = 0; i < conv->samples; i++)
+        {
+            real[i] = (i < conv->half) ? input[i]<<LFFT_RHS_BITS : 0;
+            imag[i] = (offset+i < conv->block) ? input[offset+i]<<LFFT_RHS_BITS : 0;
+        }
+    }
+
+    // natural order --> bit reversed spectrum
+    _lfft_fft_dif(&conv->fft, real, imag, false);
+
+    // both spectra are bit reversed, the ifft is divided by samples here
+    // because the unscaled product could exceed 32 bits
+    for(i = 0; i < conv->samples; i++)
+    {
+        product_real = (int64_t) real[i]*conv->filter_real[i]-(int64_t) imag[i]*conv->filter_imag[i];
+        product_imag = (int64_t) real[i]*conv->filter_imag[i]+(int64_t) imag[i]*conv->filter_real[i];
+        real[i] = (int32_t) (product_real>>shift);
+        imag[i] = (int32_t) (product_imag>>shift);
+    }
+
+    // bit reversed spectrum --> natural order
+    _lfft_fft_dit(&conv->fft, real, imag, true);
+
+    if(conv->overlap == LFFT_OVERLAP_SAVE)
+    {
+        // the first samples-half results contain the wrapped around tail
+        memcpy(output, &real[history], conv->half*sizeof(int32_t));
+        memcpy(&output[conv->half], &imag[history+conv->half-offset], offset*sizeof(int32_t));
+
+        // keep the last samples-half input samples
+        if(history > conv->block)
+        {
+            memmove(conv->history, &conv->history[conv->block], (history-conv->block)*sizeof(int32_t));
+            memcpy(&conv->history[history-conv->block], input, conv->block*sizeof(int32_t));
+        }
+        else
+        {
+            memcpy(conv->history, &input[conv->block-history], history*sizeof(int32_t));
+        }
+        return;
+    }
+
+    // add the tail of the previous blocks and both parts
+    for(n = 0; n < conv->block; n++)
+    {
+        output[n] = ((n < tail) ? conv->history[n] : 0)+
+                ((n < length_real) ? real[n] : 0)+
+                ((n >= offset) ? imag[n-offset] : 0);
+    }
+
+    // the new tail; history[block+i] is read before it is replaced
+    for(i = 0; i < tail; i++)
+    {
+        n = conv->block+i;
+        conv->history[i] = ((n < tail) ? conv->history[n] : 0)+
+                ((n < length_real) ? real[n] : 0)+
+                ((n-offset < length_imag) ? imag[n-offset] : 0);
+    }
+}
+
+static lfft_errno _lfft_conv_init(lfft_Conv * conv, const int32_t filter[], uint32_t taps, uint32_t block,
+        lfft_Overlap overlap, bool reverse)
+{
+    uint32_t i;
+    uint32_t samples;
+    lfft_errno error;
+
+    if((taps == 0)||((overlap != LFFT_OVERLAP_ADD)&&(overlap != LFFT_OVERLAP_SAVE)))
+    {
+        return 2;
+    }
+
+    if(block == 0)
+    {
+        samples = _lfft_conv_samples(taps);
+        if(samples == 0)
+        {
+            return 1;
+        }
+        block = 2*(samples-taps+1);
+    }
+    else
+    {
+        // every half block needs half+taps-1 result samples
+        if(((uint64_t) block+1)/2+taps-1 > (1UL<<31))
+        {
+            return 1;
+        }
+        for(samples = 1; samples < block/2+block%2+taps-1; samples <<= 1)
+        {
+        }
+    }
+
+    error = lfft_fft_new(&conv->fft, samples);
+    if(error != 0)
+    {
+        return error;
+    }
+
+    conv->samples = samples;
+    conv->steps   = conv->fft.steps;
+    conv->taps    = taps;
+    conv->block   = block;
+    conv->half    = block/2+block%2;
+    conv->overlap = (uint8_t) overlap;
+
+    // allocate memory, the stream starts with zeros
+    conv->filter_real = (int32_t *) malloc(samples*sizeof(int32_t));
+    conv->filter_imag = (int32_t *) calloc(samples, sizeof(int32_t));
+    conv->history     = (int32_t *) calloc((overlap == LFFT_OVERLAP_ADD) ? taps : samples-conv->half+1, sizeof(int32_t));
+
+    if((conv->filter_real == NULL)||(conv->filter_imag == NULL)||(conv->history == NULL))
+    {
+        lfft_conv_delete(conv);
+        return 3;
+    }
+
+    // the correlation is the convolution with the reversed reference signal
+    for(i = 0; i < samples; i++)
+    {
+        conv->filter_real[i] = (i < taps) ? filter[reverse ? taps-1-i : i]<<LFFT_RHS_BITS : 0;
+    }
+
+    _lfft_fft_dif(&conv->fft, conv->filter_real, conv->filter_imag, false);
+
+    return 0;
+}
+
+static uint32_t _lfft_conv_samples(uint32_t taps)
+{
+    uint32_t samples;
+    uint32_t best_samples = 0;
+    uint64_t cost;
+    uint64_t best_cost = 0;
+    uint8_t steps;
+
+    // smallest fft size with at least one output sample
+    for(samples = 1, steps = 0; samples < taps; samples <<= 1, steps++)
+    {
+        if(samples == (1UL<<31))
+        {
+            return 0;
+        }
+    }
+
+    // compare cost/(samples-taps+1) without division:
+    //   cost*(best_samples-taps+1) < best_cost*(samples-taps+1)
+    for(; ; samples <<= 1, steps++)
+    {
+        cost = (uint64_t) samples*(steps+1);
+        if((best_samples == 0)||(cost*(best_samples-taps+1) < best_cost*(samples-taps+1)))
+        {
+            best_samples = samples;
+            best_cost    = cost;
+        }
+
+        if((samples >= LFFT_CONV_MAX_SAMPLES)||(samples == (1UL<<31)))
+        {
+            break;
+        }
+    }
+
+    return best_samples;
+}
@@ -0,0 +1,136 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*! \file
+ * This file contains functions to calculate the convolution and the
+ * correlation of a stream of integer input data with a fixed filter by the
+ * fast convolution with the overlap-add or the overlap-save method.
+ * The spectrum of the filter is calculated once. Every block is transformed
+ * with the decimation in frequency butterflies, which leave the spectrum in
+ * bit reversed order, multiplied with the bit reversed filter spectrum and
+ * transformed back with the decimation in time butterflies, which expect bit
+ * reversed input data. So the switching table is never used and no data is
+ * copied between the steps.
+ * The filter is real, so the first half of a block is filtered in the real
+ * part and the second half in the imaginary part of the same fft.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#ifndef _LFFT_CONV_H
+#define _LFFT_CONV_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lfft_config.h"
+#include "lfft_fft.h"
+
+/*!
+ * largest fft size which is selected by lfft_conv_new() if block is 0
+ */
+#define LFFT_CONV_MAX_SAMPLES (1UL<<16)
+
+/*!
+ * Methods to split the input stream into blocks.
+ */
+typedef enum _lfft_Overlap
+{
+    LFFT_OVERLAP_ADD = 0, //!< zero padded blocks, the tails of the results are added to the next result
+    LFFT_OVERLAP_SAVE = 1 //!< overlapping input blocks, the wrapped around part of the result is discarded
+} lfft_Overlap;
+
+typedef struct _lfft_Conv
+{
+    uint32_t samples; //!< fft size; to the power of 2 and at least half+taps-1
+    uint8_t  steps; //!< log2(samples)
+    uint32_t taps; //!< number of filter taps
+    uint32_t block; //!< number of input samples and output samples of lfft_conv_process()
+    uint32_t half; //!< number of samples of the block which are filtered in the real part; (block+1)/2
+    uint8_t  overlap; //!< lfft_Overlap
+
+    lfft_Fft fft; //!< radix-2 fft with samples elements; fft.result_real and fft.result_imag are the workspace
+    int32_t * filter_real; //!< real bit reversed filter spectrum with LFFT_RHS_BITS decimal places
+    int32_t * filter_imag; //!< imaginary bit reversed filter spectrum with LFFT_RHS_BITS decimal places
+    int32_t * history; //!< LFFT_OVERLAP_ADD: taps-1 tail samples of the last result; LFFT_OVERLAP_SAVE: samples-half last input samples
+} lfft_Conv;
+
+/*!
+ * Initializes the convolution with a filter.
+ * The output sample n of the stream is sum(filter[k]*input[n-k]).
+ * If block is 0, the block size with the least operations per output
+ * sample is selected, see conv->block.
+ * \param conv pointer to struct to be initialized
+ * \param filter integer filter taps
+ * \param taps number of elements of filter
+ * \param block number of samples of every block; 0 to select the block size
+ * \param overlap method to split the input stream
+ * \return 0: successful 1: (block+1)/2+taps-1 is too big 2: taps is 0 or unknown overlap 3: not enough memory
+ */
+lfft_errno lfft_conv_new(lfft_Conv * conv, const int32_t filter[], uint32_t taps, uint32_t block,
+        lfft_Overlap overlap);
+
+/*!
+ * Initializes the correlation with a reference signal.
+ * The output sample n of the stream is sum(reference[k]*input[n-(taps-1)+k]),
+ * the correlation is delayed by taps-1 samples to be causal.
+ * \param conv pointer to struct to be initialized
+ * \param reference integer reference signal
+ * \param taps number of elements of reference
+ * \param block number of samples of every block; 0 to select the block size
+ * \param overlap method to split the input stream
+ * \return 0: successful 1: (block+1)/2+taps-1 is too big 2: taps is 0 or unknown overlap 3: not enough memory
+ */
+lfft_errno lfft_conv_new_correlation(lfft_Conv * conv, const int32_t reference[], uint32_t taps, uint32_t block,
+        lfft_Overlap overlap);
+
+/*!
+ * Deallocate the used memory.
+ * \param conv initialized lfft_Conv struct
+ */
+void lfft_conv_delete(lfft_Conv * conv);
+
+/*!
+ * Starts a new stream, all previous input samples are zero.
+ * \param conv initialized lfft_Conv struct
+ */
+void lfft_conv_reset(lfft_Conv * conv);
+
+/*!
+ * Filters the next conv->block samples of the stream.
+ * \param conv initialized lfft_Conv struct
+ * \param input conv->block integer input samples
+ * \param output conv->block output samples with LFFT_RHS_BITS decimal places
+ */
+void lfft_conv_process(lfft_Conv * conv, const int32_t input[], int32_t output[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LFFT_CONV_H */
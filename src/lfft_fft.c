@@ -28,7 +28,8 @@
 /*! \file
  * This file contains functions to calculate the fft (fast fourier
  * transformation) and ifft (inverse fast fourier transfomration)
- * It uses the radix-2 algorithm for calculation.
+ * It uses the radix-2 algorithm for calculation. Sizes which are not to the
+ * power of 2 are calculated by the functions of lfft_mixed.h.
  * The calculation is optimized for processors without a FPU.
  * float is only used during the initialization process.
  *
@@ -39,27 +40,41 @@
 #include "lfft_fft.h"
 
 #include "lfft_config.h"
+#include "lfft_mixed.h"
 
-#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef LFFT_USE_AVX2
+#include <immintrin.h>
+#endif /* LFFT_USE_AVX2 */
+
+#ifdef LFFT_USE_GENERATED
+#include "lfft_generated_codelets.h"
+#endif /* LFFT_USE_GENERATED */
+
 /*!
  * Initializes the fft and allocates the necessary memory.
  * \param fft pointer to struct to be initialized
- * \param samples number of input samples; must be to the power of 2
- * \return 0: successful 1: samples is not to the power of 2
+ * \param samples number of input samples
+ * \param kernel butterfly algorithm used for the calculation
+ * \return 0: successful 1: samples is 0 2: unknown kernel
+ *         3: not enough memory
  */
-static lfft_errno _lfft_fft_init(lfft_Fft * fft, uint16_t samples);
+static lfft_errno _lfft_fft_init(lfft_Fft * fft, uint32_t samples, lfft_Kernel kernel);
 
 /*!
  * Prepares the input data for the calculation.
  * It uses only real input data, the imaginary part is set to 0.
  * \param fft initialized lfft_Fft struct
  * \param real real input data for fft
+ * \param result_real array where the real part of the result is saved
+ * \param result_imag array where the imaginary part of the result is saved
  * \param calculate_ifft true: calculate ifft false: calculate fft
+ * \param workspace array with LFFT_FFT_WORKSPACE(fft) elements
  */
-static void _lfft_fft(lfft_Fft * fft, const int32_t real[], bool calculate_ifft);
+static void _lfft_fft(const lfft_Fft * fft, const int32_t real[],
+        int32_t result_real[], int32_t result_imag[], bool calculate_ifft, int32_t workspace[]);
 
 /*!
  * Prepares the input data for the calculation.
@@ -67,18 +82,26 @@ static void _lfft_fft(lfft_Fft * fft, const int32_t real[], bool calculate_ifft)
  * \param fft initialized lfft_Fft struct
  * \param real real input data for fft
  * \param imag imaginary input data for fft.
+ * \param result_real array where the real part of the result is saved
+ * \param result_imag array where the imaginary part of the result is saved
  * \param calculate_ifft true: calculate ifft false: calculate fft
+ * \param workspace array with LFFT_FFT_WORKSPACE(fft) elements
  */
-static void _lfft_fft_complex(lfft_Fft * fft, const int32_t real[], const int32_t imag[], bool calculate_ifft);
+static void _lfft_fft_complex(const lfft_Fft * fft, const int32_t real[], const int32_t imag[],
+        int32_t result_real[], int32_t result_imag[], bool calculate_ifft, int32_t workspace[]);
 
 /*!
  * Prepares the input data for the calculation.
  * It uses only real input data, the imaginary part is set to 0.
  * \param fft initialized lfft_Fft struct
  * \param real real input data for fft
+ * \param result_real array where the real part of the result is saved
+ * \param result_imag array where the imaginary part of the result is saved
  * \param calculate_ifft true: calculate ifft false: calculate fft
+ * \param workspace array with LFFT_FFT_WORKSPACE(fft) elements
  */
-static void _lfft_fft_float(lfft_Fft * fft, const float real[], bool calculate_ifft);
+static void _lfft_fft_float(const lfft_Fft * fft, const float real[],
+        int32_t result_real[], int32_t result_imag[], bool calculate_ifft, int32_t workspace[]);
 
 /*!
  * Prepares the input data for the calculation.
@@ -86,365 +109,1861 @@ static void _lfft_fft_float(lfft_Fft * fft, const float real[], bool calculate_i
  * \param fft initialized lfft_Fft struct
  * \param real real input data for fft
  * \param imag imaginary input data for fft.
+ * \param result_real array where the real part of the result is saved
+ * \param result_imag array where the imaginary part of the result is saved
+ * \param calculate_ifft true: calculate ifft false: calculate fft
+ * \param workspace array with LFFT_FFT_WORKSPACE(fft) elements
+ */
+static void _lfft_fft_complex_float(const lfft_Fft * fft, const float real[], const float imag[],
+        int32_t result_real[], int32_t result_imag[], bool calculate_ifft, int32_t workspace[]);
+
+/*!
+ * Calculates the butterflies of a fft with samples elements with the
+ * algorithm chosen by fft->kernel.
+ * samples has to divide fft->samples, the wk values of fft are reused with
+ * the appropriate stride. The result is not divided by samples.
+ * \param fft initialized lfft_Fft struct containing the wk values
+ * \param samples number of samples of the calculated fft
+ * \param steps log2(samples)
+ * \param first_step number of steps which are replaced by copying the first
+ *        element of every block of 2^first_step elements, see lfft_fft_new_input();
+ *        0 for LFFT_KERNEL_RADIX_4 and LFFT_KERNEL_STOCKHAM
+ * \param real reordered real data; replaced by the real result
+ * \param imag reordered imaginary data; replaced by the imaginary result
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ * \param workspace array with LFFT_FFT_WORKSPACE(fft) elements
+ */
+static void _lfft_fft_butterflies(const lfft_Fft * fft, uint32_t samples, uint8_t steps, uint8_t first_step,
+        int32_t real[], int32_t imag[], bool calculate_ifft, int32_t workspace[]);
+
+/*!
+ * Calculates the radix-2 butterflies of a fft with samples elements.
+ * samples has to divide fft->samples, the wk values of fft are reused with
+ * the appropriate stride. The result is not divided by samples.
+ * If LFFT_USE_GENERATED is defined, the first steps are calculated by the
+ * generated codelets.
+ * \param fft initialized lfft_Fft struct containing the wk values
+ * \param samples number of samples of the calculated fft
+ * \param steps log2(samples)
+ * \param first_step first calculated step
+ * \param real reordered real data; replaced by the real result
+ * \param imag reordered imaginary data; replaced by the imaginary result
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+static void _lfft_fft_radix2(const lfft_Fft * fft, uint32_t samples, uint8_t steps, uint8_t first_step,
+        int32_t real[], int32_t imag[], bool calculate_ifft);
+
+#ifdef LFFT_USE_AVX2
+/*!
+ * Calculates the radix-2 butterflies of a fft with samples elements with
+ * AVX2 instructions. The result is bit for bit the same as the result of
+ * _lfft_fft_radix2().
+ * Steps with less than 8 butterflies per group are rearranged with
+ * permutations inside the registers, the other steps load 8 consecutive
+ * butterflies at once.
+ * samples has to divide fft->samples and must be at least 16.
+ * \param fft initialized lfft_Fft struct containing the wk values
+ * \param samples number of samples of the calculated fft
+ * \param steps log2(samples)
+ * \param first_step first calculated step
+ * \param real reordered real data; replaced by the real result
+ * \param imag reordered imaginary data; replaced by the imaginary result
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+static void _lfft_fft_radix2_avx2(const lfft_Fft * fft, uint32_t samples, uint8_t steps, uint8_t first_step,
+        int32_t real[], int32_t imag[], bool calculate_ifft);
+
+/*!
+ * Calculates 8 radix-2 butterflies with AVX2 instructions.
+ * \param real_1 real part of the first operants; replaced by the result
+ * \param imag_1 imaginary part of the first operants; replaced by the result
+ * \param real_2 real part of the second operants; replaced by the result
+ * \param imag_2 imaginary part of the second operants; replaced by the result
+ * \param wk_real real wk values of the butterflies
+ * \param wk_imag imaginary wk values of the butterflies
+ */
+static void _lfft_butterfly_avx2(__m256i * real_1, __m256i * imag_1,
+        __m256i * real_2, __m256i * imag_2, __m256i wk_real, __m256i wk_imag);
+
+/*!
+ * Calculates the decimation in frequency butterflies of fft->samples
+ * elements with AVX2 instructions. The result is bit for bit the same as the
+ * result of the portable calculation of _lfft_fft_dif().
+ * The steps are arranged like in _lfft_fft_radix2_avx2().
+ * fft->samples must be at least 16.
+ * \param fft initialized lfft_Fft struct
+ * \param real real data in natural order; replaced by the bit reversed real result
+ * \param imag imaginary data in natural order; replaced by the bit reversed imaginary result
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+static void _lfft_fft_dif_avx2(const lfft_Fft * fft, int32_t real[], int32_t imag[], bool calculate_ifft);
+
+/*!
+ * Calculates 8 decimation in frequency butterflies with AVX2 instructions.
+ * \param real_1 real part of the first operants; replaced by the result
+ * \param imag_1 imaginary part of the first operants; replaced by the result
+ * \param real_2 real part of the second operants; replaced by the result
+ * \param imag_2 imaginary part of the second operants; replaced by the result
+ * \param wk_real real wk values of the butterflies
+ * \param wk_imag imaginary wk values of the butterflies
+ */
+static void _lfft_butterfly_dif_avx2(__m256i * real_1, __m256i * imag_1,
+        __m256i * real_2, __m256i * imag_2, __m256i wk_real, __m256i wk_imag);
+#endif /* LFFT_USE_AVX2 */
+
+/*!
+ * Calculates the radix-4 butterflies of a fft with samples elements.
+ * Two radix-2 steps are merged into one pass, which needs three instead of
+ * four complex multiplications. For an odd number of steps, a radix-2 pass
+ * without multiplications is calculated first.
+ * samples has to divide fft->samples, the wk values of fft are reused with
+ * the appropriate stride. The result is not divided by samples.
+ * \param fft initialized lfft_Fft struct containing the wk values
+ * \param samples number of samples of the calculated fft
+ * \param steps log2(samples)
+ * \param real reordered real data; replaced by the real result
+ * \param imag reordered imaginary data; replaced by the imaginary result
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+static void _lfft_fft_radix4(const lfft_Fft * fft, uint32_t samples, uint8_t steps,
+        int32_t real[], int32_t imag[], bool calculate_ifft);
+
+/*!
+ * Calculates a fft with samples elements with the stockham autosort
+ * algorithm. The input is in natural order and every step writes its result
+ * sequentially into the other buffer, workspace is used as the second
+ * buffer. The result is stored in real and imag in natural order and is bit
+ * for bit the same as the result of _lfft_fft_radix2().
+ * samples has to divide fft->samples, the wk values of fft are reused with
+ * the appropriate stride. The result is not divided by samples.
+ * \param fft initialized lfft_Fft struct containing the wk values
+ * \param samples number of samples of the calculated fft
+ * \param steps log2(samples)
+ * \param real real data in natural order; replaced by the real result
+ * \param imag imaginary data in natural order; replaced by the imaginary result
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ * \param workspace array with 2*fft->samples elements
+ */
+static void _lfft_fft_stockham(const lfft_Fft * fft, uint32_t samples, uint8_t steps,
+        int32_t real[], int32_t imag[], bool calculate_ifft, int32_t workspace[]);
+
+/*!
+ * Packs real input data into a complex fft of half the size.
+ * The even samples are written reordered into result_real, the odd
+ * samples into result_imag.
+ * \param fft initialized lfft_Fft struct
+ * \param real real input data for fft
+ * \param result_real array where the real part of the result is saved
+ * \param result_imag array where the imaginary part of the result is saved
+ */
+static void _lfft_rfft_pack(const lfft_Fft * fft, const int32_t real[],
+        int32_t result_real[], int32_t result_imag[]);
+
+/*!
+ * Packs real input data into a complex fft of half the size.
+ * The even samples are written reordered into result_real, the odd
+ * samples into result_imag.
+ * \param fft initialized lfft_Fft struct
+ * \param real real input data for fft
+ * \param result_real array where the real part of the result is saved
+ * \param result_imag array where the imaginary part of the result is saved
+ */
+static void _lfft_rfft_pack_float(const lfft_Fft * fft, const float real[],
+        int32_t result_real[], int32_t result_imag[]);
+
+/*!
+ * Packs the fft->input_samples leading input samples into a complex fft of
+ * half the size, see _lfft_rfft_pack(). Only the first element of every
+ * block of 2^first_step elements is written, the other elements are zero.
+ * \param fft initialized lfft_Fft struct with fft->input_samples < fft->samples
+ * \param real real input data for fft
+ * \param result_real array where the real part of the result is saved
+ * \param result_imag array where the imaginary part of the result is saved
+ * \return first_step of the fft of half the size, see _lfft_fft_butterflies()
+ */
+static uint8_t _lfft_rfft_pack_input(const lfft_Fft * fft, const int32_t real[],
+        int32_t result_real[], int32_t result_imag[]);
+
+/*!
+ * Same as _lfft_rfft_pack_input() with float input data.
+ * \param fft initialized lfft_Fft struct with fft->input_samples < fft->samples
+ * \param real real input data for fft
+ * \param result_real array where the real part of the result is saved
+ * \param result_imag array where the imaginary part of the result is saved
+ * \return first_step of the fft of half the size, see _lfft_fft_butterflies()
+ */
+static uint8_t _lfft_rfft_pack_input_float(const lfft_Fft * fft, const float real[],
+        int32_t result_real[], int32_t result_imag[]);
+
+/*!
+ * Splits the result of the fft of half the size of packed real input data
+ * into the spectrum of the real input data, see _lfft_rfft_calculation().
+ * \param fft initialized lfft_Fft struct
+ * \param result_real real part of the result of the fft of half the size
+ * \param result_imag imaginary part of the result of the fft of half the size
+ */
+static void _lfft_rfft_combine(const lfft_Fft * fft, int32_t result_real[], int32_t result_imag[]);
+
+/*!
+ * Splits the spectrum of real data into the spectrum of the complex data of
+ * half the size whose real part are the even samples and whose imaginary part
+ * are the odd samples, the inverse of _lfft_rfft_combine().
+ * \param fft initialized lfft_Fft struct
+ * \param result_real real part of the spectrum; replaced by the real part of the split spectrum
+ * \param result_imag imaginary part of the spectrum; replaced by the imaginary part of the split spectrum
+ */
+static void _lfft_irfft_split(const lfft_Fft * fft, int32_t result_real[], int32_t result_imag[]);
+
+/*!
+ * Returns the number of steps of a fft with samples elements which only copy
+ * values if the reordered input data has input_samples leading non-zero
+ * elements. The non-zero elements are the first elements of blocks of
+ * 2^steps elements.
+ * \param samples number of samples of the fft; to the power of 2
+ * \param input_samples number of leading non-zero input samples; at least 1
+ * \return number of steps
+ */
+static uint8_t _lfft_fft_input_steps(uint32_t samples, uint32_t input_samples);
+
+/*!
+ * Completes the result of _lfft_rfft_calculation() to the full spectrum.
+ * The elements samples/2+1..samples-1 are the complex conjugates of the
+ * elements samples/2-1..1.
+ * For the ifft the whole spectrum is conjugated and divided by samples,
+ * because ifft(x) == conj(fft(x))/samples for real x.
+ * \param fft initialized lfft_Fft struct
+ * \param result_real real part of the result
+ * \param result_imag imaginary part of the result
  * \param calculate_ifft true: calculate ifft false: calculate fft
  */
-static void _lfft_fft_complex_float(lfft_Fft * fft, const float real[], const float imag[], bool calculate_ifft);
+static void _lfft_rfft_mirror(const lfft_Fft * fft, int32_t result_real[], int32_t result_imag[],
+        bool calculate_ifft);
+
+/*!
+ * Reorders the data in place by swapping the elements with the switching
+ * table or the swap table of the plan.
+ * \param fft initialized lfft_Fft struct
+ * \param real real data
+ * \param imag imaginary data
+ */
+static void _lfft_fft_reorder(const lfft_Fft * fft, int32_t real[], int32_t imag[]);
 
 /*!
  * Checks if x is to the power of 2.
  * \param x number to be checked
  * \return true if x is to the power of 2, false if not
  */
-static bool _lfft_is_power_2(uint16_t x);
+static bool _lfft_is_power_2(uint32_t x);
+
+lfft_errno lfft_fft_new(lfft_Fft * fft, uint32_t samples)
+{
+    return _lfft_fft_init(fft, samples, LFFT_KERNEL_RADIX_2);
+}
 
-lfft_errno lfft_fft_new(lfft_Fft * fft, uint16_t samples)
+lfft_errno lfft_fft_new_kernel(lfft_Fft * fft, uint32_t samples, lfft_Kernel kernel)
 {
-    return _lfft_fft_init(fft, samples);
+    return _lfft_fft_init(fft, samples, kernel);
+}
+
+lfft_errno lfft_fft_new_input(lfft_Fft * fft, uint32_t samples, uint32_t input_samples)
+{
+    lfft_errno error;
+
+    // samples is not to the power of 2
+    if(!_lfft_is_power_2(samples))
+    {
+        return 1;
+    }
+
+    if((input_samples == 0)||(input_samples > samples))
+    {
+        return 2;
+    }
+
+    error = _lfft_fft_init(fft, samples, LFFT_KERNEL_RADIX_2);
+    if(error == 0)
+    {
+        fft->input_samples = input_samples;
+    }
+
+    return error;
 }
 
 void lfft_fft_delete(lfft_Fft * fft)
 {
     // deallocate memory
-    free(fft->switching_table);
-    free(fft->wk_real);
-    free(fft->wk_imag);
+    lfft_plan_release(fft->plan);
+    free(fft->workspace);
     free(fft->result_real);
     free(fft->result_imag);
 }
 
 void lfft_fft(lfft_Fft * fft, const int32_t real[])
 {
-    _lfft_fft(fft, real, false);
+    _lfft_fft(fft, real, fft->result_real, fft->result_imag, false, fft->workspace);
 }
 
 void lfft_fft_complex(lfft_Fft * fft, const int32_t real[], const int32_t imag[])
 {
-    _lfft_fft_complex(fft, real, imag, false);
+    _lfft_fft_complex(fft, real, imag, fft->result_real, fft->result_imag, false, fft->workspace);
 }
 
 void lfft_fft_float(lfft_Fft * fft, const float real[])
 {
-    _lfft_fft_float(fft, real, false);
+    _lfft_fft_float(fft, real, fft->result_real, fft->result_imag, false, fft->workspace);
 }
 
 void lfft_fft_complex_float(lfft_Fft * fft, const float real[], const float imag[])
 {
-    _lfft_fft_complex_float(fft, real, imag, false);
+    _lfft_fft_complex_float(fft, real, imag, fft->result_real, fft->result_imag, false, fft->workspace);
+
+}
+
+void lfft_rfft(lfft_Fft * fft, const int32_t real[])
+{
+    // the packing needs an even number of samples, see _lfft_fft()
+    if(!_lfft_is_power_2(fft->samples))
+    {
+        _lfft_fft(fft, real, fft->result_real, fft->result_imag, false, fft->workspace);
+        return;
+    }
+
+    _lfft_rfft_pack(fft, real, fft->result_real, fft->result_imag);
+    _lfft_rfft_calculation(fft, fft->result_real, fft->result_imag, fft->workspace);
+}
+
+void lfft_rfft_float(lfft_Fft * fft, const float real[])
+{
+    // the packing needs an even number of samples, see _lfft_fft()
+    if(!_lfft_is_power_2(fft->samples))
+    {
+        _lfft_fft_float(fft, real, fft->result_real, fft->result_imag, false, fft->workspace);
+        return;
+    }
 
+    _lfft_rfft_pack_float(fft, real, fft->result_real, fft->result_imag);
+    _lfft_rfft_calculation(fft, fft->result_real, fft->result_imag, fft->workspace);
 }
 
 void lfft_ifft(lfft_Fft * fft, const int32_t real[])
 {
-    _lfft_fft(fft, real, true);
+    _lfft_fft(fft, real, fft->result_real, fft->result_imag, true, fft->workspace);
 }
 
 void lfft_ifft_complex(lfft_Fft * fft, const int32_t real[], const int32_t imag[])
 {
-    _lfft_fft_complex(fft, real, imag, true);
+    _lfft_fft_complex(fft, real, imag, fft->result_real, fft->result_imag, true, fft->workspace);
 }
 
 void lfft_ifft_float(lfft_Fft * fft, const float real[])
 {
-    _lfft_fft_float(fft, real, true);
+    _lfft_fft_float(fft, real, fft->result_real, fft->result_imag, true, fft->workspace);
 }
 
 void lfft_ifft_complex_float(lfft_Fft * fft, const float real[], const float imag[])
 {
-    _lfft_fft_complex_float(fft, real, imag, true);
+    _lfft_fft_complex_float(fft, real, imag, fft->result_real, fft->result_imag, true, fft->workspace);
+
+}
+
+void lfft_fft_out(const lfft_Fft * fft, const int32_t real[], int32_t result_real[], int32_t result_imag[],
+        int32_t workspace[])
+{
+    _lfft_fft(fft, real, result_real, result_imag, false, workspace);
+}
+
+void lfft_fft_complex_out(const lfft_Fft * fft, const int32_t real[], const int32_t imag[],
+        int32_t result_real[], int32_t result_imag[], int32_t workspace[])
+{
+    _lfft_fft_complex(fft, real, imag, result_real, result_imag, false, workspace);
+}
+
+void lfft_ifft_out(const lfft_Fft * fft, const int32_t real[], int32_t result_real[], int32_t result_imag[],
+        int32_t workspace[])
+{
+    _lfft_fft(fft, real, result_real, result_imag, true, workspace);
+}
+
+void lfft_ifft_complex_out(const lfft_Fft * fft, const int32_t real[], const int32_t imag[],
+        int32_t result_real[], int32_t result_imag[], int32_t workspace[])
+{
+    _lfft_fft_complex(fft, real, imag, result_real, result_imag, true, workspace);
+}
+
+void lfft_fft_inplace(const lfft_Fft * fft, int32_t real[], int32_t imag[], int32_t workspace[])
+{
+    _lfft_fft_reorder(fft, real, imag);
+    _lfft_fft_calculation_buffer(fft, real, imag, false, workspace);
+}
+
+void lfft_ifft_inplace(const lfft_Fft * fft, int32_t real[], int32_t imag[], int32_t workspace[])
+{
+    _lfft_fft_reorder(fft, real, imag);
+    _lfft_fft_calculation_buffer(fft, real, imag, true, workspace);
+}
+
+void lfft_fft_import(const int32_t data[], int32_t fixed[], uint32_t n)
+{
+    uint32_t i;
+
+    for(i = 0; i < n; i++)
+    {
+        fixed[i] = data[i]<<LFFT_RHS_BITS;
+    }
+}
+
+void lfft_fft_import_float(const float data[], int32_t fixed[], uint32_t n)
+{
+    uint32_t i;
+
+    for(i = 0; i < n; i++)
+    {
+        fixed[i] = (int32_t) (data[i]*(1<<LFFT_RHS_BITS));
+    }
+}
+
+void lfft_fft_export(const int32_t fixed[], int32_t data[], uint32_t n)
+{
+    uint32_t i;
+
+    for(i = 0; i < n; i++)
+    {
+        data[i] = fixed[i]>>LFFT_RHS_BITS;
+    }
+}
+
+void lfft_fft_export_float(const int32_t fixed[], float data[], uint32_t n)
+{
+    uint32_t i;
 
+    for(i = 0; i < n; i++)
+    {
+        data[i] = ((float) fixed[i])/(1<<LFFT_RHS_BITS);
+    }
+}
+
+void lfft_fft_result(const lfft_Fft * fft, int32_t real[], int32_t imag[])
+{
+    lfft_fft_export(fft->result_real, real, fft->samples);
+    lfft_fft_export(fft->result_imag, imag, fft->samples);
+}
+
+void lfft_fft_result_float(const lfft_Fft * fft, float real[], float imag[])
+{
+    lfft_fft_export_float(fft->result_real, real, fft->samples);
+    lfft_fft_export_float(fft->result_imag, imag, fft->samples);
 }
 
-int32_t lfft_fft_result_real_at(lfft_Fft * fft, uint16_t n)
+int32_t lfft_fft_result_real_at(const lfft_Fft * fft, uint32_t n)
 {
     return fft->result_real[n]>>LFFT_RHS_BITS;
 }
 
-int32_t lfft_fft_result_imag_at(lfft_Fft * fft, uint16_t n)
+int32_t lfft_fft_result_imag_at(const lfft_Fft * fft, uint32_t n)
 {
     return fft->result_imag[n]>>LFFT_RHS_BITS;
 }
 
-float lfft_fft_result_real_float_at(lfft_Fft * fft, uint16_t n)
+float lfft_fft_result_real_float_at(const lfft_Fft * fft, uint32_t n)
 {
     return ((float) fft->result_real[n])/(1<<LFFT_RHS_BITS);
 }
 
-float lfft_fft_result_imag_float_at(lfft_Fft * fft, uint16_t n)
+float lfft_fft_result_imag_float_at(const lfft_Fft * fft, uint32_t n)
 {
     return ((float) fft->result_imag[n])/(1<<LFFT_RHS_BITS);
 }
 
-uint16_t lfft_fft_abs_at(lfft_Fft * fft, uint16_t n)
+uint16_t lfft_fft_abs_at(const lfft_Fft * fft, uint32_t n)
 {
-    uint32_t op1 = fft->result_real[n]>>(LFFT_RHS_BITS);
-    uint32_t op2 = fft->result_imag[n]>>(LFFT_RHS_BITS);
-    op1 *= op1;
-    op2 *= op2;
-    return lfft_isqrt(op1+op2);
+    int64_t op1 = fft->result_real[n]>>(LFFT_RHS_BITS);
+    int64_t op2 = fft->result_imag[n]>>(LFFT_RHS_BITS);
+    uint32_t root = lfft_isqrt64((uint64_t) (op1*op1)+(uint64_t) (op2*op2));
+
+    return (root > 0xFFFF) ? 0xFFFF : (uint16_t) root;
 }
 
-uint16_t lfft_fft_abs_and_norm_at(lfft_Fft * fft, uint16_t n)
+uint16_t lfft_fft_abs_and_norm_at(const lfft_Fft * fft, uint32_t n)
 {
-    uint32_t op1 = fft->result_real[n]>>(fft->steps+LFFT_RHS_BITS);
-    uint32_t op2 = fft->result_imag[n]>>(fft->steps+LFFT_RHS_BITS);
-    op1 *= op1;
-    op2 *= op2;
-    return lfft_isqrt(op1+op2);
+    int64_t op1;
+    int64_t op2;
+    uint32_t root;
+
+    if(_lfft_is_power_2(fft->samples))
+    {
+        // fft->steps+LFFT_RHS_BITS can be 32 or more bits
+        op1 = (int64_t) fft->result_real[n]>>(fft->steps+LFFT_RHS_BITS);
+        op2 = (int64_t) fft->result_imag[n]>>(fft->steps+LFFT_RHS_BITS);
+    }
+    else
+    {
+        op1 = ((int64_t) fft->result_real[n]/(int64_t) fft->samples)>>LFFT_RHS_BITS;
+        op2 = ((int64_t) fft->result_imag[n]/(int64_t) fft->samples)>>LFFT_RHS_BITS;
+    }
+    root = lfft_isqrt64((uint64_t) (op1*op1)+(uint64_t) (op2*op2));
+
+    return (root > 0xFFFF) ? 0xFFFF : (uint16_t) root;
 }
 
 uint16_t lfft_isqrt(uint32_t x)
 {
-    // this function is an adapted version of an isqrt algorithm
-    // written by Wilco Dijkstra
-    uint32_t a;
-    uint32_t root = 0;
-
-#define ISQRT_ITER(N) \
-    a = root+(1<<(N)); \
-    if(x >= a<<(N)) \
-    { \
-        x -= a<<(N); \
-        root |= 2<<(N); \
-    }
-
-    ISQRT_ITER(15);
-    ISQRT_ITER(14);
-    ISQRT_ITER(13);
-    ISQRT_ITER(12);
-    ISQRT_ITER(11);
-    ISQRT_ITER(10);
-    ISQRT_ITER(9);
-    ISQRT_ITER(8);
-    ISQRT_ITER(7);
-    ISQRT_ITER(6);
-    ISQRT_ITER(5);
-    ISQRT_ITER(4);
-    ISQRT_ITER(3);
-    ISQRT_ITER(2);
-    ISQRT_ITER(1);
-    ISQRT_ITER(0);
-
-#undef ISQRT_ITER
-
-    return root>>1;
+    return (uint16_t) lfft_isqrt64(x);
 }
 
-void _lfft_fft_calculation(lfft_Fft * fft, bool calculate_ifft)
+uint32_t lfft_isqrt64(uint64_t x)
 {
-    uint16_t i;
-    uint16_t j;
-    uint16_t n_wk;
-    uint16_t butterfly_counter;
+    uint64_t root;
+    uint64_t next;
+    uint8_t half_length;
 
-    // temporary variables
-    int32_t real_1;
-    int32_t real_2;
-    int32_t imag_1;
-    int32_t imag_2;
-    int32_t wk_real;
-    int32_t wk_imag;
+    if(x == 0)
+    {
+        return 0;
+    }
 
-    uint16_t space_butterfly_operant = 1; // space between operants of butterfly graph
-    uint16_t n_wk_counter            = fft->samples/2; // counter to calculate next n_wk
+    // x = m*2^(2*half_length) with 1 <= m < 4, the first newton step from
+    // 2^half_length needs no division: (m+1)/2*2^half_length >= sqrt(x)
+    half_length = _lfft_bit_length(x)/2;
+    root = ((x>>half_length)+(1ULL<<half_length))>>1;
 
-    for(i = 0; i < fft->steps; i++)
+    // newton steps from above decrease until floor(sqrt(x)) is reached
+    for(;;)
     {
-        j = 0;
-        n_wk = 0;
-        butterfly_counter = 0;
-        while(j < fft->samples)
+        next = (root+x/root)>>1;
+        if(next >= root)
         {
-            // bitand with ones_mask to delete unwanted carry
-            n_wk = fft->ones_mask&n_wk;
+            break;
+        }
+        root = next;
+    }
 
-            real_1 = fft->result_real[j];
-            imag_1 = fft->result_imag[j];
-            imag_2 = fft->result_imag[j+space_butterfly_operant];
-            real_2 = fft->result_real[j+space_butterfly_operant];
+    return (uint32_t) root;
+}
 
-            // in both cases, fft and ifft, wk_real = fft->wk_real[n_wk]
-            // cos(x) == cos(-x)
-            wk_real = fft->wk_real[n_wk];
-            // -sin(x) == sin(-x)
-            if(calculate_ifft)
-            {
-                wk_imag = -fft->wk_imag[n_wk];
+uint8_t _lfft_bit_length(uint64_t x)
+{
+#if defined(__GNUC__)
+    return (x == 0) ? 0 : (uint8_t) (64-__builtin_clzll(x));
+#else
+    uint8_t length = 0;
 
-            }
-            else
-            {
-                wk_imag = fft->wk_imag[n_wk];
-            }
+    while(x != 0)
+    {
+        x >>= 1;
+        length++;
+    }
 
-            // first butterfly operant
-            fft->result_real[j] = real_1+
-                    ((real_2*wk_real)>>LFFT_RHS_BITS)-
-                    ((imag_2*wk_imag)>>LFFT_RHS_BITS);
+    return length;
+#endif /* __GNUC__ */
+}
 
-            fft->result_imag[j] = imag_1+
-                    ((imag_2*wk_real)>>LFFT_RHS_BITS)+
-                    ((real_2*wk_imag)>>LFFT_RHS_BITS);
+void _lfft_fft_calculation(lfft_Fft * fft, bool calculate_ifft)
+{
+    _lfft_fft_calculation_buffer(fft, fft->result_real, fft->result_imag, calculate_ifft, fft->workspace);
+}
 
-            // second butterfly operant
-            fft->result_real[j+space_butterfly_operant] = real_1-
-                    ((real_2*wk_real)>>LFFT_RHS_BITS)+
-                    ((imag_2*wk_imag)>>LFFT_RHS_BITS);
+void _lfft_fft_calculation_buffer(const lfft_Fft * fft, int32_t real[], int32_t imag[], bool calculate_ifft,
+        int32_t workspace[])
+{
+    uint32_t i;
 
-            fft->result_imag[j+space_butterfly_operant] = imag_1-
-                    ((imag_2*wk_real)>>LFFT_RHS_BITS)-
-                    ((real_2*wk_imag)>>LFFT_RHS_BITS);
+    if(fft->plan->inner != NULL)
+    {
+        _lfft_fft_bluestein(fft, real, imag, calculate_ifft, workspace);
+        return;
+    }
 
-            n_wk += n_wk_counter;
+    if(fft->plan->radix_count > 0)
+    {
+        _lfft_fft_mixed_radix(fft, real, imag, calculate_ifft);
 
-            butterfly_counter++;
-            j++;
-            if(butterfly_counter == space_butterfly_operant)
+        if(calculate_ifft)
+        {
+            // divide the results by the fft size (fft->samples)
+            for(i = 0; i < fft->samples; i++)
             {
-                butterfly_counter = 0;
-                j += space_butterfly_operant;
+                real[i] = real[i]/(int32_t) fft->samples;
+                imag[i] = imag[i]/(int32_t) fft->samples;
             }
         }
-        // n_wk_counter = n_wk_counter/2
-        n_wk_counter >>= 1;
-        // space_butterfly_operant = space_butterfly_operant*2
-        space_butterfly_operant <<= 1;
+        return;
     }
 
+    _lfft_fft_butterflies(fft, fft->samples, fft->steps, 0, real, imag, calculate_ifft, workspace);
+
     if(calculate_ifft)
     {
         // divide the results by the fft size (fft->samples)
         // x/fft->samples == x>>fft->steps
         for(i = 0; i < fft->samples; i++)
         {
-            fft->result_real[i] = fft->result_real[i]>>fft->steps;
-            fft->result_imag[i] = fft->result_imag[i]>>fft->steps;
+            real[i] = real[i]>>fft->steps;
+            imag[i] = imag[i]>>fft->steps;
         }
     }
 }
 
-static lfft_errno _lfft_fft_init(lfft_Fft * fft, uint16_t samples)
+static lfft_errno _lfft_fft_init(lfft_Fft * fft, uint32_t samples, lfft_Kernel kernel)
 {
-    uint16_t i;
-    uint16_t j;
-    uint16_t new_place;
-
-    // samples is not to the power of 2
-    if(!_lfft_is_power_2(samples))
+    if(!lfft_plan_is_supported(samples))
     {
         return 1;
     }
 
-    fft->samples = samples;
+    if((kernel != LFFT_KERNEL_RADIX_2)&&(kernel != LFFT_KERNEL_RADIX_4)&&(kernel != LFFT_KERNEL_STOCKHAM))
+    {
+        return 2;
+    }
+
+    fft->plan = lfft_plan_acquire(samples);
+    if(fft->plan == NULL)
+    {
+        return 3;
+    }
 
-    // log2(x) = log10(x)/log10(2)
-    // make a round before casting to uint8_t, otherwise there are sometimes
-    // rounding errors
-    // round(x) = floor(x+0.5)
-    fft->steps =  ((uint8_t) floor((log((float) fft->samples)/log(2.0f))+0.5f));
-    // create binary mask
-    // example: fft->samples = 8 --> fft->ones_mask = 0b11 */
-    fft->ones_mask = (fft->samples>>1)-1;
+    fft->samples         = fft->plan->samples;
+    fft->steps           = fft->plan->steps;
+    fft->ones_mask       = fft->plan->ones_mask;
+    // the kernel is only used for sizes to the power of 2
+    fft->kernel          = _lfft_is_power_2(samples) ? kernel : LFFT_KERNEL_RADIX_2;
+    fft->switching_table = fft->plan->switching_table;
+    fft->wk_real         = fft->plan->wk_real;
+    fft->wk_imag         = fft->plan->wk_imag;
+    fft->step_wk         = fft->plan->step_wk;
+    fft->workspace       = NULL;
+    fft->input_samples   = fft->samples;
 
     // allocate memory
-    fft->switching_table = (uint16_t *) calloc(fft->samples, sizeof(uint16_t));
-    fft->wk_real         = (int32_t *)  calloc(fft->samples/2, sizeof(int32_t));
-    fft->wk_imag         = (int32_t *)  calloc(fft->samples/2, sizeof(int32_t));
+    if(fft->plan->inner != NULL)
+    {
+        fft->workspace   = (int32_t *)  malloc(2*(size_t) fft->plan->inner->samples*sizeof(int32_t));
+    }
+    else if(fft->kernel == LFFT_KERNEL_STOCKHAM)
+    {
+        fft->workspace   = (int32_t *)  malloc(2*(size_t) fft->samples*sizeof(int32_t));
+    }
     fft->result_real     = (int32_t *)  calloc(fft->samples, sizeof(int32_t));
     fft->result_imag     = (int32_t *)  calloc(fft->samples, sizeof(int32_t));
 
-    // create array with ascending numbers from 0 to fft->samples-1
-    for(i = 0; i < fft->samples; i++)
+    if((fft->result_real == NULL)||(fft->result_imag == NULL)||
+            ((fft->workspace == NULL)&&((fft->plan->inner != NULL)||(fft->kernel == LFFT_KERNEL_STOCKHAM))))
     {
-        fft->switching_table[i] = i;
+        lfft_fft_delete(fft);
+        return 3;
     }
 
-    // calculate the switching table; making the content of the table bit-reverse
-    for(i = 0; i < fft->samples; i++)
+    return 0;
+}
+
+static void _lfft_fft(const lfft_Fft * fft, const int32_t real[],
+        int32_t result_real[], int32_t result_imag[], bool calculate_ifft, int32_t workspace[])
+{
+    uint32_t i;
+    uint8_t first_step;
+
+    // the real fft of half the size is only used for sizes to the power of 2
+    if(!_lfft_is_power_2(fft->samples))
     {
-        new_place = 0;
-        for(j = 0; j < fft->steps; j++)
+        for(i = 0; i < fft->samples; i++)
         {
-            new_place <<= 1;
-            new_place += fft->switching_table[i]&1;
-            fft->switching_table[i] >>= 1;
+            result_real[i] = real[fft->switching_table[i]]<<LFFT_RHS_BITS;
+            result_imag[i] = 0;
         }
-        fft->switching_table[i] = new_place;
+
+        _lfft_fft_calculation_buffer(fft, result_real, result_imag, calculate_ifft, workspace);
+        return;
     }
 
-    // calculate different wk_n
-    // the result is multiplied with 2^LFFT_RHS_BITS, to have the size some
-    // decimal place bits in the least sigificant bits of the integer values
-    // wk = e^(-j*2*pi*i/fft->samples)*(1<<LFFT_RHS_BITS)
-    for(i = 0; i < fft->samples/2; i++)
+    // only the leading input samples are read and transformed
+    if((fft->input_samples < fft->samples)&&(!calculate_ifft))
     {
-        fft->wk_real[i] = (int32_t) (cos((2.0f*M_PI*i)/fft->samples)*(1<<LFFT_RHS_BITS));
-        fft->wk_imag[i] = (int32_t) ((-sin((2.0f*M_PI*i)/fft->samples))*(1<<LFFT_RHS_BITS));
+        first_step = _lfft_rfft_pack_input(fft, real, result_real, result_imag);
+        _lfft_fft_butterflies(fft, fft->samples/2, fft->steps-1, first_step, result_real, result_imag, false, workspace);
+        _lfft_rfft_combine(fft, result_real, result_imag);
     }
-
-    return 0;
+    else
+    {
+        _lfft_rfft_pack(fft, real, result_real, result_imag);
+        _lfft_rfft_calculation(fft, result_real, result_imag, workspace);
+    }
+    _lfft_rfft_mirror(fft, result_real, result_imag, calculate_ifft);
 }
 
-static void _lfft_fft(lfft_Fft * fft, const int32_t real[], bool calculate_ifft)
+static void _lfft_fft_complex(const lfft_Fft * fft, const int32_t real[], const int32_t imag[],
+        int32_t result_real[], int32_t result_imag[], bool calculate_ifft, int32_t workspace[])
 {
-    uint16_t i;
+    uint32_t i;
+    uint32_t n;
+    uint8_t first_step;
 
-    // reorder real input data and multiply with 2^LFFT_RHS_BITS
-    for(i = 0; i < fft->samples; i++)
+    // only the leading input samples are read, they are the first elements
+    // of blocks of 2^first_step reordered elements
+    if((fft->input_samples < fft->samples)&&(!calculate_ifft))
     {
-        fft->result_real[i] = real[fft->switching_table[i]]<<LFFT_RHS_BITS;
+        first_step = _lfft_fft_input_steps(fft->samples, fft->input_samples);
+        for(i = 0; i < fft->samples; i += 1<<first_step)
+        {
+            n = fft->switching_table[i];
+            result_real[i] = (n < fft->input_samples) ? real[n]<<LFFT_RHS_BITS : 0;
+            result_imag[i] = (n < fft->input_samples) ? imag[n]<<LFFT_RHS_BITS : 0;
+        }
+
+        _lfft_fft_butterflies(fft, fft->samples, fft->steps, first_step, result_real, result_imag, false, workspace);
+        return;
     }
 
-    // imaginary part is set to 0
-    memset(fft->result_imag, 0, sizeof(fft->result_imag));
+    // the stockham kernel uses the input data in natural order
+    if(fft->kernel == LFFT_KERNEL_STOCKHAM)
+    {
+        for(i = 0; i < fft->samples; i++)
+        {
+            result_real[i] = real[i]<<LFFT_RHS_BITS;
+            result_imag[i] = imag[i]<<LFFT_RHS_BITS;
+        }
+    }
+    else
+    {
+        // reorder real and imaginary input data and multiply with 2^LFFT_RHS_BITS
+        for(i = 0; i < fft->samples; i++)
+        {
+            result_real[i] = real[fft->switching_table[i]]<<LFFT_RHS_BITS;
+            result_imag[i] = imag[fft->switching_table[i]]<<LFFT_RHS_BITS;
+        }
+    }
 
-    _lfft_fft_calculation(fft, calculate_ifft);
+    _lfft_fft_calculation_buffer(fft, result_real, result_imag, calculate_ifft, workspace);
 }
 
-static void _lfft_fft_complex(lfft_Fft * fft, const int32_t real[], const int32_t imag[], bool calculate_ifft)
+static void _lfft_fft_float(const lfft_Fft * fft, const float real[],
+        int32_t result_real[], int32_t result_imag[], bool calculate_ifft, int32_t workspace[])
 {
-    uint16_t i;
+    uint32_t i;
+    uint8_t first_step;
 
-    // reorder real and imaginary input data and multiply with 2^LFFT_RHS_BITS
-    for(i = 0; i < fft->samples; i++)
+    // see _lfft_fft()
+    if(!_lfft_is_power_2(fft->samples))
     {
-        fft->result_real[i] = real[fft->switching_table[i]]<<LFFT_RHS_BITS;
-        fft->result_imag[i] = imag[fft->switching_table[i]]<<LFFT_RHS_BITS;
+        for(i = 0; i < fft->samples; i++)
+        {
+            result_real[i] = (int32_t) (real[fft->switching_table[i]]*(1<<LFFT_RHS_BITS));
+            result_imag[i] = 0;
+        }
+
+        _lfft_fft_calculation_buffer(fft, result_real, result_imag, calculate_ifft, workspace);
+        return;
     }
 
-    _lfft_fft_calculation(fft, calculate_ifft);
+    // see _lfft_fft()
+    if((fft->input_samples < fft->samples)&&(!calculate_ifft))
+    {
+        first_step = _lfft_rfft_pack_input_float(fft, real, result_real, result_imag);
+        _lfft_fft_butterflies(fft, fft->samples/2, fft->steps-1, first_step, result_real, result_imag, false, workspace);
+        _lfft_rfft_combine(fft, result_real, result_imag);
+    }
+    else
+    {
+        _lfft_rfft_pack_float(fft, real, result_real, result_imag);
+        _lfft_rfft_calculation(fft, result_real, result_imag, workspace);
+    }
+    _lfft_rfft_mirror(fft, result_real, result_imag, calculate_ifft);
 }
 
-static void _lfft_fft_float(lfft_Fft * fft, const float real[], bool calculate_ifft)
+static void _lfft_fft_complex_float(const lfft_Fft * fft, const float real[], const float imag[],
+        int32_t result_real[], int32_t result_imag[], bool calculate_ifft, int32_t workspace[])
 {
-    uint16_t i;
+    uint32_t i;
+    uint32_t n;
+    uint8_t first_step;
 
-    // reorder real input data and multiply with 2^LFFT_RHS_BITS
-    for(i = 0; i < fft->samples; i++)
+    // see _lfft_fft_complex()
+    if((fft->input_samples < fft->samples)&&(!calculate_ifft))
     {
-        fft->result_real[i] = (int32_t) (real[fft->switching_table[i]]*(1<<LFFT_RHS_BITS));
+        first_step = _lfft_fft_input_steps(fft->samples, fft->input_samples);
+        for(i = 0; i < fft->samples; i += 1<<first_step)
+        {
+            n = fft->switching_table[i];
+            result_real[i] = (n < fft->input_samples) ? (int32_t) (real[n]*(1<<LFFT_RHS_BITS)) : 0;
+            result_imag[i] = (n < fft->input_samples) ? (int32_t) (imag[n]*(1<<LFFT_RHS_BITS)) : 0;
+        }
+
+        _lfft_fft_butterflies(fft, fft->samples, fft->steps, first_step, result_real, result_imag, false, workspace);
+        return;
     }
 
-    // imaginary part is set to 0
-    memset(fft->result_imag, 0, sizeof(fft->result_imag));
+    // the stockham kernel uses the input data in natural order
+    if(fft->kernel == LFFT_KERNEL_STOCKHAM)
+    {
+        for(i = 0; i < fft->samples; i++)
+        {
+            result_real[i] = (int32_t) (real[i]*(1<<LFFT_RHS_BITS));
+            result_imag[i] = (int32_t) (imag[i]*(1<<LFFT_RHS_BITS));
+        }
+    }
+    else
+    {
+        // reorder real and imaginary input data and multiply with 2^LFFT_RHS_BITS
+        for(i = 0; i < fft->samples; i++)
+        {
+            result_real[i] = (int32_t) (real[fft->switching_table[i]]*(1<<LFFT_RHS_BITS));
+            result_imag[i] = (int32_t) (imag[fft->switching_table[i]]*(1<<LFFT_RHS_BITS));
+        }
+    }
 
-    _lfft_fft_calculation(fft, calculate_ifft);
+    _lfft_fft_calculation_buffer(fft, result_real, result_imag, calculate_ifft, workspace);
 }
 
-static void _lfft_fft_complex_float(lfft_Fft * fft, const float real[], const float imag[], bool calculate_ifft)
+static void _lfft_rfft_pack(const lfft_Fft * fft, const int32_t real[],
+        int32_t result_real[], int32_t result_imag[])
 {
-    uint16_t i;
+    uint32_t i;
+    uint32_t n;
 
-    // reorder real and imaginary input data and multiply with 2^LFFT_RHS_BITS
-    for(i = 0; i < fft->samples; i++)
+    if(fft->samples == 1)
+    {
+        result_real[0] = real[0]<<LFFT_RHS_BITS;
+        result_imag[0] = 0;
+        return;
+    }
+
+    // the bit-reverse of 2*i with fft->steps bits is the bit-reverse of i
+    // with fft->steps-1 bits, so every second element of the switching table
+    // reorders the input data of the fft with the half size
+    for(i = 0; i < fft->samples/2; i++)
+    {
+        // the stockham kernel uses the input data in natural order
+        n = (fft->kernel == LFFT_KERNEL_STOCKHAM) ? 2*i : fft->switching_table[2*i]<<1;
+        result_real[i] = real[n]<<LFFT_RHS_BITS;
+        result_imag[i] = real[n+1]<<LFFT_RHS_BITS;
+    }
+}
+
+static void _lfft_rfft_pack_float(const lfft_Fft * fft, const float real[],
+        int32_t result_real[], int32_t result_imag[])
+{
+    uint32_t i;
+    uint32_t n;
+
+    if(fft->samples == 1)
     {
-        fft->result_real[i] = (int32_t) (real[fft->switching_table[i]]*(1<<LFFT_RHS_BITS));
-        fft->result_imag[i] = (int32_t) (imag[fft->switching_table[i]]*(1<<LFFT_RHS_BITS));
+        result_real[0] = (int32_t) (real[0]*(1<<LFFT_RHS_BITS));
+        result_imag[0] = 0;
+        return;
     }
 
-    _lfft_fft_calculation(fft, calculate_ifft);
+    // see _lfft_rfft_pack()
+    for(i = 0; i < fft->samples/2; i++)
+    {
+        n = (fft->kernel == LFFT_KERNEL_STOCKHAM) ? 2*i : fft->switching_table[2*i]<<1;
+        result_real[i] = (int32_t) (real[n]*(1<<LFFT_RHS_BITS));
+        result_imag[i] = (int32_t) (real[n+1]*(1<<LFFT_RHS_BITS));
+    }
 }
 
-static bool _lfft_is_power_2(uint16_t x)
+static uint8_t _lfft_rfft_pack_input(const lfft_Fft * fft, const int32_t real[],
+        int32_t result_real[], int32_t result_imag[])
+{
+    uint32_t i;
+    uint32_t n;
+    uint8_t first_step;
+
+    // input_samples real samples are (input_samples+1)/2 complex samples
+    first_step = _lfft_fft_input_steps(fft->samples/2, (fft->input_samples+1)/2);
+    for(i = 0; i < fft->samples/2; i += 1<<first_step)
+    {
+        n = fft->switching_table[2*i]<<1;
+        result_real[i] = (n < fft->input_samples) ? real[n]<<LFFT_RHS_BITS : 0;
+        result_imag[i] = (n+1 < fft->input_samples) ? real[n+1]<<LFFT_RHS_BITS : 0;
+    }
+
+    return first_step;
+}
+
+static uint8_t _lfft_rfft_pack_input_float(const lfft_Fft * fft, const float real[],
+        int32_t result_real[], int32_t result_imag[])
+{
+    uint32_t i;
+    uint32_t n;
+    uint8_t first_step;
+
+    // see _lfft_rfft_pack_input()
+    first_step = _lfft_fft_input_steps(fft->samples/2, (fft->input_samples+1)/2);
+    for(i = 0; i < fft->samples/2; i += 1<<first_step)
+    {
+        n = fft->switching_table[2*i]<<1;
+        result_real[i] = (n < fft->input_samples) ? (int32_t) (real[n]*(1<<LFFT_RHS_BITS)) : 0;
+        result_imag[i] = (n+1 < fft->input_samples) ? (int32_t) (real[n+1]*(1<<LFFT_RHS_BITS)) : 0;
+    }
+
+    return first_step;
+}
+
+void _lfft_rfft_calculation(const lfft_Fft * fft, int32_t result_real[], int32_t result_imag[],
+        int32_t workspace[])
+{
+    if(fft->samples == 1)
+    {
+        return;
+    }
+
+    // z[n] = x[2n]+j*x[2n+1] --> Z[k] = fft(z)[k]
+    _lfft_fft_butterflies(fft, fft->samples/2, fft->steps-1, 0, result_real, result_imag, false, workspace);
+    _lfft_rfft_combine(fft, result_real, result_imag);
+}
+
+void _lfft_irfft_calculation(const lfft_Fft * fft, int32_t result_real[], int32_t result_imag[],
+        int32_t workspace[])
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t half = fft->samples/2;
+    int32_t temp;
+
+    if(fft->samples == 1)
+    {
+        return;
+    }
+
+    _lfft_irfft_split(fft, result_real, result_imag);
+
+    // the stockham kernel uses the input data in natural order, the others
+    // reorder with every second element of the switching table, see
+    // _lfft_rfft_pack()
+    if(fft->kernel != LFFT_KERNEL_STOCKHAM)
+    {
+        for(i = 0; i < half; i++)
+        {
+            j = fft->switching_table[2*i];
+            if(i < j)
+            {
+                temp = result_real[i];
+                result_real[i] = result_real[j];
+                result_real[j] = temp;
+
+                temp = result_imag[i];
+                result_imag[i] = result_imag[j];
+                result_imag[j] = temp;
+            }
+        }
+    }
+
+    // z = ifft(Z) --> x[2n] = Re(z[n]), x[2n+1] = Im(z[n])
+    // x/half == x>>(fft->steps-1)
+    _lfft_fft_butterflies(fft, half, fft->steps-1, 0, result_real, result_imag, true, workspace);
+
+    // interleave backwards, x[2n] and x[2n+1] are behind the unread z[0..n-1]
+    for(i = half; i > 0; i--)
+    {
+        temp = result_imag[i-1]>>(fft->steps-1);
+        result_real[2*(i-1)] = result_real[i-1]>>(fft->steps-1);
+        result_real[2*(i-1)+1] = temp;
+    }
+}
+
+void _lfft_fft_dit(const lfft_Fft * fft, int32_t real[], int32_t imag[], bool calculate_ifft)
+{
+    _lfft_fft_butterflies(fft, fft->samples, fft->steps, 0, real, imag, calculate_ifft, NULL);
+}
+
+void _lfft_fft_dif(const lfft_Fft * fft, int32_t real[], int32_t imag[], bool calculate_ifft)
+{
+    uint32_t j;
+    uint32_t k;
+
+    // temporary variables
+    int32_t real_1;
+    int32_t real_2;
+    int32_t imag_1;
+    int32_t imag_2;
+    int32_t wk_real;
+    int32_t wk_imag;
+
+    uint32_t space_butterfly_operant; // space between operants of butterfly graph
+    const int32_t * wk; // contiguous wk values of the step, see LFFT_STEP_WK()
+
+#ifdef LFFT_USE_AVX2
+    if(fft->samples >= 16)
+    {
+        _lfft_fft_dif_avx2(fft, real, imag, calculate_ifft);
+        return;
+    }
+#endif /* LFFT_USE_AVX2 */
+
+    // the steps of _lfft_fft_radix2() in reverse order, the twiddle factor
+    // is applied after the subtraction:
+    //   a' = a+b   b' = (a-b)*wk
+    for(space_butterfly_operant = fft->samples/2; space_butterfly_operant > 0; space_butterfly_operant >>= 1)
+    {
+        wk = &fft->step_wk[LFFT_STEP_WK(space_butterfly_operant)];
+        for(j = 0; j < fft->samples; j += 2*space_butterfly_operant)
+        {
+            for(k = 0; k < space_butterfly_operant; k++)
+            {
+                real_1 = real[j+k];
+                imag_1 = imag[j+k];
+                real_2 = real[j+k+space_butterfly_operant];
+                imag_2 = imag[j+k+space_butterfly_operant];
+
+                wk_real = wk[2*k];
+                wk_imag = calculate_ifft ? -wk[2*k+1] : wk[2*k+1];
+
+                // first butterfly operant
+                real[j+k] = real_1+real_2;
+                imag[j+k] = imag_1+imag_2;
+
+                // second butterfly operant
+                real_1 -= real_2;
+                imag_1 -= imag_2;
+                real[j+k+space_butterfly_operant] = ((real_1*wk_real)>>LFFT_RHS_BITS)-
+                        ((imag_1*wk_imag)>>LFFT_RHS_BITS);
+                imag[j+k+space_butterfly_operant] = ((imag_1*wk_real)>>LFFT_RHS_BITS)+
+                        ((real_1*wk_imag)>>LFFT_RHS_BITS);
+            }
+        }
+    }
+}
+
+static void _lfft_rfft_combine(const lfft_Fft * fft, int32_t result_real[], int32_t result_imag[])
+{
+    uint32_t k;
+    uint32_t half = fft->samples/2;
+
+    // temporary variables
+    int32_t real_1;
+    int32_t real_2;
+    int32_t imag_1;
+    int32_t imag_2;
+    int32_t even_real;
+    int32_t even_imag;
+    int32_t odd_real;
+    int32_t odd_imag;
+    int32_t t_real;
+    int32_t t_imag;
+
+    // X[0] = Re(Z[0])+Im(Z[0])
+    // X[half] = Re(Z[0])-Im(Z[0])
+    real_1 = result_real[0];
+    imag_1 = result_imag[0];
+    result_real[0] = real_1+imag_1;
+    result_imag[0] = 0;
+    result_real[half] = real_1-imag_1;
+    result_imag[half] = 0;
+
+    // split Z into the spectra of the even and odd samples
+    //   E[k] = (Z[k]+conj(Z[half-k]))/2
+    //   O[k] = (Z[k]-conj(Z[half-k]))/(2j)
+    // and combine them
+    //   X[k]      = E[k]+wk*O[k]
+    //   X[half-k] = conj(E[k]-wk*O[k])
+    for(k = 1; k <= half/2; k++)
+    {
+        real_1 = result_real[k];
+        imag_1 = result_imag[k];
+        real_2 = result_real[half-k];
+        imag_2 = result_imag[half-k];
+
+        even_real = (real_1+real_2)>>1;
+        even_imag = (imag_1-imag_2)>>1;
+        odd_real  = (imag_1+imag_2)>>1;
+        odd_imag  = (real_2-real_1)>>1;
+
+        t_real = ((odd_real*fft->wk_real[k])>>LFFT_RHS_BITS)-
+                ((odd_imag*fft->wk_imag[k])>>LFFT_RHS_BITS);
+        t_imag = ((odd_imag*fft->wk_real[k])>>LFFT_RHS_BITS)+
+                ((odd_real*fft->wk_imag[k])>>LFFT_RHS_BITS);
+
+        result_real[k] = even_real+t_real;
+        result_imag[k] = even_imag+t_imag;
+        result_real[half-k] = even_real-t_real;
+        result_imag[half-k] = t_imag-even_imag;
+    }
+}
+
+static void _lfft_irfft_split(const lfft_Fft * fft, int32_t result_real[], int32_t result_imag[])
+{
+    uint32_t k;
+    uint32_t half = fft->samples/2;
+
+    // temporary variables
+    int32_t real_1;
+    int32_t real_2;
+    int32_t imag_1;
+    int32_t imag_2;
+    int32_t even_real;
+    int32_t even_imag;
+    int32_t difference_real;
+    int32_t difference_imag;
+    int32_t odd_real;
+    int32_t odd_imag;
+
+    // Z[0] = (X[0]+X[half])/2 + j*(X[0]-X[half])/2
+    real_1 = result_real[0];
+    real_2 = result_real[half];
+    result_real[0] = (real_1+real_2)>>1;
+    result_imag[0] = (real_1-real_2)>>1;
+
+    // split X into the spectra of the even and odd samples
+    //   E[k] = (X[k]+conj(X[half-k]))/2
+    //   O[k] = (X[k]-conj(X[half-k]))/2*conj(wk)
+    // and combine them, E[half-k] = conj(E[k]), O[half-k] = conj(O[k])
+    //   Z[k]      = E[k]+j*O[k]
+    //   Z[half-k] = conj(E[k])+j*conj(O[k])
+    for(k = 1; k <= half/2; k++)
+    {
+        real_1 = result_real[k];
+        imag_1 = result_imag[k];
+        real_2 = result_real[half-k];
+        imag_2 = result_imag[half-k];
+
+        even_real = (real_1+real_2)>>1;
+        even_imag = (imag_1-imag_2)>>1;
+        difference_real = (real_1-real_2)>>1;
+        difference_imag = (imag_1+imag_2)>>1;
+
+        odd_real = ((difference_real*fft->wk_real[k])>>LFFT_RHS_BITS)+
+                ((difference_imag*fft->wk_imag[k])>>LFFT_RHS_BITS);
+        odd_imag = ((difference_imag*fft->wk_real[k])>>LFFT_RHS_BITS)-
+                ((difference_real*fft->wk_imag[k])>>LFFT_RHS_BITS);
+
+        result_real[k] = even_real-odd_imag;
+        result_imag[k] = even_imag+odd_real;
+        result_real[half-k] = even_real+odd_imag;
+        result_imag[half-k] = odd_real-even_imag;
+    }
+}
+
+static void _lfft_rfft_mirror(const lfft_Fft * fft, int32_t result_real[], int32_t result_imag[],
+        bool calculate_ifft)
+{
+    uint32_t i;
+
+    for(i = fft->samples/2+1; i < fft->samples; i++)
+    {
+        result_real[i] = result_real[fft->samples-i];
+        result_imag[i] = -result_imag[fft->samples-i];
+    }
+
+    if(calculate_ifft)
+    {
+        // ifft(x) = conj(fft(x))/fft->samples
+        // x/fft->samples == x>>fft->steps
+        for(i = 0; i < fft->samples; i++)
+        {
+            result_real[i] = result_real[i]>>fft->steps;
+            result_imag[i] = (-result_imag[i])>>fft->steps;
+        }
+    }
+}
+
+static void _lfft_fft_reorder(const lfft_Fft * fft, int32_t real[], int32_t imag[])
+{
+    uint32_t i;
+    uint32_t j;
+    int32_t temp;
+
+    // the stockham kernel doesn't need reordered data
+    if(fft->kernel == LFFT_KERNEL_STOCKHAM)
+    {
+        return;
+    }
+
+    // the cycles of a mixed radix switching table are longer than 2
+    if(fft->plan->swap_table != NULL)
+    {
+        for(i = 0; i < fft->plan->swap_count; i++)
+        {
+            j = fft->plan->swap_table[2*i];
+
+            temp = real[j];
+            real[j] = real[fft->plan->swap_table[2*i+1]];
+            real[fft->plan->swap_table[2*i+1]] = temp;
+
+            temp = imag[j];
+            imag[j] = imag[fft->plan->swap_table[2*i+1]];
+            imag[fft->plan->swap_table[2*i+1]] = temp;
+        }
+        return;
+    }
+
+    // the switching table is a permutation of pairs, every pair is swapped once
+    for(i = 0; i < fft->samples; i++)
+    {
+        j = fft->switching_table[i];
+        if(i < j)
+        {
+            temp = real[i];
+            real[i] = real[j];
+            real[j] = temp;
+
+            temp = imag[i];
+            imag[i] = imag[j];
+            imag[j] = temp;
+        }
+    }
+}
+
+static bool _lfft_is_power_2(uint32_t x)
 {
     return x&&(!(x&(x-1)));
 }
+
+static uint8_t _lfft_fft_input_steps(uint32_t samples, uint32_t input_samples)
+{
+    uint8_t steps = 0;
+
+    // the bit-reverse of n < samples>>steps is a multiple of 2^steps
+    while((samples>>(steps+1)) >= input_samples)
+    {
+        steps++;
+    }
+
+    return steps;
+}
+
+static void _lfft_fft_butterflies(const lfft_Fft * fft, uint32_t samples, uint8_t steps, uint8_t first_step,
+        int32_t real[], int32_t imag[], bool calculate_ifft, int32_t workspace[])
+{
+    uint32_t i;
+    uint32_t j;
+
+    // a block of 2^first_step elements with a single non-zero first element
+    // is the fft of the element in every position; the butterflies with a
+    // zero operant only copy the other operant, so the result is the same
+    if(first_step > 0)
+    {
+        for(i = 0; i < samples; i += 1<<first_step)
+        {
+            for(j = 1; j < (1UL<<first_step); j++)
+            {
+                real[i+j] = real[i];
+                imag[i+j] = imag[i];
+            }
+        }
+    }
+
+    if(fft->kernel == LFFT_KERNEL_RADIX_4)
+    {
+        _lfft_fft_radix4(fft, samples, steps, real, imag, calculate_ifft);
+    }
+    else if(fft->kernel == LFFT_KERNEL_STOCKHAM)
+    {
+        _lfft_fft_stockham(fft, samples, steps, real, imag, calculate_ifft, workspace);
+    }
+    else
+    {
+#ifdef LFFT_USE_AVX2
+        if(samples >= 16)
+        {
+            _lfft_fft_radix2_avx2(fft, samples, steps, first_step, real, imag, calculate_ifft);
+            return;
+        }
+#endif /* LFFT_USE_AVX2 */
+        _lfft_fft_radix2(fft, samples, steps, first_step, real, imag, calculate_ifft);
+    }
+}
+
+static void _lfft_fft_radix2(const lfft_Fft * fft, uint32_t samples, uint8_t steps, uint8_t first_step,
+        int32_t real[], int32_t imag[], bool calculate_ifft)
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t butterfly_counter;
+
+    // temporary variables
+    int32_t real_1;
+    int32_t real_2;
+    int32_t imag_1;
+    int32_t imag_2;
+    int32_t wk_real;
+    int32_t wk_imag;
+
+    uint32_t space_butterfly_operant = 1UL<<first_step; // space between operants of butterfly graph
+    const int32_t * wk; // contiguous wk values of the step, see LFFT_STEP_WK()
+
+    i = first_step;
+#ifdef LFFT_USE_GENERATED
+    // the first steps are the independent ffts of blocks with
+    // LFFT_CODELET_MAX reordered elements, they are calculated by the
+    // generated codelets
+    if(first_step == 0)
+    {
+        space_butterfly_operant = (samples < LFFT_CODELET_MAX) ? samples : LFFT_CODELET_MAX;
+        for(j = 0; j < samples; j += space_butterfly_operant)
+        {
+            _lfft_codelet(space_butterfly_operant, &real[j], &imag[j], calculate_ifft);
+        }
+        while((1UL<<i) < space_butterfly_operant)
+        {
+            i++;
+        }
+    }
+#endif /* LFFT_USE_GENERATED */
+
+    for(; i < steps; i++)
+    {
+        j = 0;
+        butterfly_counter = 0;
+        wk = &fft->step_wk[LFFT_STEP_WK(space_butterfly_operant)];
+        while(j < samples)
+        {
+            real_1 = real[j];
+            imag_1 = imag[j];
+            imag_2 = imag[j+space_butterfly_operant];
+            real_2 = real[j+space_butterfly_operant];
+
+            // in both cases, fft and ifft, wk_real = wk[2*butterfly_counter]
+            // cos(x) == cos(-x)
+            wk_real = wk[2*butterfly_counter];
+            // -sin(x) == sin(-x)
+            if(calculate_ifft)
+            {
+                wk_imag = -wk[2*butterfly_counter+1];
+
+            }
+            else
+            {
+                wk_imag = wk[2*butterfly_counter+1];
+            }
+
+            // first butterfly operant
+            real[j] = real_1+
+                    ((real_2*wk_real)>>LFFT_RHS_BITS)-
+                    ((imag_2*wk_imag)>>LFFT_RHS_BITS);
+
+            imag[j] = imag_1+
+                    ((imag_2*wk_real)>>LFFT_RHS_BITS)+
+                    ((real_2*wk_imag)>>LFFT_RHS_BITS);
+
+            // second butterfly operant
+            real[j+space_butterfly_operant] = real_1-
+                    ((real_2*wk_real)>>LFFT_RHS_BITS)+
+                    ((imag_2*wk_imag)>>LFFT_RHS_BITS);
+
+            imag[j+space_butterfly_operant] = imag_1-
+                    ((imag_2*wk_real)>>LFFT_RHS_BITS)-
+                    ((real_2*wk_imag)>>LFFT_RHS_BITS);
+
+            butterfly_counter++;
+            j++;
+            if(butterfly_counter == space_butterfly_operant)
+            {
+                butterfly_counter = 0;
+                j += space_butterfly_operant;
+            }
+        }
+        // space_butterfly_operant = space_butterfly_operant*2
+        space_butterfly_operant <<= 1;
+    }
+}
+
+#ifdef LFFT_USE_AVX2
+static void _lfft_fft_radix2_avx2(const lfft_Fft * fft, uint32_t samples, uint8_t steps, uint8_t first_step,
+        int32_t real[], int32_t imag[], bool calculate_ifft)
+{
+    // permutations to move the first operants of a vector with 8 elements
+    // into the lower and the second operants into the upper half for
+    // space_butterfly_operant = 1, 2, 4 and the inverse permutations
+    static const int32_t permutation[3][8] = {
+        {0, 2, 4, 6, 1, 3, 5, 7},
+        {0, 1, 4, 5, 2, 3, 6, 7},
+        {0, 1, 2, 3, 4, 5, 6, 7}};
+    static const int32_t permutation_inverse[3][8] = {
+        {0, 4, 1, 5, 2, 6, 3, 7},
+        {0, 1, 4, 5, 2, 3, 6, 7},
+        {0, 1, 2, 3, 4, 5, 6, 7}};
+
+    uint32_t i;
+    uint32_t j;
+    uint32_t b;
+    int32_t n_wk[8];
+
+    __m256i perm;
+    __m256i perm_inv;
+    __m256i wk_real;
+    __m256i wk_imag;
+    __m256i real_1;
+    __m256i imag_1;
+    __m256i real_2;
+    __m256i imag_2;
+    __m256i real_lo;
+    __m256i imag_lo;
+    __m256i real_hi;
+    __m256i imag_hi;
+
+    uint32_t space_butterfly_operant = 1UL<<first_step; // space between operants of butterfly graph
+    uint32_t n_wk_counter            = (fft->samples/2)>>first_step; // counter to calculate next n_wk
+
+    for(i = first_step; i < steps; i++)
+    {
+        if(space_butterfly_operant < 8)
+        {
+            // every vector of 8 elements contains 4 butterflies, the wk
+            // values of the lanes are the same for all vectors
+            for(j = 0; j < 8; j++)
+            {
+                b = (j&3)&(space_butterfly_operant-1);
+                n_wk[j] = b*n_wk_counter;
+            }
+            wk_real = _mm256_i32gather_epi32(fft->wk_real, _mm256_loadu_si256((__m256i *) n_wk), 4);
+            wk_imag = _mm256_i32gather_epi32(fft->wk_imag, _mm256_loadu_si256((__m256i *) n_wk), 4);
+            if(calculate_ifft)
+            {
+                // -sin(x) == sin(-x)
+                wk_imag = _mm256_sub_epi32(_mm256_setzero_si256(), wk_imag);
+            }
+            perm     = _mm256_loadu_si256((__m256i *) permutation[i]);
+            perm_inv = _mm256_loadu_si256((__m256i *) permutation_inverse[i]);
+
+            for(j = 0; j < samples; j += 16)
+            {
+                // sort the operants of two vectors
+                real_lo = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((__m256i *) &real[j]), perm);
+                imag_lo = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((__m256i *) &imag[j]), perm);
+                real_hi = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((__m256i *) &real[j+8]), perm);
+                imag_hi = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((__m256i *) &imag[j+8]), perm);
+                real_1 = _mm256_permute2x128_si256(real_lo, real_hi, 0x20);
+                imag_1 = _mm256_permute2x128_si256(imag_lo, imag_hi, 0x20);
+                real_2 = _mm256_permute2x128_si256(real_lo, real_hi, 0x31);
+                imag_2 = _mm256_permute2x128_si256(imag_lo, imag_hi, 0x31);
+
+                _lfft_butterfly_avx2(&real_1, &imag_1, &real_2, &imag_2, wk_real, wk_imag);
+
+                // restore the order of the elements
+                real_lo = _mm256_permute2x128_si256(real_1, real_2, 0x20);
+                imag_lo = _mm256_permute2x128_si256(imag_1, imag_2, 0x20);
+                real_hi = _mm256_permute2x128_si256(real_1, real_2, 0x31);
+                imag_hi = _mm256_permute2x128_si256(imag_1, imag_2, 0x31);
+                _mm256_storeu_si256((__m256i *) &real[j],   _mm256_permutevar8x32_epi32(real_lo, perm_inv));
+                _mm256_storeu_si256((__m256i *) &imag[j],   _mm256_permutevar8x32_epi32(imag_lo, perm_inv));
+                _mm256_storeu_si256((__m256i *) &real[j+8], _mm256_permutevar8x32_epi32(real_hi, perm_inv));
+                _mm256_storeu_si256((__m256i *) &imag[j+8], _mm256_permutevar8x32_epi32(imag_hi, perm_inv));
+            }
+        }
+        else
+        {
+            // 8 consecutive butterflies of a group are calculated at once,
+            // the wk values are loaded once for all groups
+            for(b = 0; b < space_butterfly_operant; b += 8)
+            {
+                for(j = 0; j < 8; j++)
+                {
+                    n_wk[j] = (b+j)*n_wk_counter;
+                }
+                wk_real = _mm256_i32gather_epi32(fft->wk_real, _mm256_loadu_si256((__m256i *) n_wk), 4);
+                wk_imag = _mm256_i32gather_epi32(fft->wk_imag, _mm256_loadu_si256((__m256i *) n_wk), 4);
+                if(calculate_ifft)
+                {
+                    // -sin(x) == sin(-x)
+                    wk_imag = _mm256_sub_epi32(_mm256_setzero_si256(), wk_imag);
+                }
+
+                for(j = b; j < samples; j += space_butterfly_operant<<1)
+                {
+                    real_1 = _mm256_loadu_si256((__m256i *) &real[j]);
+                    imag_1 = _mm256_loadu_si256((__m256i *) &imag[j]);
+                    real_2 = _mm256_loadu_si256((__m256i *) &real[j+space_butterfly_operant]);
+                    imag_2 = _mm256_loadu_si256((__m256i *) &imag[j+space_butterfly_operant]);
+
+                    _lfft_butterfly_avx2(&real_1, &imag_1, &real_2, &imag_2, wk_real, wk_imag);
+
+                    _mm256_storeu_si256((__m256i *) &real[j], real_1);
+                    _mm256_storeu_si256((__m256i *) &imag[j], imag_1);
+                    _mm256_storeu_si256((__m256i *) &real[j+space_butterfly_operant], real_2);
+                    _mm256_storeu_si256((__m256i *) &imag[j+space_butterfly_operant], imag_2);
+                }
+            }
+        }
+        // n_wk_counter = n_wk_counter/2
+        n_wk_counter >>= 1;
+        // space_butterfly_operant = space_butterfly_operant*2
+        space_butterfly_operant <<= 1;
+    }
+}
+
+static void _lfft_butterfly_avx2(__m256i * real_1, __m256i * imag_1,
+        __m256i * real_2, __m256i * imag_2, __m256i wk_real, __m256i wk_imag)
+{
+    __m256i t_real;
+    __m256i t_imag;
+
+    // the same operations as in _lfft_fft_radix2()
+    // t = operant_2*wk, every product is shifted by LFFT_RHS_BITS
+    t_real = _mm256_sub_epi32(
+            _mm256_srai_epi32(_mm256_mullo_epi32(*real_2, wk_real), LFFT_RHS_BITS),
+            _mm256_srai_epi32(_mm256_mullo_epi32(*imag_2, wk_imag), LFFT_RHS_BITS));
+    t_imag = _mm256_add_epi32(
+            _mm256_srai_epi32(_mm256_mullo_epi32(*imag_2, wk_real), LFFT_RHS_BITS),
+            _mm256_srai_epi32(_mm256_mullo_epi32(*real_2, wk_imag), LFFT_RHS_BITS));
+
+    *real_2 = _mm256_sub_epi32(*real_1, t_real);
+    *imag_2 = _mm256_sub_epi32(*imag_1, t_imag);
+    *real_1 = _mm256_add_epi32(*real_1, t_real);
+    *imag_1 = _mm256_add_epi32(*imag_1, t_imag);
+}
+
+static void _lfft_fft_dif_avx2(const lfft_Fft * fft, int32_t real[], int32_t imag[], bool calculate_ifft)
+{
+    // the same permutations as in _lfft_fft_radix2_avx2()
+    static const int32_t permutation[3][8] = {
+        {0, 2, 4, 6, 1, 3, 5, 7},
+        {0, 1, 4, 5, 2, 3, 6, 7},
+        {0, 1, 2, 3, 4, 5, 6, 7}};
+    static const int32_t permutation_inverse[3][8] = {
+        {0, 4, 1, 5, 2, 6, 3, 7},
+        {0, 1, 4, 5, 2, 3, 6, 7},
+        {0, 1, 2, 3, 4, 5, 6, 7}};
+
+    int8_t i;
+    uint32_t j;
+    uint32_t b;
+    int32_t n_wk[8];
+
+    __m256i perm;
+    __m256i perm_inv;
+    __m256i wk_real;
+    __m256i wk_imag;
+    __m256i real_1;
+    __m256i imag_1;
+    __m256i real_2;
+    __m256i imag_2;
+    __m256i real_lo;
+    __m256i imag_lo;
+    __m256i real_hi;
+    __m256i imag_hi;
+
+    uint32_t space_butterfly_operant = fft->samples/2; // space between operants of butterfly graph
+    uint32_t n_wk_counter            = 1; // counter to calculate next n_wk
+
+    // the steps of _lfft_fft_radix2_avx2() in reverse order
+    for(i = fft->steps-1; i >= 0; i--)
+    {
+        if(space_butterfly_operant < 8)
+        {
+            for(j = 0; j < 8; j++)
+            {
+                b = (j&3)&(space_butterfly_operant-1);
+                n_wk[j] = b*n_wk_counter;
+            }
+            wk_real = _mm256_i32gather_epi32(fft->wk_real, _mm256_loadu_si256((__m256i *) n_wk), 4);
+            wk_imag = _mm256_i32gather_epi32(fft->wk_imag, _mm256_loadu_si256((__m256i *) n_wk), 4);
+            if(calculate_ifft)
+            {
+                // -sin(x) == sin(-x)
+                wk_imag = _mm256_sub_epi32(_mm256_setzero_si256(), wk_imag);
+            }
+            perm     = _mm256_loadu_si256((__m256i *) permutation[i]);
+            perm_inv = _mm256_loadu_si256((__m256i *) permutation_inverse[i]);
+
+            for(j = 0; j < fft->samples; j += 16)
+            {
+                // sort the operants of two vectors
+                real_lo = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((__m256i *) &real[j]), perm);
+                imag_lo = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((__m256i *) &imag[j]), perm);
+                real_hi = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((__m256i *) &real[j+8]), perm);
+                imag_hi = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((__m256i *) &imag[j+8]), perm);
+                real_1 = _mm256_permute2x128_si256(real_lo, real_hi, 0x20);
+                imag_1 = _mm256_permute2x128_si256(imag_lo, imag_hi, 0x20);
+                real_2 = _mm256_permute2x128_si256(real_lo, real_hi, 0x31);
+                imag_2 = _mm256_permute2x128_si256(imag_lo, imag_hi, 0x31);
+
+                _lfft_butterfly_dif_avx2(&real_1, &imag_1, &real_2, &imag_2, wk_real, wk_imag);
+
+                // restore the order of the elements
+                real_lo = _mm256_permute2x128_si256(real_1, real_2, 0x20);
+                imag_lo = _mm256_permute2x128_si256(imag_1, imag_2, 0x20);
+                real_hi = _mm256_permute2x128_si256(real_1, real_2, 0x31);
+                imag_hi = _mm256_permute2x128_si256(imag_1, imag_2, 0x31);
+                _mm256_storeu_si256((__m256i *) &real[j],   _mm256_permutevar8x32_epi32(real_lo, perm_inv));
+                _mm256_storeu_si256((__m256i *) &imag[j],   _mm256_permutevar8x32_epi32(imag_lo, perm_inv));
+                _mm256_storeu_si256((__m256i *) &real[j+8], _mm256_permutevar8x32_epi32(real_hi, perm_inv));
+                _mm256_storeu_si256((__m256i *) &imag[j+8], _mm256_permutevar8x32_epi32(imag_hi, perm_inv));
+            }
+        }
+        else
+        {
+            for(b = 0; b < space_butterfly_operant; b += 8)
+            {
+                for(j = 0; j < 8; j++)
+                {
+                    n_wk[j] = (b+j)*n_wk_counter;
+                }
+                wk_real = _mm256_i32gather_epi32(fft->wk_real, _mm256_loadu_si256((__m256i *) n_wk), 4);
+                wk_imag = _mm256_i32gather_epi32(fft->wk_imag, _mm256_loadu_si256((__m256i *) n_wk), 4);
+                if(calculate_ifft)
+                {
+                    // -sin(x) == sin(-x)
+                    wk_imag = _mm256_sub_epi32(_mm256_setzero_si256(), wk_imag);
+                }
+
+                for(j = b; j < fft->samples; j += space_butterfly_operant<<1)
+                {
+                    real_1 = _mm256_loadu_si256((__m256i *) &real[j]);
+                    imag_1 = _mm256_loadu_si256((__m256i *) &imag[j]);
+                    real_2 = _mm256_loadu_si256((__m256i *) &real[j+space_butterfly_operant]);
+                    imag_2 = _mm256_loadu_si256((__m256i *) &imag[j+space_butterfly_operant]);
+
+                    _lfft_butterfly_dif_avx2(&real_1, &imag_1, &real_2, &imag_2, wk_real, wk_imag);
+
+                    _mm256_storeu_si256((__m256i *) &real[j], real_1);
+                    _mm256_storeu_si256((__m256i *) &imag[j], imag_1);
+                    _mm256_storeu_si256((__m256i *) &real[j+space_butterfly_operant], real_2);
+                    _mm256_storeu_si256((__m256i *) &imag[j+space_butterfly_operant], imag_2);
+                }
+            }
+        }
+        // n_wk_counter = n_wk_counter*2
+        n_wk_counter <<= 1;
+        // space_butterfly_operant = space_butterfly_operant/2
+        space_butterfly_operant >>= 1;
+    }
+}
+
+static void _lfft_butterfly_dif_avx2(__m256i * real_1, __m256i * imag_1,
+        __m256i * real_2, __m256i * imag_2, __m256i wk_real, __m256i wk_imag)
+{
+    __m256i d_real;
+    __m256i d_imag;
+
+    // the same operations as in _lfft_fft_dif()
+    // d = operant_1-operant_2, every product with wk is shifted by LFFT_RHS_BITS
+    d_real  = _mm256_sub_epi32(*real_1, *real_2);
+    d_imag  = _mm256_sub_epi32(*imag_1, *imag_2);
+    *real_1 = _mm256_add_epi32(*real_1, *real_2);
+    *imag_1 = _mm256_add_epi32(*imag_1, *imag_2);
+
+    *real_2 = _mm256_sub_epi32(
+            _mm256_srai_epi32(_mm256_mullo_epi32(d_real, wk_real), LFFT_RHS_BITS),
+            _mm256_srai_epi32(_mm256_mullo_epi32(d_imag, wk_imag), LFFT_RHS_BITS));
+    *imag_2 = _mm256_add_epi32(
+            _mm256_srai_epi32(_mm256_mullo_epi32(d_imag, wk_real), LFFT_RHS_BITS),
+            _mm256_srai_epi32(_mm256_mullo_epi32(d_real, wk_imag), LFFT_RHS_BITS));
+}
+#endif /* LFFT_USE_AVX2 */
+
+static void _lfft_fft_radix4(const lfft_Fft * fft, uint32_t samples, uint8_t steps,
+        int32_t real[], int32_t imag[], bool calculate_ifft)
+{
+    uint32_t j;
+    uint32_t b;
+    uint32_t n_wk;
+    uint32_t n_wk_counter;
+    uint8_t  r;
+
+    // temporary variables
+    int32_t real_1;
+    int32_t imag_1;
+    int32_t t_real[4];
+    int32_t t_imag[4];
+    int32_t wk_real[4];
+    int32_t wk_imag[4];
+    int32_t sum_real;
+    int32_t sum_imag;
+    int32_t diff_real;
+    int32_t diff_imag;
+
+    uint32_t space_butterfly_operant = 1; // space between operants of butterfly graph
+
+    // odd number of steps: the first radix-2 step uses wk = 1 for every
+    // butterfly, so no multiplications are necessary
+    if(steps&1)
+    {
+        for(j = 0; j < samples; j += 2)
+        {
+            real_1 = real[j];
+            imag_1 = imag[j];
+            real[j]   = real_1+real[j+1];
+            imag[j]   = imag_1+imag[j+1];
+            real[j+1] = real_1-real[j+1];
+            imag[j+1] = imag_1-imag[j+1];
+        }
+        space_butterfly_operant = 2;
+    }
+
+    // a radix-4 butterfly of size 4*space_butterfly_operant merges the four
+    // reordered ffts of size space_butterfly_operant at
+    //   j, j+space, j+2*space, j+3*space
+    // which are the ffts of the input elements 4m, 4m+2, 4m+1 and 4m+3
+    // the b-th element of the r-th of those ffts is multiplied with
+    //   wk = e^(-j*2*pi*r*b/(4*space))
+    while(space_butterfly_operant < samples)
+    {
+        // wk values of fft->samples are used, step between them for r = 1
+        n_wk_counter = fft->samples/(space_butterfly_operant<<2);
+
+        for(b = 0; b < space_butterfly_operant; b++)
+        {
+            // calculate the wk values once for all butterflies with the same b
+            // the wk table only contains the first half of the circle,
+            // e^(-j*(x+pi)) == -e^(-j*x)
+            for(r = 1; r < 4; r++)
+            {
+                n_wk = r*b*n_wk_counter;
+                if(n_wk > fft->ones_mask)
+                {
+                    n_wk = n_wk&fft->ones_mask;
+                    wk_real[r] = -fft->wk_real[n_wk];
+                    wk_imag[r] = -fft->wk_imag[n_wk];
+                }
+                else
+                {
+                    wk_real[r] = fft->wk_real[n_wk];
+                    wk_imag[r] = fft->wk_imag[n_wk];
+                }
+                // -sin(x) == sin(-x)
+                if(calculate_ifft)
+                {
+                    wk_imag[r] = -wk_imag[r];
+                }
+            }
+
+            for(j = b; j < samples; j += space_butterfly_operant<<2)
+            {
+                t_real[0] = real[j];
+                t_imag[0] = imag[j];
+                if(b == 0)
+                {
+                    // wk = 1, (x*wk)>>LFFT_RHS_BITS == x
+                    t_real[1] = real[j+2*space_butterfly_operant];
+                    t_imag[1] = imag[j+2*space_butterfly_operant];
+                    t_real[2] = real[j+space_butterfly_operant];
+                    t_imag[2] = imag[j+space_butterfly_operant];
+                    t_real[3] = real[j+3*space_butterfly_operant];
+                    t_imag[3] = imag[j+3*space_butterfly_operant];
+                }
+                else
+                {
+                    real_1 = real[j+2*space_butterfly_operant];
+                    imag_1 = imag[j+2*space_butterfly_operant];
+                    t_real[1] = ((real_1*wk_real[1])>>LFFT_RHS_BITS)-
+                            ((imag_1*wk_imag[1])>>LFFT_RHS_BITS);
+                    t_imag[1] = ((imag_1*wk_real[1])>>LFFT_RHS_BITS)+
+                            ((real_1*wk_imag[1])>>LFFT_RHS_BITS);
+
+                    real_1 = real[j+space_butterfly_operant];
+                    imag_1 = imag[j+space_butterfly_operant];
+                    t_real[2] = ((real_1*wk_real[2])>>LFFT_RHS_BITS)-
+                            ((imag_1*wk_imag[2])>>LFFT_RHS_BITS);
+                    t_imag[2] = ((imag_1*wk_real[2])>>LFFT_RHS_BITS)+
+                            ((real_1*wk_imag[2])>>LFFT_RHS_BITS);
+
+                    real_1 = real[j+3*space_butterfly_operant];
+                    imag_1 = imag[j+3*space_butterfly_operant];
+                    t_real[3] = ((real_1*wk_real[3])>>LFFT_RHS_BITS)-
+                            ((imag_1*wk_imag[3])>>LFFT_RHS_BITS);
+                    t_imag[3] = ((imag_1*wk_real[3])>>LFFT_RHS_BITS)+
+                            ((real_1*wk_imag[3])>>LFFT_RHS_BITS);
+                }
+
+                // X[b]         = (t0+t2)+(t1+t3)
+                // X[b+2*space] = (t0+t2)-(t1+t3)
+                sum_real = t_real[0]+t_real[2];
+                sum_imag = t_imag[0]+t_imag[2];
+                real[j] = sum_real+(t_real[1]+t_real[3]);
+                imag[j] = sum_imag+(t_imag[1]+t_imag[3]);
+                real[j+2*space_butterfly_operant] = sum_real-(t_real[1]+t_real[3]);
+                imag[j+2*space_butterfly_operant] = sum_imag-(t_imag[1]+t_imag[3]);
+
+                // fft:  X[b+space]   = (t0-t2)-j*(t1-t3)
+                //       X[b+3*space] = (t0-t2)+j*(t1-t3)
+                // ifft: the sign of j is inverted
+                diff_real = t_real[0]-t_real[2];
+                diff_imag = t_imag[0]-t_imag[2];
+                real_1 = t_real[1]-t_real[3];
+                imag_1 = t_imag[1]-t_imag[3];
+                if(calculate_ifft)
+                {
+                    real_1 = -real_1;
+                    imag_1 = -imag_1;
+                }
+                real[j+space_butterfly_operant] = diff_real+imag_1;
+                imag[j+space_butterfly_operant] = diff_imag-real_1;
+                real[j+3*space_butterfly_operant] = diff_real-imag_1;
+                imag[j+3*space_butterfly_operant] = diff_imag+real_1;
+            }
+        }
+        // space_butterfly_operant = space_butterfly_operant*4
+        space_butterfly_operant <<= 2;
+    }
+}
+
+static void _lfft_fft_stockham(const lfft_Fft * fft, uint32_t samples, uint8_t steps,
+        int32_t real[], int32_t imag[], bool calculate_ifft, int32_t workspace[])
+{
+    uint8_t i;
+    uint32_t j;
+    uint32_t k;
+
+    // temporary variables
+    int32_t real_1;
+    int32_t real_2;
+    int32_t imag_1;
+    int32_t imag_2;
+    int32_t real_wk;
+    int32_t imag_wk;
+    int32_t wk_real;
+    int32_t wk_imag;
+    int32_t * temp;
+
+    // buffers of the ping-pong calculation
+    int32_t * x_real = real;
+    int32_t * x_imag = imag;
+    int32_t * y_real = workspace;
+    int32_t * y_imag = &workspace[fft->samples];
+
+    uint32_t half     = 1; // half length of the ffts calculated in the step
+    uint32_t sequence = samples/2; // number of ffts calculated in the step
+    const int32_t * wk; // contiguous wk values of the step
+
+    // the k-th fft of the step is calculated from the input data
+    // x[k+sequence*n] and stored at y[k+sequence*j], j is the frequency:
+    //   y[k+sequence*j]        = x[k+2*sequence*j]+x[k+2*sequence*j+sequence]*wk^j
+    //   y[k+sequence*(j+half)] = x[k+2*sequence*j]-x[k+2*sequence*j+sequence]*wk^j
+    // all ffts use the same wk value for the same j, so the innermost loop
+    // reads and writes sequence consecutive elements. The butterflies are the
+    // same as the butterflies of _lfft_fft_radix2(), only the positions of the
+    // results are different.
+    for(i = 0; i < steps; i++)
+    {
+        wk = &fft->step_wk[LFFT_STEP_WK(half)];
+
+        for(j = 0; j < half; j++)
+        {
+            // cos(x) == cos(-x)
+            wk_real = wk[2*j];
+            // -sin(x) == sin(-x)
+            wk_imag = calculate_ifft ? -wk[2*j+1] : wk[2*j+1];
+
+            for(k = 0; k < sequence; k++)
+            {
+                real_1 = x_real[2*sequence*j+k];
+                imag_1 = x_imag[2*sequence*j+k];
+                real_2 = x_real[2*sequence*j+sequence+k];
+                imag_2 = x_imag[2*sequence*j+sequence+k];
+
+                real_wk = ((real_2*wk_real)>>LFFT_RHS_BITS)-((imag_2*wk_imag)>>LFFT_RHS_BITS);
+                imag_wk = ((imag_2*wk_real)>>LFFT_RHS_BITS)+((real_2*wk_imag)>>LFFT_RHS_BITS);
+
+                y_real[sequence*j+k] = real_1+real_wk;
+                y_imag[sequence*j+k] = imag_1+imag_wk;
+                y_real[sequence*(j+half)+k] = real_1-real_wk;
+                y_imag[sequence*(j+half)+k] = imag_1-imag_wk;
+            }
+        }
+
+        temp = x_real;
+        x_real = y_real;
+        y_real = temp;
+        temp = x_imag;
+        x_imag = y_imag;
+        y_imag = temp;
+
+        half <<= 1;
+        sequence >>= 1;
+    }
+
+    // an odd number of steps leaves the result in the workspace
+    if(x_real != real)
+    {
+        memcpy(real, x_real, samples*sizeof(int32_t));
+        memcpy(imag, x_imag, samples*sizeof(int32_t));
+    }
+}
@@ -28,9 +28,22 @@
 /*! \file
  * This file contains functions to calculate the fft (fast fourier
  * transformation) and ifft (inverse fast fourier transfomration)
- * It uses the radix-2 algorithm for calculation.
+ * It uses the radix-2 algorithm for calculation. Sizes which are not to the
+ * power of 2 are calculated with mixed radix (2, 3, 5, 7) butterflies or the
+ * bluestein algorithm, see lfft_plan.h.
  * The calculation is optimized for processors without a FPU.
- * float is only used during the initialization process.
+ * float is only used during the initialization process. The float functions
+ * convert the data to fixed point; processors with a FPU can use lfft_Float
+ * of lfft_float.h instead.
+ *
+ * A lfft_Fft struct is a read-only plan for all functions which take a
+ * const lfft_Fft pointer and caller provided arrays (e.g. lfft_fft_out(),
+ * lfft_fft_inplace()). Several threads can calculate ffts with one lfft_Fft
+ * struct at the same time if every thread uses its own arrays. The other
+ * functions save the result in the arrays of the struct and must not be
+ * called concurrently. Sizes calculated with the bluestein algorithm and
+ * LFFT_KERNEL_STOCKHAM need a workspace, the read-only functions take it as
+ * an argument, see LFFT_FFT_WORKSPACE().
  *
  * \author Clemens Korner
  * \version 0.1.0
@@ -44,33 +57,95 @@ extern "C" {
 #endif
 
 #include "lfft_config.h"
+#include "lfft_plan.h"
 
 typedef int8_t lfft_errno;
 
+/*!
+ * Butterfly algorithms used for the fft calculation.
+ */
+typedef enum _lfft_Kernel
+{
+    LFFT_KERNEL_RADIX_2 = 0, //!< radix-2 butterflies, one step per pass
+    LFFT_KERNEL_RADIX_4 = 1, //!< radix-4 butterflies, two steps per pass; a radix-2 pass is added for an odd number of steps
+    LFFT_KERNEL_STOCKHAM = 2 //!< radix-2 stockham autosort, sequential access between two buffers without reordering the input
+} lfft_Kernel;
+
 typedef struct _lfft_Fft
 {
-    uint16_t   samples; //!< number of samples
+    uint32_t   samples; //!< number of samples
     uint8_t    steps; //!< number of steps
-    uint16_t   ones_mask; //!< binary mask used for fft calculation
+    uint32_t   ones_mask; //!< binary mask used for fft calculation
+    uint8_t    kernel; //!< lfft_Kernel used for fft calculation
 
-    uint16_t * switching_table; //!< table containing switching values for the input data
-    int32_t  * wk_real; //!< real wk values
-    int32_t  * wk_imag; //!< imaginary wk values
+    lfft_Plan * plan; //!< plan shared by all lfft_Fft structs with the same number of samples
+    uint32_t * switching_table; //!< table containing switching values for the input data; part of plan
+    int32_t  * wk_real; //!< real wk values; part of plan
+    int32_t  * wk_imag; //!< imaginary wk values; part of plan
+    int32_t  * step_wk; //!< contiguous wk values of every step, see LFFT_STEP_WK(); part of plan
+    int32_t  * workspace; //!< 2*plan->inner->samples elements for the bluestein algorithm, 2*samples elements for LFFT_KERNEL_STOCKHAM; NULL otherwise; only used by the functions without a workspace argument
+    uint32_t   input_samples; //!< number of leading non-zero input samples of the fft, see lfft_fft_new_input(); samples otherwise
 
     int32_t  * result_real; //!< array where real part of the fft calcilation is saved
     int32_t  * result_imag; //!< array where imaginary part of the fft calcilation is saved
 } lfft_Fft;
 
+/*!
+ * number of int32_t elements of the workspace of the functions with a
+ * workspace argument (e.g. lfft_fft_out()); 0 if fft doesn't need a workspace
+ */
+#define LFFT_FFT_WORKSPACE(fft) (((fft)->plan->inner != NULL) ? 2*(size_t) (fft)->plan->inner->samples : \
+        ((fft)->kernel == LFFT_KERNEL_STOCKHAM) ? 2*(size_t) (fft)->samples : 0)
+
 /*!
  * Initilizes the fft.
+ * The tables of the fft are shared with all other lfft_Fft structs with the
+ * same number of samples, see lfft_plan_acquire().
+ * \param fft pointer to struct to be initialized
+ * Every number of samples is possible. Powers of 2 are the fastest, products
+ * of 2, 3, 5 and 7 use mixed radix butterflies and all other sizes use the
+ * bluestein algorithm with a fft of a power of 2 size >= 2*samples-1, see
+ * lfft_plan_is_supported().
+ * \param samples number of input samples
+ * \return 0: successful 1: samples is 0 or a bluestein size above
+ *         LFFT_BLUESTEIN_MAX_SAMPLES 3: not enough memory
+ */
+lfft_errno lfft_fft_new(lfft_Fft * fft, uint32_t samples);
+
+/*!
+ * Initilizes the fft with a chosen butterfly algorithm.
+ * lfft_fft_new() uses LFFT_KERNEL_RADIX_2.
+ * The kernel is only used if samples is to the power of 2.
+ * \param fft pointer to struct to be initialized
+ * \param samples number of input samples
+ * \param kernel butterfly algorithm used for the calculation
+ * \return 0: successful 1: samples is 0 or a bluestein size above
+ *         LFFT_BLUESTEIN_MAX_SAMPLES 2: unknown kernel 3: not enough memory
+ */
+lfft_errno lfft_fft_new_kernel(lfft_Fft * fft, uint32_t samples, lfft_Kernel kernel);
+
+/*!
+ * Initilizes the fft of zero padded input data.
+ * Only the input_samples leading input samples are read by the fft functions
+ * with input data (lfft_fft(), lfft_fft_complex(), lfft_rfft(), the float
+ * and _out variants), all other input samples are zero. input_samples is
+ * rounded up to a power of 2 and the first log2(samples/input_samples)
+ * steps only copy the reordered input samples, e.g. 4 of 12 steps for 256
+ * samples padded to 4096. The result is the same as the result of
+ * lfft_fft_new() with zero padded input data.
+ * The ifft functions, lfft_fft_inplace() and _lfft_fft_calculation() use
+ * all samples. LFFT_KERNEL_RADIX_2 is used.
  * \param fft pointer to struct to be initialized
- * \param samples number of input samples; must be to the power of 2
- * \return 0: successful 1: samples is not to the power of 2
+ * \param samples number of samples of the fft; must be to the power of 2
+ * \param input_samples number of leading non-zero input samples; 1..samples
+ * \return 0: successful 1: samples is not to the power of 2 2: invalid input_samples
+ *         3: not enough memory
  */
-lfft_errno lfft_fft_new(lfft_Fft * fft, uint16_t samples);
+lfft_errno lfft_fft_new_input(lfft_Fft * fft, uint32_t samples, uint32_t input_samples);
 
 /*!
  * Deallocate the used memory.
+ * The plan is released, see lfft_plan_release().
  * \param fft initialized lfft_Fft struct
  */
 void lfft_fft_delete(lfft_Fft * fft);
@@ -78,6 +153,7 @@ void lfft_fft_delete(lfft_Fft * fft);
 /*!
  * Calculates the fft with the radix-2 fft algorithm.
  * It uses only real input data, the imaginary part is set to 0.
+ * The calculation is done with a fft of half the size, see lfft_rfft().
  * \param fft initialized lfft_Fft struct
  * \param real real input data for fft.
  */
@@ -95,6 +171,7 @@ void lfft_fft_complex(lfft_Fft * fft, const int32_t real[], const int32_t imag[]
 /*!
  * Calculates the fft with the radix-2 fft algorithm.
  * It uses only real input data, the imaginary part is set to 0.
+ * The calculation is done with a fft of half the size, see lfft_rfft().
  * \param fft initialized lfft_Fft struct
  * \param real real input data for fft.
  */
@@ -109,9 +186,32 @@ void lfft_fft_float(lfft_Fft * fft, const float real[]);
  */
 void lfft_fft_complex_float(lfft_Fft * fft, const float real[], const float imag[]);
 
+/*!
+ * Calculates the fft of real input data.
+ * The even and odd samples are packed into a complex fft of half the size,
+ * which is split into the spectrum afterwards.
+ * Only the samples/2+1 non-redundant elements 0..samples/2 of the result are
+ * valid, the remaining elements are the complex conjugates of them.
+ * \param fft initialized lfft_Fft struct
+ * \param real real input data for fft.
+ */
+void lfft_rfft(lfft_Fft * fft, const int32_t real[]);
+
+/*!
+ * Calculates the fft of real input data.
+ * The even and odd samples are packed into a complex fft of half the size,
+ * which is split into the spectrum afterwards.
+ * Only the samples/2+1 non-redundant elements 0..samples/2 of the result are
+ * valid, the remaining elements are the complex conjugates of them.
+ * \param fft initialized lfft_Fft struct
+ * \param real real input data for fft.
+ */
+void lfft_rfft_float(lfft_Fft * fft, const float real[]);
+
 /*!
  * Calculates the inverse-fft with the radix-2 fft algorithm.
  * It uses only real input data, the imaginary part is set to 0.
+ * The calculation is done with a fft of half the size, see lfft_rfft().
  * \param fft initialized lfft_Fft struct
  * \param real real input data for fft.
  */
@@ -129,6 +229,7 @@ void lfft_ifft_complex(lfft_Fft * fft, const int32_t real[], const int32_t imag[
 /*!
  * Calculates the inverse-fft with the radix-2 fft algorithm.
  * It uses only real input data, the imaginary part is set to 0.
+ * The calculation is done with a fft of half the size, see lfft_rfft().
  * \param fft initialized lfft_Fft struct
  * \param real real input data for fft.
  */
@@ -143,13 +244,152 @@ void lfft_ifft_float(lfft_Fft * fft, const float real[]);
  */
 void lfft_ifft_complex_float(lfft_Fft * fft, const float real[], const float imag[]);
 
+/*!
+ * Calculates the fft into caller provided arrays.
+ * It uses only real input data, the imaginary part is set to 0.
+ * The arrays of fft are not used, the input data is reordered directly into
+ * result_real and result_imag. The result has LFFT_RHS_BITS decimal places
+ * like the arrays of fft, see lfft_fft_export().
+ * \param fft initialized lfft_Fft struct
+ * \param real real input data for fft; must not overlap with the result
+ * \param result_real array with fft->samples elements for the real result
+ * \param result_imag array with fft->samples elements for the imaginary result
+ * \param workspace array with LFFT_FFT_WORKSPACE(fft) elements; NULL if it is 0
+ */
+void lfft_fft_out(const lfft_Fft * fft, const int32_t real[], int32_t result_real[], int32_t result_imag[],
+        int32_t workspace[]);
+
+/*!
+ * Calculates the fft into caller provided arrays.
+ * It uses real input and imaginary input data.
+ * The arrays of fft are not used, the input data is reordered directly into
+ * result_real and result_imag. The result has LFFT_RHS_BITS decimal places
+ * like the arrays of fft, see lfft_fft_export().
+ * \param fft initialized lfft_Fft struct
+ * \param real real input data for fft; must not overlap with the result
+ * \param imag imaginary input data for fft; must not overlap with the result
+ * \param result_real array with fft->samples elements for the real result
+ * \param result_imag array with fft->samples elements for the imaginary result
+ * \param workspace array with LFFT_FFT_WORKSPACE(fft) elements; NULL if it is 0
+ */
+void lfft_fft_complex_out(const lfft_Fft * fft, const int32_t real[], const int32_t imag[],
+        int32_t result_real[], int32_t result_imag[], int32_t workspace[]);
+
+/*!
+ * Calculates the inverse-fft into caller provided arrays.
+ * It uses only real input data, the imaginary part is set to 0.
+ * See lfft_fft_out().
+ * \param fft initialized lfft_Fft struct
+ * \param real real input data for ifft; must not overlap with the result
+ * \param result_real array with fft->samples elements for the real result
+ * \param result_imag array with fft->samples elements for the imaginary result
+ * \param workspace array with LFFT_FFT_WORKSPACE(fft) elements; NULL if it is 0
+ */
+void lfft_ifft_out(const lfft_Fft * fft, const int32_t real[], int32_t result_real[], int32_t result_imag[],
+        int32_t workspace[]);
+
+/*!
+ * Calculates the inverse-fft into caller provided arrays.
+ * It uses real input and imaginary input data.
+ * See lfft_fft_complex_out().
+ * \param fft initialized lfft_Fft struct
+ * \param real real input data for ifft; must not overlap with the result
+ * \param imag imaginary input data for ifft; must not overlap with the result
+ * \param result_real array with fft->samples elements for the real result
+ * \param result_imag array with fft->samples elements for the imaginary result
+ * \param workspace array with LFFT_FFT_WORKSPACE(fft) elements; NULL if it is 0
+ */
+void lfft_ifft_complex_out(const lfft_Fft * fft, const int32_t real[], const int32_t imag[],
+        int32_t result_real[], int32_t result_imag[], int32_t workspace[]);
+
+/*!
+ * Calculates the fft in place.
+ * The data is reordered by swapping the elements and replaced by the result.
+ * LFFT_KERNEL_STOCKHAM calculates without reordering the data.
+ * The input and the result have LFFT_RHS_BITS decimal places, see
+ * lfft_fft_import() and lfft_fft_export().
+ * \param fft initialized lfft_Fft struct
+ * \param real real data with fft->samples elements; replaced by the real result
+ * \param imag imaginary data with fft->samples elements; replaced by the imaginary result
+ * \param workspace array with LFFT_FFT_WORKSPACE(fft) elements; NULL if it is 0
+ */
+void lfft_fft_inplace(const lfft_Fft * fft, int32_t real[], int32_t imag[], int32_t workspace[]);
+
+/*!
+ * Calculates the inverse-fft in place.
+ * See lfft_fft_inplace().
+ * \param fft initialized lfft_Fft struct
+ * \param real real data with fft->samples elements; replaced by the real result
+ * \param imag imaginary data with fft->samples elements; replaced by the imaginary result
+ * \param workspace array with LFFT_FFT_WORKSPACE(fft) elements; NULL if it is 0
+ */
+void lfft_ifft_inplace(const lfft_Fft * fft, int32_t real[], int32_t imag[], int32_t workspace[]);
+
+/*!
+ * Converts data to the format used for the calculation.
+ * fixed[i] = data[i]*2^LFFT_RHS_BITS
+ * data and fixed may be the same array.
+ * \param data input data
+ * \param fixed array for the converted data
+ * \param n number of elements
+ */
+void lfft_fft_import(const int32_t data[], int32_t fixed[], uint32_t n);
+
+/*!
+ * Converts data to the format used for the calculation.
+ * fixed[i] = data[i]*2^LFFT_RHS_BITS
+ * \param data input data
+ * \param fixed array for the converted data
+ * \param n number of elements
+ */
+void lfft_fft_import_float(const float data[], int32_t fixed[], uint32_t n);
+
+/*!
+ * Converts results of the calculation to integers.
+ * data[i] = fixed[i]/2^LFFT_RHS_BITS
+ * fixed and data may be the same array.
+ * \param fixed result of the calculation
+ * \param data array for the converted result
+ * \param n number of elements
+ */
+void lfft_fft_export(const int32_t fixed[], int32_t data[], uint32_t n);
+
+/*!
+ * Converts results of the calculation to floats.
+ * data[i] = fixed[i]/2^LFFT_RHS_BITS
+ * \param fixed result of the calculation
+ * \param data array for the converted result
+ * \param n number of elements
+ */
+void lfft_fft_export_float(const int32_t fixed[], float data[], uint32_t n);
+
+/*!
+ * Copies the whole result of the fft.
+ * It is the same as lfft_fft_result_real_at() and lfft_fft_result_imag_at()
+ * for all elements.
+ * \param fft initialized lfft_Fft struct
+ * \param real array with fft->samples elements for the real result
+ * \param imag array with fft->samples elements for the imaginary result
+ */
+void lfft_fft_result(const lfft_Fft * fft, int32_t real[], int32_t imag[]);
+
+/*!
+ * Copies the whole result of the fft.
+ * It is the same as lfft_fft_result_real_float_at() and
+ * lfft_fft_result_imag_float_at() for all elements.
+ * \param fft initialized lfft_Fft struct
+ * \param real array with fft->samples elements for the real result
+ * \param imag array with fft->samples elements for the imaginary result
+ */
+void lfft_fft_result_float(const lfft_Fft * fft, float real[], float imag[]);
+
 /*!
  * Returns an element of the real part of the fft
  * \param fft initialized lfft_Fft struct
  * \param n number of the requested element
  * \return real result of the fft
  */
-int32_t lfft_fft_result_real_at(lfft_Fft * fft, uint16_t n);
+int32_t lfft_fft_result_real_at(const lfft_Fft * fft, uint32_t n);
 
 /*!
  * Returns an element of the imag part of the fft
@@ -157,7 +397,7 @@ int32_t lfft_fft_result_real_at(lfft_Fft * fft, uint16_t n);
  * \param  n number of the requested element
  * \return imaginary result of the fft
  */
-int32_t lfft_fft_result_imag_at(lfft_Fft * fft, uint16_t n);
+int32_t lfft_fft_result_imag_at(const lfft_Fft * fft, uint32_t n);
 
 /*!
  * Returns an element of the real part of the fft
@@ -165,7 +405,7 @@ int32_t lfft_fft_result_imag_at(lfft_Fft * fft, uint16_t n);
  * \param n number of the requested element
  * \return real result of the fft
  */
-float lfft_fft_result_real_float_at(lfft_Fft * fft, uint16_t n);
+float lfft_fft_result_real_float_at(const lfft_Fft * fft, uint32_t n);
 
 /*!
  * Returns an element of the imag part of the fft
@@ -173,25 +413,26 @@ float lfft_fft_result_real_float_at(lfft_Fft * fft, uint16_t n);
  * \param  n number of the requested element
  * \return imaginary result of the fft
  */
-float lfft_fft_result_imag_float_at(lfft_Fft * fft, uint16_t n);
+float lfft_fft_result_imag_float_at(const lfft_Fft * fft, uint32_t n);
 
 /*!
  * Calculates the absoulte value at n.
  * result = sqrt(real[n]^2+imag[n]^2)
+ * Use lfft_spectrum_magnitude() for the whole spectrum.
  * \param fft initialized lfft_Fft struct
  * \param n element at n
- * \return absolute value at n
+ * \return absolute value at n; 0xFFFF if it is bigger
  */
-uint16_t lfft_fft_abs_at(lfft_Fft * fft, uint16_t n);
+uint16_t lfft_fft_abs_at(const lfft_Fft * fft, uint32_t n);
 
 /*!
  * Calculates the absoulte value and normalizes it at n.
  * result = sqrt((real[n]/samples)^2+(imag[n]/samples)^2)
  * \param fft initialized lfft_Fft struct
  * \param n element at n
- * \return absolute and normalized value at n
+ * \return absolute and normalized value at n; 0xFFFF if it is bigger
  */
-uint16_t lfft_fft_abs_and_norm_at(lfft_Fft * fft, uint16_t n);
+uint16_t lfft_fft_abs_and_norm_at(const lfft_Fft * fft, uint32_t n);
 
 /*!
  * Calculates the integer square root.
@@ -200,8 +441,25 @@ uint16_t lfft_fft_abs_and_norm_at(lfft_Fft * fft, uint16_t n);
  */
 uint16_t lfft_isqrt(uint32_t x);
 
+/*!
+ * Calculates the integer square root of a 64 bit number with newton steps,
+ * the first step is derived from the bit length of x.
+ * \param x positive number
+ * \return floor(sqrt(x))
+ */
+uint32_t lfft_isqrt64(uint64_t x);
+
+/*!
+ * Returns the number of bits of x without leading zeros.
+ * Don't use this function if it is possible to use the above functions.
+ * \param x positive number
+ * \return position of the highest set bit plus 1; 0 for x == 0
+ */
+uint8_t _lfft_bit_length(uint64_t x);
+
 /*!
  * Calculates the base algorithm of the fft.
+ * The butterfly algorithm is chosen by fft->kernel.
  * You have to reorder and adjust the input data manually.
  * Don't use this function if it is possible to use the above functions.
  * \param fft initialized lfft_Fft struct
@@ -209,6 +467,78 @@ uint16_t lfft_isqrt(uint32_t x);
  */
 void _lfft_fft_calculation(lfft_Fft * fft, bool calculate_ifft);
 
+/*!
+ * Calculates the base algorithm of the fft in caller provided arrays.
+ * The data has to be reordered and has to have LFFT_RHS_BITS decimal places.
+ * fft is not changed, see lfft_fft_inplace().
+ * Don't use this function if it is possible to use the above functions.
+ * \param fft initialized lfft_Fft struct
+ * \param real reordered real data; replaced by the real result
+ * \param imag reordered imaginary data; replaced by the imaginary result
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ * \param workspace array with LFFT_FFT_WORKSPACE(fft) elements
+ */
+void _lfft_fft_calculation_buffer(const lfft_Fft * fft, int32_t real[], int32_t imag[], bool calculate_ifft,
+        int32_t workspace[]);
+
+/*!
+ * Calculates the fft of real input data which is packed into a complex fft
+ * of half the size.
+ * The even samples have to be reordered into result_real, the odd samples
+ * into result_imag (in natural order for LFFT_KERNEL_STOCKHAM), see
+ * lfft_rfft(). samples has to be to the power of 2.
+ * Afterwards the elements 0..samples/2 of the result are valid.
+ * Don't use this function if it is possible to use the above functions.
+ * \param fft initialized lfft_Fft struct
+ * \param result_real packed real input data; replaced by the real result
+ * \param result_imag packed imaginary input data; replaced by the imaginary result
+ * \param workspace array with LFFT_FFT_WORKSPACE(fft) elements
+ */
+void _lfft_rfft_calculation(const lfft_Fft * fft, int32_t result_real[], int32_t result_imag[],
+        int32_t workspace[]);
+
+/*!
+ * Calculates the ifft of the spectrum of real data with a complex ifft of
+ * half the size, the inverse of _lfft_rfft_calculation().
+ * The elements 0..samples/2 of the spectrum have to be in natural order,
+ * the remaining elements are the complex conjugates of them and are not read.
+ * Afterwards result_real contains the samples real values, result_imag is
+ * overwritten. samples has to be to the power of 2.
+ * Don't use this function if it is possible to use the above functions.
+ * \param fft initialized lfft_Fft struct
+ * \param result_real real part of the spectrum; replaced by the real result
+ * \param result_imag imaginary part of the spectrum; overwritten
+ * \param workspace array with LFFT_FFT_WORKSPACE(fft) elements
+ */
+void _lfft_irfft_calculation(const lfft_Fft * fft, int32_t result_real[], int32_t result_imag[],
+        int32_t workspace[]);
+
+/*!
+ * Calculates the radix-2 decimation in time butterflies of bit reversed data.
+ * The result is in natural order and is not divided by fft->samples.
+ * samples has to be to the power of 2 and fft->kernel has to be
+ * LFFT_KERNEL_RADIX_2.
+ * Don't use this function if it is possible to use the above functions.
+ * \param fft initialized lfft_Fft struct
+ * \param real bit reversed real data; replaced by the real result
+ * \param imag bit reversed imaginary data; replaced by the imaginary result
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+void _lfft_fft_dit(const lfft_Fft * fft, int32_t real[], int32_t imag[], bool calculate_ifft);
+
+/*!
+ * Calculates the radix-2 decimation in frequency butterflies of data in
+ * natural order. The result is bit reversed and is not divided by
+ * fft->samples, so _lfft_fft_dit() can process it without reordering.
+ * samples has to be to the power of 2.
+ * Don't use this function if it is possible to use the above functions.
+ * \param fft initialized lfft_Fft struct
+ * \param real real data with LFFT_RHS_BITS decimal places; replaced by the bit reversed real result
+ * \param imag imaginary data with LFFT_RHS_BITS decimal places; replaced by the bit reversed imaginary result
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+void _lfft_fft_dif(const lfft_Fft * fft, int32_t real[], int32_t imag[], bool calculate_ifft);
+
 
 #ifdef __cplusplus
 }
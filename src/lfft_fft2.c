@@ -77,38 +77,129 @@ static void _lfft_fft2_float(lfft_Fft2 * fft2, float ** real, bool calculate_iff
  */
 static void _lfft_fft2_complex_float(lfft_Fft2 * fft2, float ** real, float ** imag, bool calculate_ifft2);
 
+/*!
+ * Packs real input data into the rows for the real row ffts, see
+ * _lfft_rfft_calculation().
+ * \param fft2 initialized lfft_Fft2 struct
+ * \param real 2D-real input data for fft
+ */
+static void _lfft_rfft2(lfft_Fft2 * fft2, int32_t ** real);
+
+/*!
+ * Packs real input data into the rows for the real row ffts, see
+ * _lfft_rfft_calculation().
+ * \param fft2 initialized lfft_Fft2 struct
+ * \param real 2D-real input data for fft
+ */
+static void _lfft_rfft2_float(lfft_Fft2 * fft2, float ** real);
+
+/*!
+ * Returns if the rows can be calculated with real ffts of half the size.
+ * \param fft2 initialized lfft_Fft2 struct
+ * \return true: columns is to the power of 2 and at least 2
+ */
+static bool _lfft_fft2_is_real(const lfft_Fft2 * fft2);
+
+/*!
+ * Calculates the ffts of the first columns of the rows.
+ * The columns are transposed into the temporary data, reordered with the
+ * switching table of fft_columns, calculated and transposed back.
+ * \param fft2 initialized lfft_Fft2 struct
+ * \param columns number of calculated columns
+ * \param calculate_ifft2 false to calculate fft, true to calculate ifft
+ */
+static void _lfft_fft2_columns(lfft_Fft2 * fft2, uint16_t columns, bool calculate_ifft2);
+
+/*!
+ * Returns the distance of two rows of a contiguous 2D-buffer.
+ * The rows are aligned to LFFT_ALIGNMENT bytes and padded by
+ * LFFT_FFT2_PADDING bytes if their size is a multiple of
+ * LFFT_FFT2_PADDING_STRIDE bytes.
+ * \param columns number of columns of the buffer
+ * \return distance of two rows in elements
+ */
+static uint32_t _lfft_fft2_stride(uint16_t columns);
+
+/*!
+ * Transposes a matrix in blocks of LFFT_FFT2_TILE rows and columns.
+ * destination[j][i] = source[switching_table[i]][j]
+ * \param source rows rows with source_stride elements
+ * \param source_stride distance of two rows of source in elements
+ * \param destination columns rows with destination_stride elements
+ * \param destination_stride distance of two rows of destination in elements
+ * \param rows number of rows of source
+ * \param columns number of columns of source
+ * \param switching_table order of the rows of source; NULL for natural order
+ */
+static void _lfft_fft2_transpose(const int32_t source[], uint32_t source_stride, int32_t destination[],
+        uint32_t destination_stride, uint16_t rows, uint16_t columns, const uint32_t * switching_table);
+
 lfft_errno lfft_fft2_new(lfft_Fft2 * fft2, uint16_t rows, uint16_t columns)
 {
     uint16_t i;
+    size_t elements;
+    size_t elements_temp;
+    uintptr_t data;
+    lfft_errno error;
 
     fft2->rows = rows;
     fft2->columns = columns;
 
     fft2->fft_rows    = (lfft_Fft *) malloc(sizeof(lfft_Fft));
     fft2->fft_columns = (lfft_Fft *) malloc(sizeof(lfft_Fft));
-
-    // initialize fft's and check if they size is to the power of 2
-    if(lfft_fft_new(fft2->fft_rows, fft2->columns)||lfft_fft_new(fft2->fft_columns, fft2->rows))
+    if((fft2->fft_rows == NULL)||(fft2->fft_columns == NULL))
     {
-        return 1;
+        free(fft2->fft_rows);
+        free(fft2->fft_columns);
+        return 3;
     }
 
-    fft2->result_real_temp = (int32_t **) malloc(fft2->columns*sizeof(int32_t *));
-    fft2->result_imag_temp = (int32_t **) malloc(fft2->columns*sizeof(int32_t *));
+    // initialize fft's and check if they size is not 0
+    error = lfft_fft_new(fft2->fft_rows, fft2->columns);
+    if(error != 0)
+    {
+        free(fft2->fft_rows);
+        free(fft2->fft_columns);
+        return error;
+    }
+    error = lfft_fft_new(fft2->fft_columns, fft2->rows);
+    if(error != 0)
+    {
+        lfft_fft_delete(fft2->fft_rows);
+        free(fft2->fft_rows);
+        free(fft2->fft_columns);
+        return error;
+    }
 
-    for(i = 0; i < fft2->columns; i++)
+    // row pointers followed by four aligned blocks (real, imag and the
+    // transposed temporary data)
+    fft2->stride      = _lfft_fft2_stride(columns);
+    fft2->stride_temp = _lfft_fft2_stride(rows);
+    elements      = (size_t) rows*fft2->stride;
+    elements_temp = (size_t) columns*fft2->stride_temp;
+    fft2->memory = malloc(2*rows*sizeof(int32_t *)+LFFT_ALIGNMENT+2*(elements+elements_temp)*sizeof(int32_t));
+    if(fft2->memory == NULL)
     {
-        fft2->result_real_temp[i] = (int32_t *) malloc(fft2->rows*sizeof(int32_t));
-        fft2->result_imag_temp[i] = (int32_t *) malloc(fft2->rows*sizeof(int32_t));
+        lfft_fft_delete(fft2->fft_rows);
+        lfft_fft_delete(fft2->fft_columns);
+        free(fft2->fft_rows);
+        free(fft2->fft_columns);
+        return 3;
     }
 
-    fft2->result_real = (int32_t **) malloc(fft2->rows*sizeof(int32_t *));
-    fft2->result_imag = (int32_t **) malloc(fft2->rows*sizeof(int32_t *));
+    fft2->result_real = (int32_t **) fft2->memory;
+    fft2->result_imag = &fft2->result_real[rows];
 
-    for(i = 0; i < fft2->rows; i++)
+    data = ((uintptr_t) &fft2->result_imag[rows]+LFFT_ALIGNMENT-1)&~((uintptr_t) LFFT_ALIGNMENT-1);
+    fft2->data_real        = (int32_t *) data;
+    fft2->data_imag        = &fft2->data_real[elements];
+    fft2->result_real_temp = &fft2->data_imag[elements];
+    fft2->result_imag_temp = &fft2->result_real_temp[elements_temp];
+
+    for(i = 0; i < rows; i++)
     {
-        fft2->result_real[i] = (int32_t *) malloc(fft2->columns*sizeof(int32_t));
-        fft2->result_imag[i] = (int32_t *) malloc(fft2->columns*sizeof(int32_t));
+        fft2->result_real[i] = &fft2->data_real[(size_t) i*fft2->stride];
+        fft2->result_imag[i] = &fft2->data_imag[(size_t) i*fft2->stride];
     }
 
     return 0;
@@ -119,10 +210,9 @@ void lfft_fft2_delete(lfft_Fft2 * fft2)
     lfft_fft_delete(fft2->fft_rows);
     lfft_fft_delete(fft2->fft_columns);
 
-    free(fft2->result_real);
-    free(fft2->result_imag);
-    free(fft2->result_real_temp);
-    free(fft2->result_imag_temp);
+    free(fft2->fft_rows);
+    free(fft2->fft_columns);
+    free(fft2->memory);
 }
 
 void lfft_fft2(lfft_Fft2 * fft2, int32_t ** real)
@@ -165,66 +255,165 @@ void lfft_ifft2_complex_float(lfft_Fft2 * fft2, float ** real, float ** imag)
     _lfft_fft2_complex_float(fft2, real, imag, true);
 }
 
-int32_t lfft_fft2_result_real_at(lfft_Fft2 * fft2, uint16_t row, uint16_t column)
+void lfft_rfft2(lfft_Fft2 * fft2, int32_t ** real)
+{
+    if(!_lfft_fft2_is_real(fft2))
+    {
+        _lfft_fft2(fft2, real, false);
+        return;
+    }
+
+    _lfft_rfft2(fft2, real);
+    _lfft_rfft2_calculation(fft2);
+}
+
+void lfft_rfft2_float(lfft_Fft2 * fft2, float ** real)
+{
+    if(!_lfft_fft2_is_real(fft2))
+    {
+        _lfft_fft2_float(fft2, real, false);
+        return;
+    }
+
+    _lfft_rfft2_float(fft2, real);
+    _lfft_rfft2_calculation(fft2);
+}
+
+void lfft_irfft2(lfft_Fft2 * fft2, int32_t ** real, int32_t ** imag)
+{
+    uint16_t i;
+    uint16_t j;
+
+    for(i = 0; i < fft2->rows; i++)
+    {
+        for(j = 0; j <= fft2->columns/2; j++)
+        {
+            fft2->result_real[i][j] = real[i][j]<<LFFT_RHS_BITS;
+            fft2->result_imag[i][j] = imag[i][j]<<LFFT_RHS_BITS;
+        }
+    }
+
+    _lfft_irfft2_calculation(fft2);
+}
+
+void lfft_irfft2_float(lfft_Fft2 * fft2, float ** real, float ** imag)
+{
+    uint16_t i;
+    uint16_t j;
+
+    for(i = 0; i < fft2->rows; i++)
+    {
+        for(j = 0; j <= fft2->columns/2; j++)
+        {
+            fft2->result_real[i][j] = (int32_t) (real[i][j]*(1<<LFFT_RHS_BITS));
+            fft2->result_imag[i][j] = (int32_t) (imag[i][j]*(1<<LFFT_RHS_BITS));
+        }
+    }
+
+    _lfft_irfft2_calculation(fft2);
+}
+
+int32_t lfft_fft2_result_real_at(const lfft_Fft2 * fft2, uint16_t row, uint16_t column)
 {
     return fft2->result_real[row][column]>>LFFT_RHS_BITS;
 }
 
-int32_t lfft_fft2_result_imag_at(lfft_Fft2 * fft2, uint16_t row, uint16_t column)
+int32_t lfft_fft2_result_imag_at(const lfft_Fft2 * fft2, uint16_t row, uint16_t column)
 {
     return fft2->result_imag[row][column]>>LFFT_RHS_BITS;
 }
 
-float lfft_fft2_result_real_float_at(lfft_Fft2 * fft2, uint16_t row, uint16_t column)
+float lfft_fft2_result_real_float_at(const lfft_Fft2 * fft2, uint16_t row, uint16_t column)
 {
     return ((float) fft2->result_real[row][column])/(1<<LFFT_RHS_BITS);
 }
 
-float lfft_fft2_result_imag_float_at(lfft_Fft2 * fft2, uint16_t row, uint16_t column)
+float lfft_fft2_result_imag_float_at(const lfft_Fft2 * fft2, uint16_t row, uint16_t column)
 {
     return ((float) fft2->result_imag[row][column])/(1<<LFFT_RHS_BITS);
 }
 
 void _lfft_fft2_calculation(lfft_Fft2 * fft2, bool calculate_ifft2)
+{
+    uint16_t i;
+
+    // the rows and columns are calculated directly in the arrays of fft2,
+    // fft_rows and fft_columns only provide the plans and their workspaces
+    for(i = 0; i < fft2->rows; i++)
+    {
+        _lfft_fft_calculation_buffer(fft2->fft_rows, fft2->result_real[i], fft2->result_imag[i], calculate_ifft2,
+                fft2->fft_rows->workspace);
+    }
+
+    _lfft_fft2_columns(fft2, fft2->columns, calculate_ifft2);
+}
+
+void _lfft_rfft2_calculation(lfft_Fft2 * fft2)
+{
+    uint16_t i;
+
+    for(i = 0; i < fft2->rows; i++)
+    {
+        _lfft_rfft_calculation(fft2->fft_rows, fft2->result_real[i], fft2->result_imag[i], fft2->fft_rows->workspace);
+    }
+
+    // the columns columns/2+1..columns-1 are redundant
+    _lfft_fft2_columns(fft2, fft2->columns/2+1, false);
+}
+
+void _lfft_irfft2_calculation(lfft_Fft2 * fft2)
 {
     uint16_t i;
     uint16_t j;
+    uint16_t mirror;
+    int32_t * row_real;
+    int32_t * row_imag;
 
+    if(_lfft_fft2_is_real(fft2))
+    {
+        // the columns columns/2+1..columns-1 are redundant
+        _lfft_fft2_columns(fft2, fft2->columns/2+1, true);
+
+        for(i = 0; i < fft2->rows; i++)
+        {
+            _lfft_irfft_calculation(fft2->fft_rows, fft2->result_real[i], fft2->result_imag[i],
+                    fft2->fft_rows->workspace);
+            memset(fft2->result_imag[i], 0, sizeof(fft2->result_imag[0][0])*fft2->columns);
+        }
+        return;
+    }
+
+    // complete the spectrum, X[i][j] = conj(X[(rows-i)%rows][columns-j])
     for(i = 0; i < fft2->rows; i++)
     {
-        fft2->fft_rows->result_real = fft2->result_real[i];
-        fft2->fft_rows->result_imag = fft2->result_imag[i];
-        _lfft_fft_calculation(fft2->fft_rows, calculate_ifft2);
-        // rotate the result and switch the values
-        //   input data     rotated data   rotated and switched data
-        //   |00 01 02 03|  |00 10 20 30|  |00 10 20 30|
-        //   |10 11 12 13|  |01 11 21 31|  |02 12 22 32|
-        //   |20 21 22 23|  |02 12 22 32|  |01 11 21 31|
-        //   |30 31 32 33|  |03 13 23 33|  |03 13 23 33|
-        for(j = 0; j < fft2->columns; j++)
+        mirror = (i == 0) ? 0 : fft2->rows-i;
+        for(j = fft2->columns/2+1; j < fft2->columns; j++)
         {
-            fft2->result_real_temp[j][fft2->fft_columns->switching_table[i]] = fft2->fft_rows->result_real[j];
-            fft2->result_imag_temp[j][fft2->fft_columns->switching_table[i]] = fft2->fft_rows->result_imag[j];
+            fft2->result_real[i][j] = fft2->result_real[mirror][fft2->columns-j];
+            fft2->result_imag[i][j] = -fft2->result_imag[mirror][fft2->columns-j];
         }
     }
 
-    for(i = 0; i < fft2->columns; i++)
+    // reorder the rows with the temporary data
+    row_real = fft2->result_real_temp;
+    row_imag = fft2->result_imag_temp;
+    for(i = 0; i < fft2->rows; i++)
     {
-        fft2->fft_columns->result_real = fft2->result_real_temp[i];
-        fft2->fft_columns->result_imag = fft2->result_imag_temp[i];
-        _lfft_fft_calculation(fft2->fft_columns, calculate_ifft2);
-        // rotate the result
-        //   data temp      rotated data
-        //   |00 01 02 03|  |00 10 20 30|
-        //   |10 11 12 13|  |01 11 21 31|
-        //   |20 21 22 23|  |02 12 22 32|
-        //   |30 31 32 33|  |03 13 23 33|
-        for(j = 0; j < fft2->rows; j++)
+        memcpy(row_real, fft2->result_real[i], sizeof(row_real[0])*fft2->columns);
+        memcpy(row_imag, fft2->result_imag[i], sizeof(row_imag[0])*fft2->columns);
+        for(j = 0; j < fft2->columns; j++)
         {
-            fft2->result_real[j][i] = fft2->fft_columns->result_real[j];
-            fft2->result_imag[j][i] = fft2->fft_columns->result_imag[j];
+            fft2->result_real[i][j] = row_real[fft2->fft_rows->switching_table[j]];
+            fft2->result_imag[i][j] = row_imag[fft2->fft_rows->switching_table[j]];
         }
     }
+
+    _lfft_fft2_calculation(fft2, true);
+
+    for(i = 0; i < fft2->rows; i++)
+    {
+        memset(fft2->result_imag[i], 0, sizeof(fft2->result_imag[0][0])*fft2->columns);
+    }
 }
 
 static void _lfft_fft2(lfft_Fft2 * fft2, int32_t ** real, bool calculate_ifft2)
@@ -303,3 +492,121 @@ static void _lfft_fft2_complex_float(lfft_Fft2 * fft2, float ** real, float ** i
     _lfft_fft2_calculation(fft2, calculate_ifft2);
 }
 
+static uint32_t _lfft_fft2_stride(uint16_t columns)
+{
+    uint32_t stride;
+
+    stride = (columns+LFFT_ALIGNMENT/sizeof(int32_t)-1)&~(LFFT_ALIGNMENT/sizeof(int32_t)-1);
+    if((stride*sizeof(int32_t))%LFFT_FFT2_PADDING_STRIDE == 0)
+    {
+        stride += LFFT_FFT2_PADDING/sizeof(int32_t);
+    }
+
+    return stride;
+}
+
+static void _lfft_fft2_transpose(const int32_t source[], uint32_t source_stride, int32_t destination[],
+        uint32_t destination_stride, uint16_t rows, uint16_t columns, const uint32_t * switching_table)
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t k;
+    uint32_t l;
+    uint32_t row_end;
+    uint32_t column_end;
+    const int32_t * source_row;
+
+    // a block of LFFT_FFT2_TILE source rows and LFFT_FFT2_TILE destination
+    // rows stays in the cache, every source row is read in LFFT_FFT2_TILE
+    // contiguous elements
+    for(i = 0; i < rows; i += LFFT_FFT2_TILE)
+    {
+        row_end = (i+LFFT_FFT2_TILE < rows) ? i+LFFT_FFT2_TILE : rows;
+        for(j = 0; j < columns; j += LFFT_FFT2_TILE)
+        {
+            column_end = (j+LFFT_FFT2_TILE < columns) ? j+LFFT_FFT2_TILE : columns;
+            for(k = i; k < row_end; k++)
+            {
+                source_row = &source[(size_t) ((switching_table == NULL) ? k : switching_table[k])*source_stride];
+                for(l = j; l < column_end; l++)
+                {
+                    destination[(size_t) l*destination_stride+k] = source_row[l];
+                }
+            }
+        }
+    }
+}
+
+static void _lfft_rfft2(lfft_Fft2 * fft2, int32_t ** real)
+{
+    uint16_t i;
+    uint16_t j;
+    uint32_t n;
+
+    // the even samples are packed into the real part, the odd samples into
+    // the imaginary part, see _lfft_rfft_pack()
+    for(i = 0; i < fft2->rows; i++)
+    {
+        for(j = 0; j < fft2->columns/2; j++)
+        {
+            n = fft2->fft_rows->switching_table[2*j]<<1;
+            fft2->result_real[i][j] = real[i][n]<<LFFT_RHS_BITS;
+            fft2->result_imag[i][j] = real[i][n+1]<<LFFT_RHS_BITS;
+        }
+    }
+}
+
+static void _lfft_rfft2_float(lfft_Fft2 * fft2, float ** real)
+{
+    uint16_t i;
+    uint16_t j;
+    uint32_t n;
+
+    // the even samples are packed into the real part, the odd samples into
+    // the imaginary part, see _lfft_rfft_pack()
+    for(i = 0; i < fft2->rows; i++)
+    {
+        for(j = 0; j < fft2->columns/2; j++)
+        {
+            n = fft2->fft_rows->switching_table[2*j]<<1;
+            fft2->result_real[i][j] = (int32_t) (real[i][n]*(1<<LFFT_RHS_BITS));
+            fft2->result_imag[i][j] = (int32_t) (real[i][n+1]*(1<<LFFT_RHS_BITS));
+        }
+    }
+}
+
+static bool _lfft_fft2_is_real(const lfft_Fft2 * fft2)
+{
+    // the packing of the real row ffts needs an even number of samples,
+    // see lfft_rfft()
+    return (fft2->columns >= 2)&&(!(fft2->columns&(fft2->columns-1)));
+}
+
+static void _lfft_fft2_columns(lfft_Fft2 * fft2, uint16_t columns, bool calculate_ifft2)
+{
+    uint16_t i;
+
+    // rotate the result and switch the values, so the columns are
+    // contiguous and reordered
+    //   input data     rotated data   rotated and switched data
+    //   |00 01 02 03|  |00 10 20 30|  |00 10 20 30|
+    //   |10 11 12 13|  |01 11 21 31|  |02 12 22 32|
+    //   |20 21 22 23|  |02 12 22 32|  |01 11 21 31|
+    //   |30 31 32 33|  |03 13 23 33|  |03 13 23 33|
+    _lfft_fft2_transpose(fft2->data_real, fft2->stride, fft2->result_real_temp, fft2->stride_temp,
+            fft2->rows, columns, fft2->fft_columns->switching_table);
+    _lfft_fft2_transpose(fft2->data_imag, fft2->stride, fft2->result_imag_temp, fft2->stride_temp,
+            fft2->rows, columns, fft2->fft_columns->switching_table);
+
+    for(i = 0; i < columns; i++)
+    {
+        _lfft_fft_calculation_buffer(fft2->fft_columns, &fft2->result_real_temp[(size_t) i*fft2->stride_temp],
+                &fft2->result_imag_temp[(size_t) i*fft2->stride_temp], calculate_ifft2, fft2->fft_columns->workspace);
+    }
+
+    // rotate the result back
+    _lfft_fft2_transpose(fft2->result_real_temp, fft2->stride_temp, fft2->data_real, fft2->stride,
+            columns, fft2->rows, NULL);
+    _lfft_fft2_transpose(fft2->result_imag_temp, fft2->stride_temp, fft2->data_imag, fft2->stride,
+            columns, fft2->rows, NULL);
+}
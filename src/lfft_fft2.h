@@ -48,15 +48,34 @@ extern "C" {
 #include "lfft_config.h"
 #include "lfft_fft.h"
 
+/*!
+ * number of rows and columns of the blocks of the transpositions of
+ * _lfft_fft2_calculation()
+ */
+#define LFFT_FFT2_TILE 32
+
+/*!
+ * rows of which the size is a multiple of LFFT_FFT2_PADDING_STRIDE bytes are
+ * extended by LFFT_FFT2_PADDING bytes, so the rows of a block of a
+ * transposition don't map to the same cache sets
+ */
+#define LFFT_FFT2_PADDING_STRIDE 512
+#define LFFT_FFT2_PADDING 64
+
 typedef struct _lfft_Fft2
 {
     uint16_t rows; //!< number of rows
     uint16_t columns; //!< number of columns
 
-    int32_t ** result_real_temp; //!< real result
-    int32_t ** result_imag_temp; //!< imaginary result
-    int32_t ** result_real; //!< temporary real data
-    int32_t ** result_imag; //!< temporary imaginary data
+    void * memory; //!< single allocation of the row pointers and the data
+    int32_t ** result_real; //!< real result; pointers to the rows of data_real
+    int32_t ** result_imag; //!< imaginary result; pointers to the rows of data_imag
+    uint32_t stride; //!< distance of two rows of data_real and data_imag in elements
+    uint32_t stride_temp; //!< distance of two rows of result_real_temp and result_imag_temp in elements
+    int32_t * data_real; //!< contiguous real result; rows rows with stride elements aligned to LFFT_ALIGNMENT bytes
+    int32_t * data_imag; //!< contiguous imaginary result; rows rows with stride elements aligned to LFFT_ALIGNMENT bytes
+    int32_t * result_real_temp; //!< transposed temporary real data; columns rows with stride_temp elements
+    int32_t * result_imag_temp; //!< transposed temporary imaginary data; columns rows with stride_temp elements
 
     lfft_Fft * fft_rows; //!< fft to calculate the fft in a row
     lfft_Fft * fft_columns; //!< fft to calculate the fft in a column
@@ -68,7 +87,7 @@ typedef struct _lfft_Fft2
  * \param fft2 pointer to struct to be initialized
  * \param rows number of rows of the data
  * \param columns number of columns of the data
- * \return 0: successful 1: rows or columns is not to the power of 2
+ * \return 0: successful 1: rows or columns is 0 3: not enough memory
  */
 lfft_errno lfft_fft2_new(lfft_Fft2 * fft2, uint16_t rows, uint16_t columns);
 
@@ -146,6 +165,54 @@ void lfft_ifft2_float(lfft_Fft2 * fft2, float ** real);
  */
 void lfft_ifft2_complex_float(lfft_Fft2 * fft2, float ** real, float ** imag);
 
+/*!
+ * Calculates the 2D-fft of real input data.
+ * The rows are calculated with real ffts of half the size, see lfft_rfft(),
+ * the columns only for the columns/2+1 non-redundant columns of their result.
+ * Only the columns 0..columns/2 of the result are valid, the remaining
+ * elements are X[i][j] = conj(X[(rows-i)%rows][columns-j]).
+ * If columns is not to the power of 2, the complete 2D-fft is calculated.
+ * \param fft2 initialized lfft_Fft2 struct
+ * \param real 2D-real input data for fft.
+ */
+void lfft_rfft2(lfft_Fft2 * fft2, int32_t ** real);
+
+/*!
+ * Calculates the 2D-fft of real input data.
+ * The rows are calculated with real ffts of half the size, see lfft_rfft(),
+ * the columns only for the columns/2+1 non-redundant columns of their result.
+ * Only the columns 0..columns/2 of the result are valid, the remaining
+ * elements are X[i][j] = conj(X[(rows-i)%rows][columns-j]).
+ * If columns is not to the power of 2, the complete 2D-fft is calculated.
+ * \param fft2 initialized lfft_Fft2 struct
+ * \param real 2D-real input data for fft.
+ */
+void lfft_rfft2_float(lfft_Fft2 * fft2, float ** real);
+
+/*!
+ * Calculates the 2D-inverse-fft of the spectrum of real data, the inverse of
+ * lfft_rfft2().
+ * Only the columns 0..columns/2 of the input data are read, the remaining
+ * elements are X[i][j] = conj(X[(rows-i)%rows][columns-j]).
+ * The real result has columns columns, the imaginary result is 0.
+ * \param fft2 initialized lfft_Fft2 struct
+ * \param real 2D-real input data with at least columns/2+1 columns.
+ * \param imag 2D-imaginary input data with at least columns/2+1 columns.
+ */
+void lfft_irfft2(lfft_Fft2 * fft2, int32_t ** real, int32_t ** imag);
+
+/*!
+ * Calculates the 2D-inverse-fft of the spectrum of real data, the inverse of
+ * lfft_rfft2_float().
+ * Only the columns 0..columns/2 of the input data are read, the remaining
+ * elements are X[i][j] = conj(X[(rows-i)%rows][columns-j]).
+ * The real result has columns columns, the imaginary result is 0.
+ * \param fft2 initialized lfft_Fft2 struct
+ * \param real 2D-real input data with at least columns/2+1 columns.
+ * \param imag 2D-imaginary input data with at least columns/2+1 columns.
+ */
+void lfft_irfft2_float(lfft_Fft2 * fft2, float ** real, float ** imag);
+
 /*!
  * Returns an element of the real part of the 2D-fft
  * \param fft2 initialized lfft_Fft2 struct
@@ -153,7 +220,7 @@ void lfft_ifft2_complex_float(lfft_Fft2 * fft2, float ** real, float ** imag);
  * \param column column of the requested element
  * \return real result of the 2D-fft
  */
-int32_t lfft_fft2_result_real_at(lfft_Fft2 * fft2, uint16_t row, uint16_t column);
+int32_t lfft_fft2_result_real_at(const lfft_Fft2 * fft2, uint16_t row, uint16_t column);
 
 /*!
  * Returns an element of the imaginary part of the 2D-fft
@@ -162,7 +229,7 @@ int32_t lfft_fft2_result_real_at(lfft_Fft2 * fft2, uint16_t row, uint16_t column
  * \param column column of the requested element
  * \return imaginary result of the 2D-fft
  */
-int32_t lfft_fft2_result_imag_at(lfft_Fft2 * fft2, uint16_t row, uint16_t column);
+int32_t lfft_fft2_result_imag_at(const lfft_Fft2 * fft2, uint16_t row, uint16_t column);
 
 /*!
  * Returns an element of the real part of the 2D-fft
@@ -171,7 +238,7 @@ int32_t lfft_fft2_result_imag_at(lfft_Fft2 * fft2, uint16_t row, uint16_t column
  * \param column column of the requested element
  * \return real result of the 2D-fft
  */
-float lfft_fft2_result_real_float_at(lfft_Fft2 * fft2, uint16_t row, uint16_t column);
+float lfft_fft2_result_real_float_at(const lfft_Fft2 * fft2, uint16_t row, uint16_t column);
 
 /*!
  * Returns an element of the imaginary part of the 2D-fft
@@ -180,10 +247,13 @@ float lfft_fft2_result_real_float_at(lfft_Fft2 * fft2, uint16_t row, uint16_t co
  * \param column column of the requested element
  * \return imaginary result of the 2D-fft
  */
-float lfft_fft2_result_imag_float_at(lfft_Fft2 * fft2, uint16_t row, uint16_t column);
+float lfft_fft2_result_imag_float_at(const lfft_Fft2 * fft2, uint16_t row, uint16_t column);
 
 /*!
  * Calculates the base algorithm of the 2D-fft.
+ * The rows are transformed in place, the columns are transformed in the
+ * transposed temporary data; both transpositions are calculated in blocks of
+ * LFFT_FFT2_TILE rows and columns.
  * You have to reorder and adjust the input data manually.
  * Don't use this function if it is possible to use the above functions.
  * \param fft2 initialized lfft_Fft2 struct
@@ -191,6 +261,26 @@ float lfft_fft2_result_imag_float_at(lfft_Fft2 * fft2, uint16_t row, uint16_t co
  */
 void _lfft_fft2_calculation(lfft_Fft2 * fft2, bool calculate_ifft2);
 
+/*!
+ * Calculates the base algorithm of the 2D-fft of real input data.
+ * The packed input data of the real row ffts has to be in the rows, see
+ * _lfft_rfft_calculation(). Afterwards the columns 0..columns/2 are valid.
+ * columns has to be to the power of 2 and at least 2.
+ * Don't use this function if it is possible to use the above functions.
+ * \param fft2 initialized lfft_Fft2 struct
+ */
+void _lfft_rfft2_calculation(lfft_Fft2 * fft2);
+
+/*!
+ * Calculates the base algorithm of the 2D-ifft of the spectrum of real data.
+ * The columns 0..columns/2 of the spectrum have to be in natural order and
+ * have to have LFFT_RHS_BITS decimal places. Afterwards the rows contain the
+ * real result and the imaginary result is 0.
+ * Don't use this function if it is possible to use the above functions.
+ * \param fft2 initialized lfft_Fft2 struct
+ */
+void _lfft_irfft2_calculation(lfft_Fft2 * fft2);
+
 #ifdef	__cplusplus
 }
 #endif
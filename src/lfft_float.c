@@ -0,0 +1,524 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains functions to calculate the fft with floating point
+ * values.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#include "lfft_float.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#ifdef LFFT_USE_AVX2
+#include <immintrin.h>
+
+/*!
+ * number of lfft_float values in a 256 bit vector register
+ */
+#ifdef LFFT_USE_DOUBLE
+#define LFFT_FLOAT_LANES 4
+typedef __m256d lfft_float_vector;
+#define _lfft_float_load(address) _mm256_loadu_pd(address)
+#define _lfft_float_store(address, value) _mm256_storeu_pd(address, value)
+#define _lfft_float_add(a, b) _mm256_add_pd(a, b)
+#define _lfft_float_sub(a, b) _mm256_sub_pd(a, b)
+#define _lfft_float_mul(a, b) _mm256_mul_pd(a, b)
+#define _lfft_float_permute(a, b, control) _mm256_permute2f128_pd(a, b, control)
+#else
+#define LFFT_FLOAT_LANES 8
+typedef __m256 lfft_float_vector;
+#define _lfft_float_load(address) _mm256_loadu_ps(address)
+#define _lfft_float_store(address, value) _mm256_storeu_ps(address, value)
+#define _lfft_float_add(a, b) _mm256_add_ps(a, b)
+#define _lfft_float_sub(a, b) _mm256_sub_ps(a, b)
+#define _lfft_float_mul(a, b) _mm256_mul_ps(a, b)
+#define _lfft_float_permute(a, b, control) _mm256_permute2f128_ps(a, b, control)
+#endif /* LFFT_USE_DOUBLE */
+#endif /* LFFT_USE_AVX2 */
+
+/*!
+ * Calculates the fft or ifft into the arrays of fft.
+ * \param fft initialized lfft_Float struct
+ * \param real real input data
+ * \param imag imaginary input data; NULL if the imaginary part is 0
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+static void _lfft_float_fft(lfft_Float * fft, const lfft_float real[], const lfft_float imag[], bool calculate_ifft);
+
+/*!
+ * Calculates the first two steps, which only use the wk values 1 and -j.
+ * \param fft initialized lfft_Float struct; at least 4 samples
+ * \param real real data; replaced by the result of the steps
+ * \param imag imaginary data; replaced by the result of the steps
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+static void _lfft_float_first_steps(const lfft_Float * fft, lfft_float real[], lfft_float imag[], bool calculate_ifft);
+
+/*!
+ * Calculates one radix-2 step.
+ * \param fft initialized lfft_Float struct
+ * \param real real data; replaced by the result of the step
+ * \param imag imaginary data; replaced by the result of the step
+ * \param space space between the operants of the butterflies
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+static void _lfft_float_step(const lfft_Float * fft, lfft_float real[], lfft_float imag[],
+        uint32_t space, bool calculate_ifft);
+
+#ifdef LFFT_USE_AVX2
+/*!
+ * Calculates one radix-2 step with AVX2 instructions.
+ * LFFT_FLOAT_LANES consecutive butterflies of a group are calculated at once.
+ * \param fft initialized lfft_Float struct
+ * \param real real data; replaced by the result of the step
+ * \param imag imaginary data; replaced by the result of the step
+ * \param space space between the operants of the butterflies; at least LFFT_FLOAT_LANES
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+static void _lfft_float_step_avx2(const lfft_Float * fft, lfft_float real[], lfft_float imag[],
+        uint32_t space, bool calculate_ifft);
+
+/*!
+ * Calculates one radix-2 step with less than LFFT_FLOAT_LANES butterflies per
+ * group with AVX2 instructions.
+ * 2*LFFT_FLOAT_LANES samples are loaded and the first and second operants are
+ * separated by shuffling the elements.
+ * \param fft initialized lfft_Float struct; at least 2*LFFT_FLOAT_LANES samples
+ * \param real real data; replaced by the result of the step
+ * \param imag imaginary data; replaced by the result of the step
+ * \param space space between the operants of the butterflies; less than LFFT_FLOAT_LANES
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+static void _lfft_float_step_avx2_small(const lfft_Float * fft, lfft_float real[], lfft_float imag[],
+        uint32_t space, bool calculate_ifft);
+
+/*!
+ * Calculates LFFT_FLOAT_LANES butterflies with AVX2 instructions.
+ * \param real_1 real values of the first operants; replaced by the sums
+ * \param imag_1 imaginary values of the first operants; replaced by the sums
+ * \param real_2 real values of the second operants; replaced by the differences
+ * \param imag_2 imaginary values of the second operants; replaced by the differences
+ * \param wk_real real wk values
+ * \param wk_imag imaginary wk values
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+static void _lfft_float_butterflies_avx2(lfft_float_vector * real_1, lfft_float_vector * imag_1,
+        lfft_float_vector * real_2, lfft_float_vector * imag_2,
+        lfft_float_vector wk_real, lfft_float_vector wk_imag, bool calculate_ifft);
+#endif /* LFFT_USE_AVX2 */
+
+lfft_errno lfft_float_new(lfft_Float * fft, uint32_t samples)
+{
+    uint32_t i;
+    uint32_t half;
+    double angle;
+
+    // samples is not to the power of 2
+    if((samples == 0)||(samples&(samples-1)))
+    {
+        return 1;
+    }
+
+    fft->plan = lfft_plan_acquire(samples);
+    if(fft->plan == NULL)
+    {
+        return 3;
+    }
+
+    fft->samples = samples;
+    fft->steps   = fft->plan->steps;
+
+    // allocate memory
+    fft->wk_real     = (lfft_float *) calloc(samples, sizeof(lfft_float));
+    fft->wk_imag     = (lfft_float *) calloc(samples, sizeof(lfft_float));
+    fft->result_real = (lfft_float *) calloc(samples, sizeof(lfft_float));
+    fft->result_imag = (lfft_float *) calloc(samples, sizeof(lfft_float));
+
+    if((fft->wk_real == NULL)||(fft->wk_imag == NULL)||(fft->result_real == NULL)||(fft->result_imag == NULL))
+    {
+        lfft_float_delete(fft);
+        return 3;
+    }
+
+    // wk = e^(-j*2*pi*k/(2*half)), calculated with double precision
+    for(half = 1; half < samples; half <<= 1)
+    {
+        for(i = 0; i < half; i++)
+        {
+            angle = (M_PI*i)/half;
+            fft->wk_real[half+i] = (lfft_float) cos(angle);
+            fft->wk_imag[half+i] = (lfft_float) -sin(angle);
+        }
+    }
+
+    return 0;
+}
+
+void lfft_float_delete(lfft_Float * fft)
+{
+    lfft_plan_release(fft->plan);
+    free(fft->wk_real);
+    free(fft->wk_imag);
+    free(fft->result_real);
+    free(fft->result_imag);
+}
+
+void lfft_float_fft(lfft_Float * fft, const lfft_float real[])
+{
+    _lfft_float_fft(fft, real, NULL, false);
+}
+
+void lfft_float_fft_complex(lfft_Float * fft, const lfft_float real[], const lfft_float imag[])
+{
+    _lfft_float_fft(fft, real, imag, false);
+}
+
+void lfft_float_ifft(lfft_Float * fft, const lfft_float real[])
+{
+    _lfft_float_fft(fft, real, NULL, true);
+}
+
+void lfft_float_ifft_complex(lfft_Float * fft, const lfft_float real[], const lfft_float imag[])
+{
+    _lfft_float_fft(fft, real, imag, true);
+}
+
+void _lfft_float_calculation(const lfft_Float * fft, lfft_float real[], lfft_float imag[], bool calculate_ifft)
+{
+    uint32_t i;
+    uint32_t space = 1;
+    lfft_float factor;
+
+#ifdef LFFT_USE_AVX2
+    if(fft->samples >= 2*LFFT_FLOAT_LANES)
+    {
+        for(; space < LFFT_FLOAT_LANES; space <<= 1)
+        {
+            _lfft_float_step_avx2_small(fft, real, imag, space, calculate_ifft);
+        }
+    }
+#endif /* LFFT_USE_AVX2 */
+
+    if((space == 1)&&(fft->steps >= 2))
+    {
+        _lfft_float_first_steps(fft, real, imag, calculate_ifft);
+        space = 4;
+    }
+
+    for(; space < fft->samples; space <<= 1)
+    {
+#ifdef LFFT_USE_AVX2
+        if(space >= LFFT_FLOAT_LANES)
+        {
+            _lfft_float_step_avx2(fft, real, imag, space, calculate_ifft);
+        }
+        else
+#endif /* LFFT_USE_AVX2 */
+        {
+            _lfft_float_step(fft, real, imag, space, calculate_ifft);
+        }
+    }
+
+    if(calculate_ifft)
+    {
+        // divide the results by the fft size (fft->samples)
+        factor = ((lfft_float) 1)/fft->samples;
+        for(i = 0; i < fft->samples; i++)
+        {
+            real[i] *= factor;
+            imag[i] *= factor;
+        }
+    }
+}
+
+static void _lfft_float_fft(lfft_Float * fft, const lfft_float real[], const lfft_float imag[], bool calculate_ifft)
+{
+    uint32_t i;
+
+    // reorder the input data
+    for(i = 0; i < fft->samples; i++)
+    {
+        fft->result_real[i] = real[fft->plan->switching_table[i]];
+    }
+    for(i = 0; i < fft->samples; i++)
+    {
+        fft->result_imag[i] = (imag == NULL) ? 0 : imag[fft->plan->switching_table[i]];
+    }
+
+    _lfft_float_calculation(fft, fft->result_real, fft->result_imag, calculate_ifft);
+}
+
+static void _lfft_float_first_steps(const lfft_Float * fft, lfft_float real[], lfft_float imag[], bool calculate_ifft)
+{
+    uint32_t j;
+
+    // temporary variables
+    lfft_float real_0;
+    lfft_float imag_0;
+    lfft_float real_1;
+    lfft_float imag_1;
+    lfft_float real_2;
+    lfft_float imag_2;
+    lfft_float real_3;
+    lfft_float imag_3;
+
+    for(j = 0; j < fft->samples; j += 4)
+    {
+        // first step, wk = 1
+        real_0 = real[j]+real[j+1];
+        imag_0 = imag[j]+imag[j+1];
+        real_1 = real[j]-real[j+1];
+        imag_1 = imag[j]-imag[j+1];
+        real_2 = real[j+2]+real[j+3];
+        imag_2 = imag[j+2]+imag[j+3];
+        real_3 = real[j+2]-real[j+3];
+        imag_3 = imag[j+2]-imag[j+3];
+
+        // second step, wk = 1 and wk = -j (j for ifft)
+        real[j] = real_0+real_2;
+        imag[j] = imag_0+imag_2;
+        real[j+2] = real_0-real_2;
+        imag[j+2] = imag_0-imag_2;
+        if(calculate_ifft)
+        {
+            real[j+1] = real_1-imag_3;
+            imag[j+1] = imag_1+real_3;
+            real[j+3] = real_1+imag_3;
+            imag[j+3] = imag_1-real_3;
+        }
+        else
+        {
+            real[j+1] = real_1+imag_3;
+            imag[j+1] = imag_1-real_3;
+            real[j+3] = real_1-imag_3;
+            imag[j+3] = imag_1+real_3;
+        }
+    }
+}
+
+static void _lfft_float_step(const lfft_Float * fft, lfft_float real[], lfft_float imag[],
+        uint32_t space, bool calculate_ifft)
+{
+    uint32_t j;
+    uint32_t k;
+    const lfft_float * wk_real = &fft->wk_real[space];
+    const lfft_float * wk_imag = &fft->wk_imag[space];
+    // -sin(x) == sin(-x)
+    lfft_float wk_sign = calculate_ifft ? -1 : 1;
+
+    // temporary variables
+    lfft_float real_wk;
+    lfft_float imag_wk;
+    lfft_float wk_imag_k;
+
+    for(j = 0; j < fft->samples; j += 2*space)
+    {
+        for(k = 0; k < space; k++)
+        {
+            wk_imag_k = wk_sign*wk_imag[k];
+
+            real_wk = real[j+k+space]*wk_real[k]-imag[j+k+space]*wk_imag_k;
+            imag_wk = imag[j+k+space]*wk_real[k]+real[j+k+space]*wk_imag_k;
+
+            real[j+k+space] = real[j+k]-real_wk;
+            imag[j+k+space] = imag[j+k]-imag_wk;
+            real[j+k] = real[j+k]+real_wk;
+            imag[j+k] = imag[j+k]+imag_wk;
+        }
+    }
+}
+
+#ifdef LFFT_USE_AVX2
+static void _lfft_float_step_avx2(const lfft_Float * fft, lfft_float real[], lfft_float imag[],
+        uint32_t space, bool calculate_ifft)
+{
+    uint32_t j;
+    uint32_t k;
+
+    lfft_float_vector real_1;
+    lfft_float_vector imag_1;
+    lfft_float_vector real_2;
+    lfft_float_vector imag_2;
+
+    for(j = 0; j < fft->samples; j += 2*space)
+    {
+        for(k = 0; k < space; k += LFFT_FLOAT_LANES)
+        {
+            real_1 = _lfft_float_load(&real[j+k]);
+            imag_1 = _lfft_float_load(&imag[j+k]);
+            real_2 = _lfft_float_load(&real[j+k+space]);
+            imag_2 = _lfft_float_load(&imag[j+k+space]);
+
+            _lfft_float_butterflies_avx2(&real_1, &imag_1, &real_2, &imag_2,
+                    _lfft_float_load(&fft->wk_real[space+k]), _lfft_float_load(&fft->wk_imag[space+k]), calculate_ifft);
+
+            _lfft_float_store(&real[j+k], real_1);
+            _lfft_float_store(&imag[j+k], imag_1);
+            _lfft_float_store(&real[j+k+space], real_2);
+            _lfft_float_store(&imag[j+k+space], imag_2);
+        }
+    }
+}
+
+static void _lfft_float_step_avx2_small(const lfft_Float * fft, lfft_float real[], lfft_float imag[],
+        uint32_t space, bool calculate_ifft)
+{
+    uint32_t j;
+    uint32_t k;
+    lfft_float wk_real_values[LFFT_FLOAT_LANES];
+    lfft_float wk_imag_values[LFFT_FLOAT_LANES];
+
+    lfft_float_vector real_1;
+    lfft_float_vector imag_1;
+    lfft_float_vector real_2;
+    lfft_float_vector imag_2;
+    lfft_float_vector real_3;
+    lfft_float_vector imag_3;
+    lfft_float_vector wk_real;
+    lfft_float_vector wk_imag;
+
+    // the element k of every group uses the same wk value
+    for(k = 0; k < LFFT_FLOAT_LANES; k++)
+    {
+        wk_real_values[k] = fft->wk_real[space+(k&(space-1))];
+        wk_imag_values[k] = fft->wk_imag[space+(k&(space-1))];
+    }
+    wk_real = _lfft_float_load(wk_real_values);
+    wk_imag = _lfft_float_load(wk_imag_values);
+
+    for(j = 0; j < fft->samples; j += 2*LFFT_FLOAT_LANES)
+    {
+        real_1 = _lfft_float_load(&real[j]);
+        imag_1 = _lfft_float_load(&imag[j]);
+        real_3 = _lfft_float_load(&real[j+LFFT_FLOAT_LANES]);
+        imag_3 = _lfft_float_load(&imag[j+LFFT_FLOAT_LANES]);
+
+        // separate the first and the second operants
+        if(2*space == LFFT_FLOAT_LANES)
+        {
+            real_2 = _lfft_float_permute(real_1, real_3, 0x31);
+            imag_2 = _lfft_float_permute(imag_1, imag_3, 0x31);
+            real_1 = _lfft_float_permute(real_1, real_3, 0x20);
+            imag_1 = _lfft_float_permute(imag_1, imag_3, 0x20);
+        }
+#ifndef LFFT_USE_DOUBLE
+        else if(space == 2)
+        {
+            real_2 = _mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(real_1), _mm256_castps_pd(real_3)));
+            imag_2 = _mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(imag_1), _mm256_castps_pd(imag_3)));
+            real_1 = _mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(real_1), _mm256_castps_pd(real_3)));
+            imag_1 = _mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(imag_1), _mm256_castps_pd(imag_3)));
+        }
+        else
+        {
+            real_2 = _mm256_shuffle_ps(real_1, real_3, _MM_SHUFFLE(3, 1, 3, 1));
+            imag_2 = _mm256_shuffle_ps(imag_1, imag_3, _MM_SHUFFLE(3, 1, 3, 1));
+            real_1 = _mm256_shuffle_ps(real_1, real_3, _MM_SHUFFLE(2, 0, 2, 0));
+            imag_1 = _mm256_shuffle_ps(imag_1, imag_3, _MM_SHUFFLE(2, 0, 2, 0));
+        }
+#else
+        else
+        {
+            real_2 = _mm256_unpackhi_pd(real_1, real_3);
+            imag_2 = _mm256_unpackhi_pd(imag_1, imag_3);
+            real_1 = _mm256_unpacklo_pd(real_1, real_3);
+            imag_1 = _mm256_unpacklo_pd(imag_1, imag_3);
+        }
+#endif /* LFFT_USE_DOUBLE */
+
+        _lfft_float_butterflies_avx2(&real_1, &imag_1, &real_2, &imag_2, wk_real, wk_imag, calculate_ifft);
+
+        // restore the order of the elements
+        if(2*space == LFFT_FLOAT_LANES)
+        {
+            real_3 = _lfft_float_permute(real_1, real_2, 0x31);
+            imag_3 = _lfft_float_permute(imag_1, imag_2, 0x31);
+            real_1 = _lfft_float_permute(real_1, real_2, 0x20);
+            imag_1 = _lfft_float_permute(imag_1, imag_2, 0x20);
+        }
+#ifndef LFFT_USE_DOUBLE
+        else if(space == 2)
+        {
+            real_3 = _mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(real_1), _mm256_castps_pd(real_2)));
+            imag_3 = _mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(imag_1), _mm256_castps_pd(imag_2)));
+            real_1 = _mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(real_1), _mm256_castps_pd(real_2)));
+            imag_1 = _mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(imag_1), _mm256_castps_pd(imag_2)));
+        }
+        else
+        {
+            real_3 = _mm256_unpackhi_ps(real_1, real_2);
+            imag_3 = _mm256_unpackhi_ps(imag_1, imag_2);
+            real_1 = _mm256_unpacklo_ps(real_1, real_2);
+            imag_1 = _mm256_unpacklo_ps(imag_1, imag_2);
+        }
+#else
+        else
+        {
+            real_3 = _mm256_unpackhi_pd(real_1, real_2);
+            imag_3 = _mm256_unpackhi_pd(imag_1, imag_2);
+            real_1 = _mm256_unpacklo_pd(real_1, real_2);
+            imag_1 = _mm256_unpacklo_pd(imag_1, imag_2);
+        }
+#endif /* LFFT_USE_DOUBLE */
+
+        _lfft_float_store(&real[j], real_1);
+        _lfft_float_store(&imag[j], imag_1);
+        _lfft_float_store(&real[j+LFFT_FLOAT_LANES], real_3);
+        _lfft_float_store(&imag[j+LFFT_FLOAT_LANES], imag_3);
+    }
+}
+
+static void _lfft_float_butterflies_avx2(lfft_float_vector * real_1, lfft_float_vector * imag_1,
+        lfft_float_vector * real_2, lfft_float_vector * imag_2,
+        lfft_float_vector wk_real, lfft_float_vector wk_imag, bool calculate_ifft)
+{
+    lfft_float_vector real_wk;
+    lfft_float_vector imag_wk;
+
+    // ifft uses the conjugated wk values
+    if(calculate_ifft)
+    {
+        real_wk = _lfft_float_add(_lfft_float_mul(*real_2, wk_real), _lfft_float_mul(*imag_2, wk_imag));
+        imag_wk = _lfft_float_sub(_lfft_float_mul(*imag_2, wk_real), _lfft_float_mul(*real_2, wk_imag));
+    }
+    else
+    {
+        real_wk = _lfft_float_sub(_lfft_float_mul(*real_2, wk_real), _lfft_float_mul(*imag_2, wk_imag));
+        imag_wk = _lfft_float_add(_lfft_float_mul(*imag_2, wk_real), _lfft_float_mul(*real_2, wk_imag));
+    }
+
+    *real_2 = _lfft_float_sub(*real_1, real_wk);
+    *imag_2 = _lfft_float_sub(*imag_1, imag_wk);
+    *real_1 = _lfft_float_add(*real_1, real_wk);
+    *imag_1 = _lfft_float_add(*imag_1, imag_wk);
+}
+#endif /* LFFT_USE_AVX2 */
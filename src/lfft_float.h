@@ -0,0 +1,141 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains functions to calculate the fft with floating point
+ * values.
+ * The lfft_Float struct uses the same plans as the lfft_Fft struct, but the
+ * wk values, the input and the result are float values, so there is no
+ * conversion to fixed point and no loss of precision. Define LFFT_USE_DOUBLE
+ * to calculate with double values.
+ * With AVX2 (see LFFT_USE_AVX2) the butterflies of a vector register are
+ * calculated at once.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#ifndef _LFFT_FLOAT_H
+#define _LFFT_FLOAT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lfft_config.h"
+#include "lfft_fft.h"
+
+/*!
+ * floating point type of the lfft_Float struct
+ * define LFFT_USE_DOUBLE to use double instead of float
+ */
+#ifdef LFFT_USE_DOUBLE
+typedef double lfft_float;
+#else
+typedef float lfft_float;
+#endif /* LFFT_USE_DOUBLE */
+
+typedef struct _lfft_Float
+{
+    uint32_t     samples; //!< number of samples
+    uint8_t      steps; //!< number of steps
+
+    lfft_Plan  * plan; //!< plan shared by all lfft_Fft structs with the same number of samples
+    lfft_float * wk_real; //!< real wk values of every step; step half starts at element half
+    lfft_float * wk_imag; //!< imaginary wk values of every step; step half starts at element half
+
+    lfft_float * result_real; //!< array where the real part of the result is saved
+    lfft_float * result_imag; //!< array where the imaginary part of the result is saved
+} lfft_Float;
+
+/*!
+ * Initializes the floating point fft.
+ * \param fft pointer to struct to be initialized
+ * \param samples number of input samples; must be to the power of 2
+ * \return 0: successful 1: samples is not to the power of 2 3: not enough memory
+ */
+lfft_errno lfft_float_new(lfft_Float * fft, uint32_t samples);
+
+/*!
+ * Deallocate the used memory.
+ * \param fft initialized lfft_Float struct
+ */
+void lfft_float_delete(lfft_Float * fft);
+
+/*!
+ * Calculates the fft.
+ * It uses only real input data, the imaginary part is set to 0.
+ * The result is saved in fft->result_real and fft->result_imag.
+ * \param fft initialized lfft_Float struct
+ * \param real real input data for fft
+ */
+void lfft_float_fft(lfft_Float * fft, const lfft_float real[]);
+
+/*!
+ * Calculates the fft.
+ * It uses real input and imaginary input data.
+ * The result is saved in fft->result_real and fft->result_imag.
+ * \param fft initialized lfft_Float struct
+ * \param real real input data for fft
+ * \param imag imaginary input data for fft
+ */
+void lfft_float_fft_complex(lfft_Float * fft, const lfft_float real[], const lfft_float imag[]);
+
+/*!
+ * Calculates the inverse-fft.
+ * It uses only real input data, the imaginary part is set to 0.
+ * The result is saved in fft->result_real and fft->result_imag.
+ * \param fft initialized lfft_Float struct
+ * \param real real input data for ifft
+ */
+void lfft_float_ifft(lfft_Float * fft, const lfft_float real[]);
+
+/*!
+ * Calculates the inverse-fft.
+ * It uses real input and imaginary input data.
+ * The result is saved in fft->result_real and fft->result_imag.
+ * \param fft initialized lfft_Float struct
+ * \param real real input data for ifft
+ * \param imag imaginary input data for ifft
+ */
+void lfft_float_ifft_complex(lfft_Float * fft, const lfft_float real[], const lfft_float imag[]);
+
+/*!
+ * Calculates the butterflies of reordered data.
+ * Don't use this function if it is possible to use the above functions.
+ * \param fft initialized lfft_Float struct
+ * \param real reordered real data; replaced by the real result
+ * \param imag reordered imaginary data; replaced by the imaginary result
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+void _lfft_float_calculation(const lfft_Float * fft, lfft_float real[], lfft_float imag[], bool calculate_ifft);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LFFT_FLOAT_H */
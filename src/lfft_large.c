@@ -0,0 +1,334 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains functions to calculate large ffts with the six-step
+ * algorithm. The fft with samples = samples_1*samples_2 elements is split
+ * into samples_1 ffts with samples_2 elements, a multiplication with twiddle
+ * factors and samples_2 ffts with samples_1 elements. The data is transposed
+ * between the steps, so every small fft works on contiguous data which fits
+ * into the cache. Only tables for the small ffts and two twiddle tables with
+ * about 2*sqrt(samples) elements are needed.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#include "lfft_large.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+/*!
+ * decimal places of the twiddle tables
+ */
+#define LFFT_LARGE_TWIDDLE_BITS 30
+
+/*!
+ * Calculates the fft or ifft with all passes.
+ * \param large initialized lfft_Large struct
+ * \param real real input data
+ * \param imag imaginary input data; NULL if the imaginary part is 0
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+static void _lfft_large_fft(lfft_Large * large, const int32_t real[], const int32_t imag[], bool calculate_ifft);
+
+/*!
+ * Transposes and calculates the ffts with samples_2 elements of the rows
+ * first to first+rows-1 of pass 0 and multiplies them with the twiddle factors.
+ * \param large initialized lfft_Large struct
+ * \param first first row, smaller than samples_1
+ * \param rows number of rows
+ * \param real real input data
+ * \param imag imaginary input data; NULL if the imaginary part is 0
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+static void _lfft_large_pass_0(const lfft_Large * large, uint32_t first, uint32_t rows,
+        const int32_t real[], const int32_t imag[], bool calculate_ifft);
+
+/*!
+ * Transposes and calculates the ffts with samples_1 elements of the rows
+ * first to first+rows-1 of pass 1 and transposes them into the result.
+ * \param large initialized lfft_Large struct
+ * \param first first row, smaller than samples_2
+ * \param rows number of rows, at most LFFT_LARGE_BLOCK
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ * \param workspace array with LFFT_LARGE_WORKSPACE(large) elements
+ */
+static void _lfft_large_pass_1(const lfft_Large * large, uint32_t first, uint32_t rows,
+        bool calculate_ifft, int32_t workspace[]);
+
+/*!
+ * Calculates the twiddle factor e^(-j*2*pi*n/samples) with LFFT_RHS_BITS
+ * decimal places from the fine and the coarse table.
+ * \param large initialized lfft_Large struct
+ * \param n exponent, smaller than large->samples
+ * \param wk_real the real twiddle factor is stored here
+ * \param wk_imag the imaginary twiddle factor is stored here
+ */
+static void _lfft_large_twiddle(const lfft_Large * large, uint32_t n, int32_t * wk_real, int32_t * wk_imag);
+
+lfft_errno lfft_large_new(lfft_Large * large, uint32_t samples)
+{
+    uint32_t i;
+    double angle;
+
+    // samples is not to the power of 2 or too small to be split
+    if((samples < 4)||(samples&(samples-1)))
+    {
+        return 1;
+    }
+
+    large->samples = samples;
+    large->steps = 0;
+    while((1UL<<large->steps) < samples)
+    {
+        large->steps++;
+    }
+    // samples_1 <= samples_2, the coarse table has samples_1 elements
+    large->samples_1 = 1UL<<(large->steps/2);
+    large->samples_2 = samples/large->samples_1;
+
+    if(lfft_fft_new(&large->fft_1, large->samples_1))
+    {
+        return 3;
+    }
+    if(lfft_fft_new(&large->fft_2, large->samples_2))
+    {
+        lfft_fft_delete(&large->fft_1);
+        return 3;
+    }
+
+    large->twiddle_fine_real   = (int32_t *) malloc(large->samples_2*sizeof(int32_t));
+    large->twiddle_fine_imag   = (int32_t *) malloc(large->samples_2*sizeof(int32_t));
+    large->twiddle_coarse_real = (int32_t *) malloc(large->samples_1*sizeof(int32_t));
+    large->twiddle_coarse_imag = (int32_t *) malloc(large->samples_1*sizeof(int32_t));
+    large->temp_real   = (int32_t *) malloc(samples*sizeof(int32_t));
+    large->temp_imag   = (int32_t *) malloc(samples*sizeof(int32_t));
+    large->workspace   = (int32_t *) malloc(LFFT_LARGE_WORKSPACE(large)*sizeof(int32_t));
+    large->result_real = (int32_t *) malloc(samples*sizeof(int32_t));
+    large->result_imag = (int32_t *) malloc(samples*sizeof(int32_t));
+
+    if((large->twiddle_fine_real == NULL)||(large->twiddle_fine_imag == NULL)||
+            (large->twiddle_coarse_real == NULL)||(large->twiddle_coarse_imag == NULL)||
+            (large->temp_real == NULL)||(large->temp_imag == NULL)||(large->workspace == NULL)||
+            (large->result_real == NULL)||(large->result_imag == NULL))
+    {
+        lfft_large_delete(large);
+        return 3;
+    }
+
+    // e^(-j*2*pi*n/samples) = fine[n%samples_2]*coarse[n/samples_2]
+    // the tables have more decimal places than the wk values, so the
+    // product of two entries is as exact as one wk value
+    for(i = 0; i < large->samples_2; i++)
+    {
+        angle = (2.0*M_PI*i)/samples;
+        large->twiddle_fine_real[i] = (int32_t) floor(cos(angle)*(1L<<LFFT_LARGE_TWIDDLE_BITS)+0.5);
+        large->twiddle_fine_imag[i] = (int32_t) floor(-sin(angle)*(1L<<LFFT_LARGE_TWIDDLE_BITS)+0.5);
+    }
+    for(i = 0; i < large->samples_1; i++)
+    {
+        angle = (2.0*M_PI*i)/large->samples_1;
+        large->twiddle_coarse_real[i] = (int32_t) floor(cos(angle)*(1L<<LFFT_LARGE_TWIDDLE_BITS)+0.5);
+        large->twiddle_coarse_imag[i] = (int32_t) floor(-sin(angle)*(1L<<LFFT_LARGE_TWIDDLE_BITS)+0.5);
+    }
+
+    return 0;
+}
+
+void lfft_large_delete(lfft_Large * large)
+{
+    lfft_fft_delete(&large->fft_1);
+    lfft_fft_delete(&large->fft_2);
+
+    free(large->twiddle_fine_real);
+    free(large->twiddle_fine_imag);
+    free(large->twiddle_coarse_real);
+    free(large->twiddle_coarse_imag);
+    free(large->temp_real);
+    free(large->temp_imag);
+    free(large->workspace);
+    free(large->result_real);
+    free(large->result_imag);
+}
+
+void lfft_large_fft(lfft_Large * large, const int32_t real[])
+{
+    _lfft_large_fft(large, real, NULL, false);
+}
+
+void lfft_large_fft_complex(lfft_Large * large, const int32_t real[], const int32_t imag[])
+{
+    _lfft_large_fft(large, real, imag, false);
+}
+
+void lfft_large_ifft(lfft_Large * large, const int32_t real[])
+{
+    _lfft_large_fft(large, real, NULL, true);
+}
+
+void lfft_large_ifft_complex(lfft_Large * large, const int32_t real[], const int32_t imag[])
+{
+    _lfft_large_fft(large, real, imag, true);
+}
+
+void _lfft_large_pass(const lfft_Large * large, uint8_t pass, uint32_t first, uint32_t rows,
+        const int32_t real[], const int32_t imag[], bool calculate_ifft, int32_t workspace[])
+{
+    uint32_t block;
+
+    // the rows are calculated in blocks of LFFT_LARGE_BLOCK rows, the
+    // transposes of a block read LFFT_LARGE_BLOCK contiguous elements
+    for(block = first; block < first+rows; block += LFFT_LARGE_BLOCK)
+    {
+        if(pass == 0)
+        {
+            _lfft_large_pass_0(large, block, (first+rows-block < LFFT_LARGE_BLOCK) ? first+rows-block : LFFT_LARGE_BLOCK,
+                    real, imag, calculate_ifft);
+        }
+        else
+        {
+            _lfft_large_pass_1(large, block, (first+rows-block < LFFT_LARGE_BLOCK) ? first+rows-block : LFFT_LARGE_BLOCK,
+                    calculate_ifft, workspace);
+        }
+    }
+}
+
+static void _lfft_large_fft(lfft_Large * large, const int32_t real[], const int32_t imag[], bool calculate_ifft)
+{
+    _lfft_large_pass(large, 0, 0, large->samples_1, real, imag, calculate_ifft, large->workspace);
+    _lfft_large_pass(large, 1, 0, large->samples_2, real, imag, calculate_ifft, large->workspace);
+}
+
+static void _lfft_large_pass_0(const lfft_Large * large, uint32_t first, uint32_t rows,
+        const int32_t real[], const int32_t imag[], bool calculate_ifft)
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t source;
+    int32_t * row_real;
+    int32_t * row_imag;
+    int32_t real_1;
+    int32_t wk_real;
+    int32_t wk_imag;
+
+    // the input is a matrix with samples_2 rows and samples_1 columns;
+    // column i is reordered for the fft and stored in row i of temp
+    for(j = 0; j < large->samples_2; j++)
+    {
+        source = large->fft_2.switching_table[j]*large->samples_1;
+        for(i = first; i < first+rows; i++)
+        {
+            large->temp_real[i*large->samples_2+j] = real[source+i]<<LFFT_RHS_BITS;
+            large->temp_imag[i*large->samples_2+j] = (imag == NULL) ? 0 : imag[source+i]<<LFFT_RHS_BITS;
+        }
+    }
+
+    for(i = first; i < first+rows; i++)
+    {
+        row_real = &large->temp_real[i*large->samples_2];
+        row_imag = &large->temp_imag[i*large->samples_2];
+
+        // fft_1 and fft_2 are radix-2 ffts without a workspace
+        _lfft_fft_calculation_buffer(&large->fft_2, row_real, row_imag, calculate_ifft, NULL);
+
+        // multiply element j of row i with e^(-j*2*pi*i*j/samples); row 0
+        // and column 0 are multiplied with 1
+        if(i == 0)
+        {
+            continue;
+        }
+        for(j = 1; j < large->samples_2; j++)
+        {
+            _lfft_large_twiddle(large, i*j, &wk_real, &wk_imag);
+            // -sin(x) == sin(-x)
+            if(calculate_ifft)
+            {
+                wk_imag = -wk_imag;
+            }
+
+            real_1 = row_real[j];
+            row_real[j] = ((real_1*wk_real)>>LFFT_RHS_BITS)-((row_imag[j]*wk_imag)>>LFFT_RHS_BITS);
+            row_imag[j] = ((row_imag[j]*wk_real)>>LFFT_RHS_BITS)+((real_1*wk_imag)>>LFFT_RHS_BITS);
+        }
+    }
+}
+
+static void _lfft_large_pass_1(const lfft_Large * large, uint32_t first, uint32_t rows,
+        bool calculate_ifft, int32_t workspace[])
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t source;
+    int32_t * block_real = workspace;
+    int32_t * block_imag = &workspace[LFFT_LARGE_BLOCK*large->samples_1];
+
+    // column i of temp is reordered for the fft and stored in row i-first
+    // of the block
+    for(j = 0; j < large->samples_1; j++)
+    {
+        source = large->fft_1.switching_table[j]*large->samples_2;
+        for(i = 0; i < rows; i++)
+        {
+            block_real[i*large->samples_1+j] = large->temp_real[source+first+i];
+            block_imag[i*large->samples_1+j] = large->temp_imag[source+first+i];
+        }
+    }
+
+    for(i = 0; i < rows; i++)
+    {
+        _lfft_fft_calculation_buffer(&large->fft_1, &block_real[i*large->samples_1],
+                &block_imag[i*large->samples_1], calculate_ifft, NULL);
+    }
+
+    // element j of row i is the result at j*samples_2+first+i
+    for(j = 0; j < large->samples_1; j++)
+    {
+        for(i = 0; i < rows; i++)
+        {
+            large->result_real[j*large->samples_2+first+i] = block_real[i*large->samples_1+j];
+            large->result_imag[j*large->samples_2+first+i] = block_imag[i*large->samples_1+j];
+        }
+    }
+}
+
+static void _lfft_large_twiddle(const lfft_Large * large, uint32_t n, int32_t * wk_real, int32_t * wk_imag)
+{
+    // n < samples == samples_1*samples_2, so n/samples_2 < samples_1
+    // n%samples_2 == n&(samples_2-1) and n/samples_2 == n>>fft_2.steps
+    int64_t fine_real   = large->twiddle_fine_real[n&(large->samples_2-1)];
+    int64_t fine_imag   = large->twiddle_fine_imag[n&(large->samples_2-1)];
+    int64_t coarse_real = large->twiddle_coarse_real[n>>large->fft_2.steps];
+    int64_t coarse_imag = large->twiddle_coarse_imag[n>>large->fft_2.steps];
+    // round the product to LFFT_RHS_BITS decimal places
+    const int64_t shift = 2*LFFT_LARGE_TWIDDLE_BITS-LFFT_RHS_BITS;
+    const int64_t half  = ((int64_t) 1)<<(shift-1);
+
+    *wk_real = (int32_t) ((fine_real*coarse_real-fine_imag*coarse_imag+half)>>shift);
+    *wk_imag = (int32_t) ((fine_real*coarse_imag+fine_imag*coarse_real+half)>>shift);
+}
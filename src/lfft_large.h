@@ -0,0 +1,166 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains functions to calculate large ffts with the six-step
+ * algorithm. The fft with samples = samples_1*samples_2 elements is split
+ * into samples_1 ffts with samples_2 elements, a multiplication with twiddle
+ * factors and samples_2 ffts with samples_1 elements. The data is transposed
+ * between the steps, so every small fft works on contiguous data which fits
+ * into the cache. Only tables for the small ffts and two twiddle tables with
+ * about 2*sqrt(samples) elements are needed.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#ifndef _LFFT_LARGE_H
+#define _LFFT_LARGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lfft_config.h"
+#include "lfft_fft.h"
+
+/*!
+ * number of rows which are transposed and calculated together
+ */
+#define LFFT_LARGE_BLOCK 16
+
+/*!
+ * number of int32_t elements of the workspace of _lfft_large_pass()
+ */
+#define LFFT_LARGE_WORKSPACE(large) (2*LFFT_LARGE_BLOCK*(large)->samples_1)
+
+typedef struct _lfft_Large
+{
+    uint32_t samples; //!< number of samples
+    uint8_t  steps; //!< number of steps
+    uint32_t samples_1; //!< number of samples of the ffts of the second pass
+    uint32_t samples_2; //!< number of samples of the ffts of the first pass
+
+    lfft_Fft fft_1; //!< fft with samples_1 elements
+    lfft_Fft fft_2; //!< fft with samples_2 elements
+
+    int32_t * twiddle_fine_real; //!< real twiddle factors e^(-j*2*pi*i/samples), Q30
+    int32_t * twiddle_fine_imag; //!< imaginary twiddle factors e^(-j*2*pi*i/samples), Q30
+    int32_t * twiddle_coarse_real; //!< real twiddle factors e^(-j*2*pi*i*samples_2/samples), Q30
+    int32_t * twiddle_coarse_imag; //!< imaginary twiddle factors e^(-j*2*pi*i*samples_2/samples), Q30
+
+    int32_t * temp_real; //!< real result of the first pass
+    int32_t * temp_imag; //!< imaginary result of the first pass
+    int32_t * workspace; //!< workspace of the second pass
+    int32_t * result_real; //!< real result
+    int32_t * result_imag; //!< imaginary result
+} lfft_Large;
+
+/*!
+ * Initializes the large fft.
+ * The result of the fft has to fit into int32_t with LFFT_RHS_BITS decimal
+ * places like the result of lfft_fft(), so the input of very large ffts has to
+ * be small.
+ * \param large pointer to struct to be initialized
+ * \param samples number of samples; must be to the power of 2 and at least 4
+ * \return 0: successful 1: samples is not to the power of 2 or smaller than 4 3: not enough memory
+ */
+lfft_errno lfft_large_new(lfft_Large * large, uint32_t samples);
+
+/*!
+ * Deallocate the used memory.
+ * \param large initialized lfft_Large struct
+ */
+void lfft_large_delete(lfft_Large * large);
+
+/*!
+ * Calculates the fft.
+ * It uses only real input data, the imaginary part is set to 0.
+ * The result is stored in large->result_real and large->result_imag with
+ * LFFT_RHS_BITS decimal places, see lfft_fft_export().
+ * \param large initialized lfft_Large struct
+ * \param real real input data for fft
+ */
+void lfft_large_fft(lfft_Large * large, const int32_t real[]);
+
+/*!
+ * Calculates the fft.
+ * It uses real input and imaginary input data.
+ * See lfft_large_fft().
+ * \param large initialized lfft_Large struct
+ * \param real real input data for fft
+ * \param imag imaginary input data for fft
+ */
+void lfft_large_fft_complex(lfft_Large * large, const int32_t real[], const int32_t imag[]);
+
+/*!
+ * Calculates the inverse-fft.
+ * It uses only real input data, the imaginary part is set to 0.
+ * See lfft_large_fft().
+ * \param large initialized lfft_Large struct
+ * \param real real input data for ifft
+ */
+void lfft_large_ifft(lfft_Large * large, const int32_t real[]);
+
+/*!
+ * Calculates the inverse-fft.
+ * It uses real input and imaginary input data.
+ * See lfft_large_fft().
+ * \param large initialized lfft_Large struct
+ * \param real real input data for ifft
+ * \param imag imaginary input data for ifft
+ */
+void lfft_large_ifft_complex(lfft_Large * large, const int32_t real[], const int32_t imag[]);
+
+/*!
+ * Calculates a part of a pass of the six-step algorithm.
+ * Pass 0 transposes the input data, calculates the ffts with samples_2
+ * elements and multiplies with the twiddle factors; rows smaller than
+ * samples_1 are available.
+ * Pass 1 transposes the result of pass 0, calculates the ffts with samples_1
+ * elements and transposes the result; rows smaller than samples_2 are
+ * available.
+ * Different rows of one pass can be calculated at the same time, but pass 1
+ * has to wait until pass 0 is finished.
+ * Don't use this function if it is possible to use the above functions.
+ * \param large initialized lfft_Large struct
+ * \param pass 0 or 1
+ * \param first first row
+ * \param rows number of rows
+ * \param real real input data; only used by pass 0
+ * \param imag imaginary input data; only used by pass 0; NULL if the imaginary part is 0
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ * \param workspace array with LFFT_LARGE_WORKSPACE(large) elements; only used by pass 1
+ */
+void _lfft_large_pass(const lfft_Large * large, uint8_t pass, uint32_t first, uint32_t rows,
+        const int32_t real[], const int32_t imag[], bool calculate_ifft, int32_t workspace[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LFFT_LARGE_H */
@@ -0,0 +1,290 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains the fft calculation for sizes which are not to the power
+ * of 2. Sizes which are products of 2, 3, 5 and 7 are calculated with
+ * mixed radix butterflies, all other sizes with the bluestein algorithm.
+ * The functions are called by the functions of lfft_fft.h.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#include "lfft_mixed.h"
+
+#include <stdlib.h>
+
+/*!
+ * maximal radix of the butterflies
+ */
+#define LFFT_MAX_RADIX 7
+
+/*!
+ * Calculates a radix-2 pass of a mixed radix fft.
+ * \param fft initialized lfft_Fft struct with a mixed radix plan
+ * \param real real data; replaced by the real result
+ * \param imag imaginary data; replaced by the imaginary result
+ * \param space space between the operants of a butterfly, product of the previous radices
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+static void _lfft_mixed_radix2(const lfft_Fft * fft, int32_t real[], int32_t imag[],
+        uint32_t space, bool calculate_ifft);
+
+/*!
+ * Calculates a pass with an odd radix (3, 5 or 7) of a mixed radix fft.
+ * The operants q and radix-q are combined, so radix*(radix-1)/2 instead of
+ * (radix-1)^2 complex multiplications are needed.
+ * \param fft initialized lfft_Fft struct with a mixed radix plan
+ * \param radix radix of the pass
+ * \param real real data; replaced by the real result
+ * \param imag imaginary data; replaced by the imaginary result
+ * \param space space between the operants of a butterfly, product of the previous radices
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+static void _lfft_mixed_radix_odd(const lfft_Fft * fft, uint8_t radix, int32_t real[], int32_t imag[],
+        uint32_t space, bool calculate_ifft);
+
+void _lfft_fft_mixed_radix(const lfft_Fft * fft, int32_t real[], int32_t imag[], bool calculate_ifft)
+{
+    uint8_t i;
+    uint32_t space = 1;
+
+    for(i = 0; i < fft->plan->radix_count; i++)
+    {
+        if(fft->plan->radices[i] == 2)
+        {
+            _lfft_mixed_radix2(fft, real, imag, space, calculate_ifft);
+        }
+        else
+        {
+            _lfft_mixed_radix_odd(fft, fft->plan->radices[i], real, imag, space, calculate_ifft);
+        }
+        space *= fft->plan->radices[i];
+    }
+}
+
+void _lfft_fft_bluestein(const lfft_Fft * fft, int32_t real[], int32_t imag[], bool calculate_ifft,
+        int32_t workspace[])
+{
+    uint32_t i;
+    int64_t data_real;
+    int64_t data_imag;
+    int32_t temp_real;
+    const lfft_Plan * plan = fft->plan;
+    int32_t * work_real = workspace;
+    int32_t * work_imag = &workspace[plan->inner->samples];
+    lfft_Fft inner;
+
+    // radix-2 fft of the convolution, only the tables of the plan are used
+    inner.samples         = plan->inner->samples;
+    inner.steps           = plan->inner->steps;
+    inner.ones_mask       = plan->inner->ones_mask;
+    inner.kernel          = LFFT_KERNEL_RADIX_2;
+    inner.plan            = plan->inner;
+    inner.switching_table = plan->inner->switching_table;
+    inner.wk_real         = plan->inner->wk_real;
+    inner.wk_imag         = plan->inner->wk_imag;
+    inner.step_wk         = plan->inner->step_wk;
+    inner.workspace       = NULL;
+    inner.input_samples   = inner.samples;
+    inner.result_real     = NULL;
+    inner.result_imag     = NULL;
+
+    // ifft(x) = conj(fft(conj(x)))/samples
+    // multiply the input with the chirp, the rest is 0
+    for(i = 0; i < fft->samples; i++)
+    {
+        data_real = real[i];
+        data_imag = calculate_ifft ? -imag[i] : imag[i];
+        work_real[i] = (int32_t) ((data_real*plan->chirp_real[i]-data_imag*plan->chirp_imag[i])>>LFFT_CHIRP_BITS);
+        work_imag[i] = (int32_t) ((data_real*plan->chirp_imag[i]+data_imag*plan->chirp_real[i])>>LFFT_CHIRP_BITS);
+    }
+    for(i = fft->samples; i < inner.samples; i++)
+    {
+        work_real[i] = 0;
+        work_imag[i] = 0;
+    }
+
+    lfft_fft_inplace(&inner, work_real, work_imag, NULL);
+
+    // multiply with the fft of the conjugated chirp and divide by inner.samples
+    // for the inverse fft; the inverse fft is calculated as conj(fft(conj(x)))
+    for(i = 0; i < inner.samples; i++)
+    {
+        data_real = work_real[i];
+        data_imag = work_imag[i];
+        work_real[i] = (int32_t) ((data_real*plan->bluestein_real[i]-data_imag*plan->bluestein_imag[i])>>
+                (LFFT_BLUESTEIN_BITS+inner.steps));
+        work_imag[i] = (int32_t) (-((data_real*plan->bluestein_imag[i]+data_imag*plan->bluestein_real[i])>>
+                (LFFT_BLUESTEIN_BITS+inner.steps)));
+    }
+
+    lfft_fft_inplace(&inner, work_real, work_imag, NULL);
+
+    // multiply the conjugated result of the convolution with the chirp
+    for(i = 0; i < fft->samples; i++)
+    {
+        data_real = work_real[i];
+        data_imag = -work_imag[i];
+        temp_real = (int32_t) ((data_real*plan->chirp_real[i]-data_imag*plan->chirp_imag[i])>>LFFT_CHIRP_BITS);
+        imag[i]   = (int32_t) ((data_real*plan->chirp_imag[i]+data_imag*plan->chirp_real[i])>>LFFT_CHIRP_BITS);
+        real[i]   = temp_real;
+
+        if(calculate_ifft)
+        {
+            real[i] = real[i]/(int32_t) fft->samples;
+            imag[i] = -imag[i]/(int32_t) fft->samples;
+        }
+    }
+}
+
+static void _lfft_mixed_radix2(const lfft_Fft * fft, int32_t real[], int32_t imag[],
+        uint32_t space, bool calculate_ifft)
+{
+    uint32_t j;
+    uint32_t k;
+    uint32_t n_wk_counter = fft->samples/(2*space); // distance of the wk values of the pass
+
+    // temporary variables
+    int32_t real_wk;
+    int32_t imag_wk;
+    int32_t wk_real;
+    int32_t wk_imag;
+
+    for(k = 0; k < space; k++)
+    {
+        wk_real = fft->wk_real[k*n_wk_counter];
+        // -sin(x) == sin(-x)
+        wk_imag = calculate_ifft ? -fft->wk_imag[k*n_wk_counter] : fft->wk_imag[k*n_wk_counter];
+
+        for(j = k; j < fft->samples; j += 2*space)
+        {
+            real_wk = ((real[j+space]*wk_real)>>LFFT_RHS_BITS)-((imag[j+space]*wk_imag)>>LFFT_RHS_BITS);
+            imag_wk = ((imag[j+space]*wk_real)>>LFFT_RHS_BITS)+((real[j+space]*wk_imag)>>LFFT_RHS_BITS);
+
+            real[j+space] = real[j]-real_wk;
+            imag[j+space] = imag[j]-imag_wk;
+            real[j] = real[j]+real_wk;
+            imag[j] = imag[j]+imag_wk;
+        }
+    }
+}
+
+static void _lfft_mixed_radix_odd(const lfft_Fft * fft, uint8_t radix, int32_t real[], int32_t imag[],
+        uint32_t space, bool calculate_ifft)
+{
+    uint32_t j;
+    uint32_t k;
+    uint8_t p;
+    uint8_t q;
+    uint8_t half = radix/2;
+    uint32_t n_wk_counter = fft->samples/(radix*space); // distance of the wk values of the pass
+
+    // cos(2*pi*m/radix) and sin(2*pi*m/radix) of the butterfly
+    int32_t cos_radix[LFFT_MAX_RADIX];
+    int32_t sin_radix[LFFT_MAX_RADIX];
+
+    // temporary variables
+    int32_t wk_real[LFFT_MAX_RADIX];
+    int32_t wk_imag[LFFT_MAX_RADIX];
+    int32_t t_real[LFFT_MAX_RADIX];
+    int32_t t_imag[LFFT_MAX_RADIX];
+    int32_t sum_real[LFFT_MAX_RADIX/2];
+    int32_t sum_imag[LFFT_MAX_RADIX/2];
+    int32_t diff_real[LFFT_MAX_RADIX/2];
+    int32_t diff_imag[LFFT_MAX_RADIX/2];
+    int32_t a_real;
+    int32_t a_imag;
+    int32_t b_real;
+    int32_t b_imag;
+
+    for(q = 0; q < radix; q++)
+    {
+        cos_radix[q] = fft->wk_real[q*(fft->samples/radix)];
+        // the inverse butterfly uses e^(j*2*pi*m/radix)
+        sin_radix[q] = calculate_ifft ? fft->wk_imag[q*(fft->samples/radix)] : -fft->wk_imag[q*(fft->samples/radix)];
+    }
+
+    for(k = 0; k < space; k++)
+    {
+        // wk values of the operants
+        for(q = 1; q < radix; q++)
+        {
+            wk_real[q] = fft->wk_real[k*q*n_wk_counter];
+            // -sin(x) == sin(-x)
+            wk_imag[q] = calculate_ifft ? -fft->wk_imag[k*q*n_wk_counter] : fft->wk_imag[k*q*n_wk_counter];
+        }
+
+        for(j = k; j < fft->samples; j += radix*space)
+        {
+            t_real[0] = real[j];
+            t_imag[0] = imag[j];
+            for(q = 1; q < radix; q++)
+            {
+                t_real[q] = ((real[j+q*space]*wk_real[q])>>LFFT_RHS_BITS)-((imag[j+q*space]*wk_imag[q])>>LFFT_RHS_BITS);
+                t_imag[q] = ((imag[j+q*space]*wk_real[q])>>LFFT_RHS_BITS)+((real[j+q*space]*wk_imag[q])>>LFFT_RHS_BITS);
+            }
+
+            // combine operant q and radix-q
+            real[j] = t_real[0];
+            imag[j] = t_imag[0];
+            for(q = 1; q <= half; q++)
+            {
+                sum_real[q-1]  = t_real[q]+t_real[radix-q];
+                sum_imag[q-1]  = t_imag[q]+t_imag[radix-q];
+                diff_real[q-1] = t_real[q]-t_real[radix-q];
+                diff_imag[q-1] = t_imag[q]-t_imag[radix-q];
+                real[j] += sum_real[q-1];
+                imag[j] += sum_imag[q-1];
+            }
+
+            // X[p] = a-j*b and X[radix-p] = a+j*b with
+            // a = t[0]+sum((t[q]+t[radix-q])*cos(2*pi*p*q/radix))
+            // b = sum((t[q]-t[radix-q])*sin(2*pi*p*q/radix))
+            for(p = 1; p <= half; p++)
+            {
+                a_real = t_real[0];
+                a_imag = t_imag[0];
+                b_real = 0;
+                b_imag = 0;
+                for(q = 1; q <= half; q++)
+                {
+                    a_real += (sum_real[q-1]*cos_radix[(p*q)%radix])>>LFFT_RHS_BITS;
+                    a_imag += (sum_imag[q-1]*cos_radix[(p*q)%radix])>>LFFT_RHS_BITS;
+                    b_real += (diff_real[q-1]*sin_radix[(p*q)%radix])>>LFFT_RHS_BITS;
+                    b_imag += (diff_imag[q-1]*sin_radix[(p*q)%radix])>>LFFT_RHS_BITS;
+                }
+
+                real[j+p*space]         = a_real+b_imag;
+                imag[j+p*space]         = a_imag-b_real;
+                real[j+(radix-p)*space] = a_real-b_imag;
+                imag[j+(radix-p)*space] = a_imag+b_real;
+            }
+        }
+    }
+}
@@ -0,0 +1,76 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains the fft calculation for sizes which are not to the power
+ * of 2. Sizes which are products of 2, 3, 5 and 7 are calculated with
+ * mixed radix butterflies, all other sizes with the bluestein algorithm.
+ * The functions are called by the functions of lfft_fft.h.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#ifndef _LFFT_MIXED_H
+#define _LFFT_MIXED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lfft_config.h"
+#include "lfft_fft.h"
+
+/*!
+ * Calculates the mixed radix butterflies.
+ * The result is not divided by fft->samples.
+ * \param fft initialized lfft_Fft struct with a mixed radix plan
+ * \param real reordered real data; replaced by the real result
+ * \param imag reordered imaginary data; replaced by the imaginary result
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+void _lfft_fft_mixed_radix(const lfft_Fft * fft, int32_t real[], int32_t imag[], bool calculate_ifft);
+
+/*!
+ * Calculates the fft with the bluestein algorithm.
+ * X[k] = c[k]*sum(x[n]*c[n]*conj(c[k-n])) with the chirp c[n] = e^(-j*pi*n^2/samples),
+ * the convolution is calculated with a fft with a power of 2 size.
+ * The data isn't reordered; the result of the ifft is divided by fft->samples.
+ * \param fft initialized lfft_Fft struct with a bluestein plan
+ * \param real real data; replaced by the real result
+ * \param imag imaginary data; replaced by the imaginary result
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ * \param workspace array with 2*fft->plan->inner->samples elements
+ */
+void _lfft_fft_bluestein(const lfft_Fft * fft, int32_t real[], int32_t imag[], bool calculate_ifft,
+        int32_t workspace[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LFFT_MIXED_H */
@@ -0,0 +1,328 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*! \file
+ * This file contains functions to calculate the convolution of a stream of
+ * integer input data with a long filter with a small latency by the
+ * uniformly partitioned overlap-save method.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#include "lfft_partitioned.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef LFFT_USE_AVX2
+#include <immintrin.h>
+#endif /* LFFT_USE_AVX2 */
+
+/*!
+ * Saves the bins 0..samples/2 of the bit reversed spectrum in the workspace
+ * of partitioned->fft.
+ * \param partitioned initialized lfft_Partitioned struct
+ * \param real array with partitioned->bins elements for the real bins
+ * \param imag array with partitioned->bins elements for the imaginary bins
+ */
+static void _lfft_partitioned_save(const lfft_Partitioned * partitioned, int32_t real[], int32_t imag[]);
+
+/*!
+ * Adds the products of an input spectrum and the spectrum of a partition to
+ * the accumulators with 64 bits.
+ * \param partitioned initialized lfft_Partitioned struct
+ * \param x_real real input spectrum
+ * \param x_imag imaginary input spectrum
+ * \param h_real real spectrum of the partition
+ * \param h_imag imaginary spectrum of the partition
+ */
+static void _lfft_partitioned_accumulate(lfft_Partitioned * partitioned,
+        const int32_t x_real[], const int32_t x_imag[], const int32_t h_real[], const int32_t h_imag[]);
+
+/*!
+ * Calculates the spectrum of a partition from partitioned->pending.
+ * \param partitioned initialized lfft_Partitioned struct
+ * \param partition index of the partition
+ */
+static void _lfft_partitioned_filter(lfft_Partitioned * partitioned, uint32_t partition);
+
+lfft_errno lfft_partitioned_new(lfft_Partitioned * partitioned, uint32_t block, uint32_t max_taps)
+{
+    uint32_t i;
+    uint32_t samples;
+    lfft_errno error;
+
+    // block is not to the power of 2 or the fft size is too big
+    if((block == 0)||(block&(block-1))||(block > (1UL<<30)))
+    {
+        return 1;
+    }
+
+    if(max_taps == 0)
+    {
+        return 2;
+    }
+
+    samples = 2*block;
+    error = lfft_fft_new(&partitioned->fft, samples);
+    if(error != 0)
+    {
+        return error;
+    }
+
+    partitioned->samples    = samples;
+    partitioned->steps      = partitioned->fft.steps;
+    partitioned->block      = block;
+    partitioned->partitions = max_taps/block+(max_taps%block != 0);
+    partitioned->count      = 0;
+    partitioned->taps       = 0;
+    partitioned->bins       = samples/2+1;
+    partitioned->position   = 0;
+
+    // allocate memory, the filter and the stream start with zeros
+    partitioned->mirror           = (uint32_t *) malloc(samples/2*sizeof(uint32_t));
+    partitioned->filter_real      = (int32_t *)  calloc((size_t) partitioned->partitions*partitioned->bins, sizeof(int32_t));
+    partitioned->filter_imag      = (int32_t *)  calloc((size_t) partitioned->partitions*partitioned->bins, sizeof(int32_t));
+    partitioned->delay_real       = (int32_t *)  calloc((size_t) partitioned->partitions*partitioned->bins, sizeof(int32_t));
+    partitioned->delay_imag       = (int32_t *)  calloc((size_t) partitioned->partitions*partitioned->bins, sizeof(int32_t));
+    partitioned->accumulator_real = (int64_t *)  malloc(partitioned->bins*sizeof(int64_t));
+    partitioned->accumulator_imag = (int64_t *)  malloc(partitioned->bins*sizeof(int64_t));
+    partitioned->history          = (int32_t *)  calloc(block, sizeof(int32_t));
+    partitioned->pending          = (int32_t *)  calloc(block, sizeof(int32_t));
+
+    if((partitioned->mirror == NULL)||(partitioned->filter_real == NULL)||(partitioned->filter_imag == NULL)||
+            (partitioned->delay_real == NULL)||(partitioned->delay_imag == NULL)||
+            (partitioned->accumulator_real == NULL)||(partitioned->accumulator_imag == NULL)||
+            (partitioned->history == NULL)||(partitioned->pending == NULL))
+    {
+        lfft_partitioned_delete(partitioned);
+        return 3;
+    }
+
+    // the element at the bit reversed position i > 1 is bin k >= samples/2+1,
+    // which is the conjugated bin samples-k at an even position
+    partitioned->mirror[0] = 0;
+    for(i = 3; i < samples; i += 2)
+    {
+        partitioned->mirror[i/2] = partitioned->fft.switching_table[samples-partitioned->fft.switching_table[i]]/2;
+    }
+
+    return 0;
+}
+
+void lfft_partitioned_delete(lfft_Partitioned * partitioned)
+{
+    lfft_fft_delete(&partitioned->fft);
+    free(partitioned->mirror);
+    free(partitioned->filter_real);
+    free(partitioned->filter_imag);
+    free(partitioned->delay_real);
+    free(partitioned->delay_imag);
+    free(partitioned->accumulator_real);
+    free(partitioned->accumulator_imag);
+    free(partitioned->history);
+    free(partitioned->pending);
+}
+
+lfft_errno lfft_partitioned_add(lfft_Partitioned * partitioned, const int32_t filter[], uint32_t taps)
+{
+    uint32_t offset;
+    uint32_t n;
+
+    if((uint64_t) partitioned->taps+taps > (uint64_t) partitioned->partitions*partitioned->block)
+    {
+        return 2;
+    }
+
+    while(taps > 0)
+    {
+        // fill the incomplete last partition
+        offset = partitioned->taps%partitioned->block;
+        n = partitioned->block-offset;
+        n = (taps < n) ? taps : n;
+        memcpy(&partitioned->pending[offset], filter, n*sizeof(int32_t));
+
+        _lfft_partitioned_filter(partitioned, partitioned->taps/partitioned->block);
+        partitioned->count = partitioned->taps/partitioned->block+1;
+
+        partitioned->taps += n;
+        filter += n;
+        taps -= n;
+
+        // the next partition starts with zeros
+        if(offset+n == partitioned->block)
+        {
+            memset(partitioned->pending, 0, partitioned->block*sizeof(int32_t));
+        }
+    }
+
+    return 0;
+}
+
+void lfft_partitioned_reset(lfft_Partitioned * partitioned)
+{
+    memset(partitioned->delay_real, 0, (size_t) partitioned->partitions*partitioned->bins*sizeof(int32_t));
+    memset(partitioned->delay_imag, 0, (size_t) partitioned->partitions*partitioned->bins*sizeof(int32_t));
+    memset(partitioned->history, 0, partitioned->block*sizeof(int32_t));
+}
+
+void lfft_partitioned_process(lfft_Partitioned * partitioned, const int32_t input[], int32_t output[])
+{
+    uint32_t i;
+    uint32_t p;
+    uint32_t slot;
+    uint32_t block = partitioned->block;
+    uint32_t bins = partitioned->bins;
+    uint32_t half = partitioned->samples/2;
+    uint8_t shift = LFFT_RHS_BITS+partitioned->steps; // removes the decimal places of the filter and divides by samples
+    int32_t * real = partitioned->fft.result_real;
+    int32_t * imag = partitioned->fft.result_imag;
+    int64_t * accumulator_real = partitioned->accumulator_real;
+    int64_t * accumulator_imag = partitioned->accumulator_imag;
+
+    // the last 2*block input samples
+    for(i = 0; i < block; i++)
+    {
+        real[i]       = partitioned->history[i]<<LFFT_RHS_BITS;
+        real[block+i] = input[i]<<LFFT_RHS_BITS;
+    }
+    memset(imag, 0, partitioned->samples*sizeof(int32_t));
+    memcpy(partitioned->history, input, block*sizeof(int32_t));
+
+    // natural order --> bit reversed spectrum, which replaces the oldest
+    // spectrum of the delay line
+    _lfft_fft_dif(&partitioned->fft, real, imag, false);
+    partitioned->position = (partitioned->position == 0) ? partitioned->partitions-1 : partitioned->position-1;
+    _lfft_partitioned_save(partitioned,
+            &partitioned->delay_real[(size_t) partitioned->position*bins],
+            &partitioned->delay_imag[(size_t) partitioned->position*bins]);
+
+    // the input spectrum of p blocks ago is multiplied with partition p
+    memset(accumulator_real, 0, bins*sizeof(int64_t));
+    memset(accumulator_imag, 0, bins*sizeof(int64_t));
+    slot = partitioned->position;
+    for(p = 0; p < partitioned->count; p++)
+    {
+        _lfft_partitioned_accumulate(partitioned,
+                &partitioned->delay_real[(size_t) slot*bins], &partitioned->delay_imag[(size_t) slot*bins],
+                &partitioned->filter_real[(size_t) p*bins], &partitioned->filter_imag[(size_t) p*bins]);
+        slot = (slot+1 == partitioned->partitions) ? 0 : slot+1;
+    }
+
+    // the ifft is divided by samples here because the sum could exceed 32
+    // bits; the bins above samples/2 are the conjugated lower bins
+    for(i = 0; i < half; i++)
+    {
+        real[2*i] = (int32_t) (accumulator_real[i]>>shift);
+        imag[2*i] = (int32_t) (accumulator_imag[i]>>shift);
+    }
+    real[1] = (int32_t) (accumulator_real[half]>>shift);
+    imag[1] = (int32_t) (accumulator_imag[half]>>shift);
+    for(i = 3; i < partitioned->samples; i += 2)
+    {
+        real[i] =  real[2*partitioned->mirror[i/2]];
+        imag[i] = -imag[2*partitioned->mirror[i/2]];
+    }
+
+    // bit reversed spectrum --> natural order, the first block results
+    // contain the wrapped around tail
+    _lfft_fft_dit(&partitioned->fft, real, imag, true);
+    memcpy(output, &real[block], block*sizeof(int32_t));
+}
+
+static void _lfft_partitioned_save(const lfft_Partitioned * partitioned, int32_t real[], int32_t imag[])
+{
+    uint32_t i;
+    uint32_t half = partitioned->samples/2;
+
+    // bin k < samples/2 is at the even position bitreverse(k), bin samples/2
+    // at position 1
+    for(i = 0; i < half; i++)
+    {
+        real[i] = partitioned->fft.result_real[2*i];
+        imag[i] = partitioned->fft.result_imag[2*i];
+    }
+    real[half] = partitioned->fft.result_real[1];
+    imag[half] = partitioned->fft.result_imag[1];
+}
+
+static void _lfft_partitioned_accumulate(lfft_Partitioned * partitioned,
+        const int32_t x_real[], const int32_t x_imag[], const int32_t h_real[], const int32_t h_imag[])
+{
+    uint32_t i = 0;
+    int64_t * accumulator_real = partitioned->accumulator_real;
+    int64_t * accumulator_imag = partitioned->accumulator_imag;
+
+#ifdef LFFT_USE_AVX2
+    __m256i a;
+    __m256i b;
+    __m256i c;
+    __m256i d;
+
+    // 4 bins with 64 bit products, the 32 bit values are sign extended
+    for(; i+4 <= partitioned->bins; i += 4)
+    {
+        a = _mm256_cvtepi32_epi64(_mm_loadu_si128((__m128i *) &x_real[i]));
+        b = _mm256_cvtepi32_epi64(_mm_loadu_si128((__m128i *) &x_imag[i]));
+        c = _mm256_cvtepi32_epi64(_mm_loadu_si128((__m128i *) &h_real[i]));
+        d = _mm256_cvtepi32_epi64(_mm_loadu_si128((__m128i *) &h_imag[i]));
+
+        _mm256_storeu_si256((__m256i *) &accumulator_real[i], _mm256_add_epi64(
+                _mm256_loadu_si256((__m256i *) &accumulator_real[i]),
+                _mm256_sub_epi64(_mm256_mul_epi32(a, c), _mm256_mul_epi32(b, d))));
+        _mm256_storeu_si256((__m256i *) &accumulator_imag[i], _mm256_add_epi64(
+                _mm256_loadu_si256((__m256i *) &accumulator_imag[i]),
+                _mm256_add_epi64(_mm256_mul_epi32(a, d), _mm256_mul_epi32(b, c))));
+    }
+#endif /* LFFT_USE_AVX2 */
+
+    for(; i < partitioned->bins; i++)
+    {
+        accumulator_real[i] += (int64_t) x_real[i]*h_real[i]-(int64_t) x_imag[i]*h_imag[i];
+        accumulator_imag[i] += (int64_t) x_real[i]*h_imag[i]+(int64_t) x_imag[i]*h_real[i];
+    }
+}
+
+static void _lfft_partitioned_filter(lfft_Partitioned * partitioned, uint32_t partition)
+{
+    uint32_t i;
+    int32_t * real = partitioned->fft.result_real;
+    int32_t * imag = partitioned->fft.result_imag;
+
+    // taps of the partition followed by zeros
+    for(i = 0; i < partitioned->block; i++)
+    {
+        real[i] = partitioned->pending[i]<<LFFT_RHS_BITS;
+        real[partitioned->block+i] = 0;
+    }
+    memset(imag, 0, partitioned->samples*sizeof(int32_t));
+
+    _lfft_fft_dif(&partitioned->fft, real, imag, false);
+    _lfft_partitioned_save(partitioned,
+            &partitioned->filter_real[(size_t) partition*partitioned->bins],
+            &partitioned->filter_imag[(size_t) partition*partitioned->bins]);
+}
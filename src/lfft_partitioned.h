@@ -0,0 +1,129 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*! \file
+ * This file contains functions to calculate the convolution of a stream of
+ * integer input data with a long filter with a small latency by the
+ * uniformly partitioned overlap-save method.
+ * The filter is split into partitions of block taps. The spectrum of every
+ * input block (the last 2*block input samples) is saved in a frequency domain
+ * delay line, the spectrum of the output block is the sum of the products of
+ * the spectrum of the input block of p blocks ago and the spectrum of the
+ * partition p. So the latency is block samples independent of the length of
+ * the filter.
+ * The spectra are bit reversed, see lfft_conv.h. The input data and the filter
+ * are real, so only the bins 0..samples/2 are saved and multiplied, they are
+ * the elements at the even positions and at position 1 of the bit reversed
+ * spectrum. The products are accumulated with 64 bits and rounded once.
+ * The filter can be loaded incrementally with lfft_partitioned_add() while
+ * the stream is filtered.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#ifndef _LFFT_PARTITIONED_H
+#define _LFFT_PARTITIONED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lfft_config.h"
+#include "lfft_fft.h"
+
+typedef struct _lfft_Partitioned
+{
+    uint32_t samples; //!< fft size; 2*block
+    uint8_t  steps; //!< log2(samples)
+    uint32_t block; //!< number of input samples and output samples of lfft_partitioned_process(); partition size
+    uint32_t partitions; //!< maximal number of partitions
+    uint32_t count; //!< number of partitions which contain loaded taps
+    uint32_t taps; //!< number of loaded taps
+    uint32_t bins; //!< number of saved bins of every spectrum; samples/2+1
+    uint32_t position; //!< slot of the newest input spectrum in the delay line
+
+    lfft_Fft fft; //!< radix-2 fft with samples elements; fft.result_real and fft.result_imag are the workspace
+    uint32_t * mirror; //!< saved bin of the conjugated element for the odd positions i > 1 at index i/2
+    int32_t  * filter_real; //!< real spectra of the partitions; bins elements per partition
+    int32_t  * filter_imag; //!< imaginary spectra of the partitions; bins elements per partition
+    int32_t  * delay_real; //!< real spectra of the last partitions input blocks; bins elements per slot
+    int32_t  * delay_imag; //!< imaginary spectra of the last partitions input blocks; bins elements per slot
+    int64_t  * accumulator_real; //!< real sum of the products of every bin
+    int64_t  * accumulator_imag; //!< imaginary sum of the products of every bin
+    int32_t  * history; //!< last block input samples
+    int32_t  * pending; //!< taps of the incomplete last partition
+} lfft_Partitioned;
+
+/*!
+ * Initializes the partitioned convolution without filter taps.
+ * The output sample n of the stream is sum(filter[k]*input[n-k]) of the
+ * loaded taps.
+ * \param partitioned pointer to struct to be initialized
+ * \param block number of samples of every block; must be to the power of 2
+ * \param max_taps maximal number of filter taps
+ * \return 0: successful 1: block is not to the power of 2 2: max_taps is 0 3: not enough memory
+ */
+lfft_errno lfft_partitioned_new(lfft_Partitioned * partitioned, uint32_t block, uint32_t max_taps);
+
+/*!
+ * Deallocate the used memory.
+ * \param partitioned initialized lfft_Partitioned struct
+ */
+void lfft_partitioned_delete(lfft_Partitioned * partitioned);
+
+/*!
+ * Appends taps to the loaded filter taps.
+ * Every changed partition costs one fft, so a long filter can be loaded in
+ * parts between the calls of lfft_partitioned_process(). The added taps are
+ * used for the next output block, the saved input spectra are kept.
+ * \param partitioned initialized lfft_Partitioned struct
+ * \param filter integer filter taps
+ * \param taps number of elements of filter
+ * \return 0: successful 2: more than max_taps taps
+ */
+lfft_errno lfft_partitioned_add(lfft_Partitioned * partitioned, const int32_t filter[], uint32_t taps);
+
+/*!
+ * Starts a new stream, all previous input samples are zero.
+ * The loaded taps are kept.
+ * \param partitioned initialized lfft_Partitioned struct
+ */
+void lfft_partitioned_reset(lfft_Partitioned * partitioned);
+
+/*!
+ * Filters the next partitioned->block samples of the stream.
+ * \param partitioned initialized lfft_Partitioned struct
+ * \param input partitioned->block integer input samples
+ * \param output partitioned->block output samples with LFFT_RHS_BITS decimal places
+ */
+void lfft_partitioned_process(lfft_Partitioned * partitioned, const int32_t input[], int32_t output[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LFFT_PARTITIONED_H */
@@ -0,0 +1,669 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains the plans of the fft. A plan contains the tables which
+ * only depend on the number of samples (switching table and wk values; the
+ * radices of mixed radix plans; the chirp of bluestein plans).
+ * Plans are shared by all lfft_Fft structs with the same number of samples;
+ * they are created on the first request and deallocated when the last user
+ * releases them.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#include "lfft_plan.h"
+
+#include "lfft_config.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#ifdef LFFT_USE_THREADS
+#include <pthread.h>
+#endif /* LFFT_USE_THREADS */
+
+#ifdef LFFT_USE_GENERATED
+#include "lfft_generated_tables.h"
+
+/*!
+ * plans of the generated tables, see lfft_generated_tables.h
+ */
+static lfft_Plan _lfft_generated_plans[LFFT_GENERATED_COUNT];
+#endif /* LFFT_USE_GENERATED */
+
+/*!
+ * list of all plans in use
+ */
+static lfft_Plan * _lfft_plans = NULL;
+
+#ifdef LFFT_USE_THREADS
+/*!
+ * lock of the registry of the plans and their references
+ */
+static pthread_mutex_t _lfft_plans_mutex = PTHREAD_MUTEX_INITIALIZER;
+#elif defined(__GNUC__)
+/*!
+ * lock of the registry of the plans and their references
+ */
+static volatile char _lfft_plans_lock_flag = 0;
+#else
+#error "the lock of the plan registry needs pthreads (LFFT_USE_THREADS) or the atomic builtins of GCC"
+#endif /* LFFT_USE_THREADS */
+
+/*!
+ * Locks the registry of the plans.
+ */
+static void _lfft_plans_lock(void);
+
+/*!
+ * Unlocks the registry of the plans.
+ */
+static void _lfft_plans_unlock(void);
+
+/*!
+ * Searches the registry (and the generated plans) for the plan of samples
+ * and adds a reference to it.
+ * The registry has to be locked.
+ * \param samples number of samples
+ * \return shared plan; NULL if there is no plan for samples yet
+ */
+static lfft_Plan * _lfft_plan_find(uint32_t samples);
+
+/*!
+ * Creates a plan and calculates its tables.
+ * \param samples number of samples
+ * \return new plan; NULL if there is not enough memory
+ */
+static lfft_Plan * _lfft_plan_new(uint32_t samples);
+
+/*!
+ * Calculates the tables of a plan with a power of 2 size.
+ * \param plan plan with initialized samples
+ * \return true if successful; false if there is not enough memory
+ */
+static bool _lfft_plan_power_2(lfft_Plan * plan);
+
+/*!
+ * Calculates the tables of a mixed radix plan.
+ * The switching table is the digit-reverse of the indices with the radices
+ * of plan->radices, the first radix is the least significant digit of the
+ * reordered index.
+ * \param plan plan with initialized samples and radices
+ * \return true if successful; false if there is not enough memory
+ */
+static bool _lfft_plan_mixed_radix(lfft_Plan * plan);
+
+/*!
+ * Calculates the tables of a bluestein plan.
+ * \param plan plan with initialized samples
+ * \return true if successful; false if there is not enough memory
+ */
+static bool _lfft_plan_bluestein(lfft_Plan * plan);
+
+/*!
+ * Calculates the swap table which reorders data in place like the switching
+ * table. Every cycle of the permutation is replaced by a chain of swaps.
+ * \param plan plan with initialized switching table
+ * \return true if successful; false if there is not enough memory
+ */
+static bool _lfft_plan_swap_table(lfft_Plan * plan);
+
+/*!
+ * Calculates an fft with double precision (used for the tables only).
+ * \param samples number of samples; must be to the power of 2
+ * \param real real data; replaced by the real result
+ * \param imag imaginary data; replaced by the imaginary result
+ */
+static void _lfft_plan_fft_double(uint32_t samples, double real[], double imag[]);
+
+/*!
+ * Deallocates a plan.
+ * \param plan plan to be deallocated
+ */
+static void _lfft_plan_delete(lfft_Plan * plan);
+
+bool lfft_plan_is_supported(uint32_t samples)
+{
+    const uint8_t radices[] = {2, 3, 5, 7};
+    uint32_t rest = samples;
+    uint8_t i;
+
+    if(samples <= LFFT_BLUESTEIN_MAX_SAMPLES)
+    {
+        return samples > 0;
+    }
+
+    // powers of 2 and mixed radix sizes don't need a larger inner fft
+    for(i = 0; i < sizeof(radices); i++)
+    {
+        while(rest%radices[i] == 0)
+        {
+            rest /= radices[i];
+        }
+    }
+
+    return rest == 1;
+}
+
+lfft_Plan * lfft_plan_acquire(uint32_t samples)
+{
+    lfft_Plan * plan;
+    lfft_Plan * created;
+
+    if(!lfft_plan_is_supported(samples))
+    {
+        return NULL;
+    }
+
+    _lfft_plans_lock();
+    plan = _lfft_plan_find(samples);
+    _lfft_plans_unlock();
+
+    if(plan != NULL)
+    {
+        return plan;
+    }
+
+    // the tables are calculated without holding the lock, another thread
+    // can register a plan with the same size in the meantime
+    created = _lfft_plan_new(samples);
+    if(created == NULL)
+    {
+        return NULL;
+    }
+
+    _lfft_plans_lock();
+    plan = _lfft_plan_find(samples);
+    if(plan == NULL)
+    {
+        created->references = 1;
+        created->next = _lfft_plans;
+        _lfft_plans = created;
+
+        plan = created;
+        created = NULL;
+    }
+    _lfft_plans_unlock();
+
+    if(created != NULL)
+    {
+        _lfft_plan_delete(created);
+    }
+
+    return plan;
+}
+
+void lfft_plan_release(lfft_Plan * plan)
+{
+    lfft_Plan ** link;
+
+    if(plan == NULL)
+    {
+        return;
+    }
+
+    _lfft_plans_lock();
+
+    plan->references--;
+    if((plan->references > 0)||plan->generated)
+    {
+        _lfft_plans_unlock();
+        return;
+    }
+
+    // remove the plan from the registry
+    for(link = &_lfft_plans; *link != NULL; link = &(*link)->next)
+    {
+        if(*link == plan)
+        {
+            *link = plan->next;
+            break;
+        }
+    }
+
+    _lfft_plans_unlock();
+
+    // nobody can find the plan anymore, the tables are deallocated
+    // without holding the lock
+    _lfft_plan_delete(plan);
+}
+
+static void _lfft_plans_lock(void)
+{
+#ifdef LFFT_USE_THREADS
+    pthread_mutex_lock(&_lfft_plans_mutex);
+#elif defined(__GNUC__)
+    while(__atomic_test_and_set(&_lfft_plans_lock_flag, __ATOMIC_ACQUIRE))
+    {
+        // the lock is only held while the registry is searched or changed
+    }
+#endif /* LFFT_USE_THREADS */
+}
+
+static void _lfft_plans_unlock(void)
+{
+#ifdef LFFT_USE_THREADS
+    pthread_mutex_unlock(&_lfft_plans_mutex);
+#elif defined(__GNUC__)
+    __atomic_clear(&_lfft_plans_lock_flag, __ATOMIC_RELEASE);
+#endif /* LFFT_USE_THREADS */
+}
+
+static lfft_Plan * _lfft_plan_find(uint32_t samples)
+{
+    lfft_Plan * plan;
+#ifdef LFFT_USE_GENERATED
+    uint8_t i;
+#endif /* LFFT_USE_GENERATED */
+
+#ifdef LFFT_USE_GENERATED
+    for(i = 0; i < LFFT_GENERATED_COUNT; i++)
+    {
+        if(_lfft_generated_tables[i].samples == samples)
+        {
+            // the tables are read-only, the pointers of the plan aren't const
+            // because computed tables are deallocated
+            plan = &_lfft_generated_plans[i];
+            if(!plan->generated)
+            {
+                plan->samples         = samples;
+                plan->steps           = _lfft_generated_tables[i].steps;
+                plan->ones_mask       = (samples>>1)-1;
+                plan->switching_table = (uint32_t *) _lfft_generated_tables[i].switching_table;
+                plan->wk_real         = (int32_t *) _lfft_generated_tables[i].wk_real;
+                plan->wk_imag         = (int32_t *) _lfft_generated_tables[i].wk_imag;
+                plan->step_wk         = (int32_t *) _lfft_generated_tables[i].step_wk;
+                plan->generated       = true;
+            }
+            plan->references++;
+            return plan;
+        }
+    }
+#endif /* LFFT_USE_GENERATED */
+
+    for(plan = _lfft_plans; plan != NULL; plan = plan->next)
+    {
+        if(plan->samples == samples)
+        {
+            plan->references++;
+            return plan;
+        }
+    }
+
+    return NULL;
+}
+
+static lfft_Plan * _lfft_plan_new(uint32_t samples)
+{
+    const uint8_t radices[] = {2, 3, 5, 7};
+    uint32_t rest;
+    uint8_t i;
+    bool successful;
+    lfft_Plan * plan;
+
+    plan = (lfft_Plan *) calloc(1, sizeof(lfft_Plan));
+    if(plan == NULL)
+    {
+        return NULL;
+    }
+
+    plan->samples = samples;
+
+    if(!(samples&(samples-1)))
+    {
+        successful = _lfft_plan_power_2(plan);
+    }
+    else
+    {
+        // split samples into radices 2, 3, 5 and 7
+        rest = samples;
+        for(i = 0; i < sizeof(radices); i++)
+        {
+            while(rest%radices[i] == 0)
+            {
+                plan->radices[plan->radix_count++] = radices[i];
+                rest /= radices[i];
+            }
+        }
+
+        if(rest == 1)
+        {
+            successful = _lfft_plan_mixed_radix(plan);
+        }
+        else
+        {
+            // a prime factor larger than 7 remains
+            plan->radix_count = 0;
+            successful = _lfft_plan_bluestein(plan);
+        }
+    }
+
+    if(!successful)
+    {
+        _lfft_plan_delete(plan);
+        return NULL;
+    }
+
+    return plan;
+}
+
+static bool _lfft_plan_power_2(lfft_Plan * plan)
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t half;
+    uint32_t new_place;
+
+    // log2(x) = log10(x)/log10(2)
+    // make a round before casting to uint8_t, otherwise there are sometimes
+    // rounding errors
+    // round(x) = floor(x+0.5)
+    plan->steps =  ((uint8_t) floor((log((float) plan->samples)/log(2.0f))+0.5f));
+    // create binary mask
+    // example: plan->samples = 8 --> plan->ones_mask = 0b11 */
+    plan->ones_mask = (plan->samples>>1)-1;
+
+    // allocate memory; at least one wk value to get valid pointers for
+    // plan->samples = 1
+    plan->switching_table = (uint32_t *) calloc(plan->samples, sizeof(uint32_t));
+    plan->wk_real         = (int32_t *)  calloc(plan->samples/2+1, sizeof(int32_t));
+    plan->wk_imag         = (int32_t *)  calloc(plan->samples/2+1, sizeof(int32_t));
+
+    if((plan->switching_table == NULL)||(plan->wk_real == NULL)||(plan->wk_imag == NULL))
+    {
+        return false;
+    }
+
+    // calculate the switching table; making the content of the table bit-reverse
+    for(i = 0; i < plan->samples; i++)
+    {
+        new_place = 0;
+        for(j = 0; j < plan->steps; j++)
+        {
+            new_place <<= 1;
+            new_place += (i>>j)&1;
+        }
+        plan->switching_table[i] = new_place;
+    }
+
+    // calculate different wk_n
+    // the result is multiplied with 2^LFFT_RHS_BITS, to have the size some
+    // decimal place bits in the least sigificant bits of the integer values
+    // wk = e^(-j*2*pi*i/plan->samples)*(1<<LFFT_RHS_BITS)
+    for(i = 0; i < plan->samples/2; i++)
+    {
+        plan->wk_real[i] = (int32_t) (cos((2.0f*M_PI*i)/plan->samples)*(1<<LFFT_RHS_BITS));
+        plan->wk_imag[i] = (int32_t) ((-sin((2.0f*M_PI*i)/plan->samples))*(1<<LFFT_RHS_BITS));
+    }
+
+    // copy the wk values of every step into a contiguous block, the step
+    // with half wk values starts at pair half, pair 0 is unused
+    plan->step_wk_memory = malloc(2*plan->samples*sizeof(int32_t)+LFFT_ALIGNMENT);
+    if(plan->step_wk_memory == NULL)
+    {
+        return false;
+    }
+    plan->step_wk = (int32_t *) (((uintptr_t) plan->step_wk_memory+LFFT_ALIGNMENT-1)&~((uintptr_t) LFFT_ALIGNMENT-1));
+
+    for(half = 1; half < plan->samples; half <<= 1)
+    {
+        // e^(-j*2*pi*k/(2*half)) == wk[k*plan->samples/(2*half)]
+        for(i = 0; i < half; i++)
+        {
+            plan->step_wk[LFFT_STEP_WK(half)+2*i]   = plan->wk_real[i*(plan->samples/(2*half))];
+            plan->step_wk[LFFT_STEP_WK(half)+2*i+1] = plan->wk_imag[i*(plan->samples/(2*half))];
+        }
+    }
+
+    return true;
+}
+
+static bool _lfft_plan_mixed_radix(lfft_Plan * plan)
+{
+    uint32_t i;
+    uint32_t n;
+    uint32_t position;
+    uint32_t span;
+    int8_t r;
+
+    plan->switching_table = (uint32_t *) calloc(plan->samples, sizeof(uint32_t));
+    plan->wk_real         = (int32_t *)  calloc(plan->samples, sizeof(int32_t));
+    plan->wk_imag         = (int32_t *)  calloc(plan->samples, sizeof(int32_t));
+
+    if((plan->switching_table == NULL)||(plan->wk_real == NULL)||(plan->wk_imag == NULL))
+    {
+        return false;
+    }
+
+    // the last radix splits the input into radices[radix_count-1] sequences
+    // with stride radices[radix_count-1], every sequence is stored in a
+    // contiguous block; the same is repeated for the blocks
+    // example: samples = 6, radices = {2, 3}
+    //   switching table = {0, 3, 1, 4, 2, 5}
+    for(i = 0; i < plan->samples; i++)
+    {
+        n = i;
+        position = 0;
+        span = plan->samples;
+        for(r = plan->radix_count-1; r >= 0; r--)
+        {
+            span /= plan->radices[r];
+            position += (n%plan->radices[r])*span;
+            n /= plan->radices[r];
+        }
+        plan->switching_table[position] = i;
+    }
+
+    // wk = e^(-j*2*pi*i/plan->samples)*(1<<LFFT_RHS_BITS) of the full circle,
+    // the radix-3, radix-5 and radix-7 butterflies need all of them
+    for(i = 0; i < plan->samples; i++)
+    {
+        plan->wk_real[i] = (int32_t) (cos((2.0*M_PI*i)/plan->samples)*(1<<LFFT_RHS_BITS));
+        plan->wk_imag[i] = (int32_t) ((-sin((2.0*M_PI*i)/plan->samples))*(1<<LFFT_RHS_BITS));
+    }
+
+    return _lfft_plan_swap_table(plan);
+}
+
+static bool _lfft_plan_bluestein(lfft_Plan * plan)
+{
+    uint32_t i;
+    uint32_t samples_inner = 1;
+    double angle;
+    double * real;
+    double * imag;
+
+    // the inner fft has more than 2^31 samples, see lfft_plan_is_supported()
+    if(plan->samples > LFFT_BLUESTEIN_MAX_SAMPLES)
+    {
+        return false;
+    }
+
+    // the linear convolution of samples values with 2*samples-1 chirp
+    // values needs a cyclic convolution with at least 2*samples-1 values
+    while(samples_inner < 2*plan->samples-1)
+    {
+        samples_inner <<= 1;
+    }
+
+    plan->inner = lfft_plan_acquire(samples_inner);
+
+    // the input data isn't reordered
+    plan->switching_table = (uint32_t *) calloc(plan->samples, sizeof(uint32_t));
+    plan->wk_real         = (int32_t *)  calloc(1, sizeof(int32_t));
+    plan->wk_imag         = (int32_t *)  calloc(1, sizeof(int32_t));
+    plan->chirp_real      = (int32_t *)  calloc(plan->samples, sizeof(int32_t));
+    plan->chirp_imag      = (int32_t *)  calloc(plan->samples, sizeof(int32_t));
+    plan->bluestein_real  = (int32_t *)  calloc(samples_inner, sizeof(int32_t));
+    plan->bluestein_imag  = (int32_t *)  calloc(samples_inner, sizeof(int32_t));
+
+    real = (double *) calloc(samples_inner, sizeof(double));
+    imag = (double *) calloc(samples_inner, sizeof(double));
+
+    if((plan->inner == NULL)||(plan->switching_table == NULL)||(plan->wk_real == NULL)||
+            (plan->wk_imag == NULL)||(plan->chirp_real == NULL)||(plan->chirp_imag == NULL)||
+            (plan->bluestein_real == NULL)||(plan->bluestein_imag == NULL)||(real == NULL)||(imag == NULL))
+    {
+        free(real);
+        free(imag);
+        return false;
+    }
+
+    for(i = 0; i < plan->samples; i++)
+    {
+        plan->switching_table[i] = i;
+
+        // chirp = e^(-j*pi*i^2/samples); i^2 modulo 2*samples keeps the angle exact
+        angle = (M_PI*(double) (((uint64_t) i*i)%(2*(uint64_t) plan->samples)))/plan->samples;
+        plan->chirp_real[i] = (int32_t) floor(cos(angle)*(1L<<LFFT_CHIRP_BITS)+0.5);
+        plan->chirp_imag[i] = (int32_t) floor(-sin(angle)*(1L<<LFFT_CHIRP_BITS)+0.5);
+
+        // conjugated chirp for the indices -samples+1 ... samples-1
+        real[i] = cos(angle);
+        imag[i] = sin(angle);
+        if(i > 0)
+        {
+            real[samples_inner-i] = cos(angle);
+            imag[samples_inner-i] = sin(angle);
+        }
+    }
+
+    _lfft_plan_fft_double(samples_inner, real, imag);
+
+    for(i = 0; i < samples_inner; i++)
+    {
+        plan->bluestein_real[i] = (int32_t) floor(real[i]*(1L<<LFFT_BLUESTEIN_BITS)+0.5);
+        plan->bluestein_imag[i] = (int32_t) floor(imag[i]*(1L<<LFFT_BLUESTEIN_BITS)+0.5);
+    }
+
+    free(real);
+    free(imag);
+
+    return true;
+}
+
+static bool _lfft_plan_swap_table(lfft_Plan * plan)
+{
+    uint32_t i;
+    uint32_t j;
+    bool * done = (bool *) calloc(plan->samples, sizeof(bool));
+
+    // a cycle i -> switching_table[i] -> ... needs one swap less than its length
+    plan->swap_table = (uint32_t *) malloc(2*plan->samples*sizeof(uint32_t));
+    if((done == NULL)||(plan->swap_table == NULL))
+    {
+        free(done);
+        return false;
+    }
+
+    plan->swap_count = 0;
+    for(i = 0; i < plan->samples; i++)
+    {
+        // data[j] = data[switching_table[j]] for every element of the cycle
+        // example: cycle 1 -> 3 -> 2 -> 1: swap(1, 3), swap(3, 2)
+        done[i] = true;
+        for(j = i; !done[plan->switching_table[j]]; j = plan->switching_table[j])
+        {
+            plan->swap_table[2*plan->swap_count]   = j;
+            plan->swap_table[2*plan->swap_count+1] = plan->switching_table[j];
+            plan->swap_count++;
+            done[plan->switching_table[j]] = true;
+        }
+    }
+
+    free(done);
+
+    return true;
+}
+
+static void _lfft_plan_fft_double(uint32_t samples, double real[], double imag[])
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t k;
+    uint32_t span;
+    double temp;
+    double angle;
+    double wk_real;
+    double wk_imag;
+    double real_2;
+    double imag_2;
+
+    // bit-reverse
+    for(i = 1, j = 0; i < samples; i++)
+    {
+        k = samples>>1;
+        while(j&k)
+        {
+            j ^= k;
+            k >>= 1;
+        }
+        j |= k;
+
+        if(i < j)
+        {
+            temp = real[i]; real[i] = real[j]; real[j] = temp;
+            temp = imag[i]; imag[i] = imag[j]; imag[j] = temp;
+        }
+    }
+
+    for(span = 1; span < samples; span <<= 1)
+    {
+        for(k = 0; k < span; k++)
+        {
+            angle = -M_PI*k/span;
+            wk_real = cos(angle);
+            wk_imag = sin(angle);
+            for(i = k; i < samples; i += 2*span)
+            {
+                real_2 = real[i+span]*wk_real-imag[i+span]*wk_imag;
+                imag_2 = real[i+span]*wk_imag+imag[i+span]*wk_real;
+                real[i+span] = real[i]-real_2;
+                imag[i+span] = imag[i]-imag_2;
+                real[i] += real_2;
+                imag[i] += imag_2;
+            }
+        }
+    }
+}
+
+static void _lfft_plan_delete(lfft_Plan * plan)
+{
+    lfft_plan_release(plan->inner);
+    free(plan->switching_table);
+    free(plan->wk_real);
+    free(plan->wk_imag);
+    free(plan->step_wk_memory);
+    free(plan->swap_table);
+    free(plan->chirp_real);
+    free(plan->chirp_imag);
+    free(plan->bluestein_real);
+    free(plan->bluestein_imag);
+    free(plan);
+}
@@ -0,0 +1,152 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains the plans of the fft. A plan contains the tables which
+ * only depend on the number of samples (switching table and wk values).
+ * Plans are shared by all lfft_Fft structs with the same number of samples;
+ * they are created on the first request and deallocated when the last user
+ * releases them.
+ * Sizes which are products of 2, 3, 5 and 7 get a mixed radix plan, all other
+ * sizes which are not to the power of 2 get a plan for the bluestein
+ * algorithm, which calculates the fft as a convolution with a chirp using a
+ * fft with a power of 2 size.
+ * If LFFT_USE_GENERATED is defined (cmake option ENABLE_GENERATED_TABLES),
+ * the plans of the sizes LFFT_FIXED_SIZES use const tables generated at build
+ * time and are neither computed nor allocated.
+ * The registry of the plans is protected by a lock, so lfft_Fft structs can
+ * be created and deleted by several threads concurrently. The lock is a
+ * pthread mutex if LFFT_USE_THREADS is defined (cmake option ENABLE_THREADS)
+ * and a spin lock with the atomic builtins of GCC otherwise; it is only held
+ * while the registry is searched or changed, the tables are calculated and
+ * deallocated outside of it.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#ifndef _LFFT_PLAN_H
+#define _LFFT_PLAN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lfft_config.h"
+
+/*!
+ * maximal number of radices of a mixed radix plan
+ */
+#define LFFT_PLAN_MAX_RADICES 32
+
+/*!
+ * bits for decimal places of the chirp of the bluestein algorithm
+ */
+#define LFFT_CHIRP_BITS 30
+
+/*!
+ * bits for decimal places of the fft of the chirp of the bluestein algorithm
+ */
+#define LFFT_BLUESTEIN_BITS 16
+
+typedef struct _lfft_Plan
+{
+    uint32_t   samples; //!< number of samples
+    uint8_t    steps; //!< number of steps; 0 if samples is not to the power of 2
+    uint32_t   ones_mask; //!< binary mask used for fft calculation
+
+    uint32_t * switching_table; //!< table containing switching values for the input data
+    int32_t  * wk_real; //!< real wk values; samples values of the full circle if samples is not to the power of 2
+    int32_t  * wk_imag; //!< imaginary wk values; samples values of the full circle if samples is not to the power of 2
+    int32_t  * step_wk; //!< wk values of every step, see lfft_plan_step_wk(); NULL if samples is not to the power of 2
+    void     * step_wk_memory; //!< allocated memory of step_wk
+
+    uint8_t    radix_count; //!< number of radices of a mixed radix plan; 0 for other plans
+    uint8_t    radices[LFFT_PLAN_MAX_RADICES]; //!< radix of every pass of a mixed radix plan
+    uint32_t   swap_count; //!< number of pairs of swap_table
+    uint32_t * swap_table; //!< pairs of indices which are swapped to reorder data in place; NULL if samples is to the power of 2
+
+    struct _lfft_Plan * inner; //!< plan of the convolution of the bluestein algorithm; NULL for other plans
+    int32_t  * chirp_real; //!< real chirp e^(-j*pi*n^2/samples) with LFFT_CHIRP_BITS decimal places
+    int32_t  * chirp_imag; //!< imaginary chirp e^(-j*pi*n^2/samples) with LFFT_CHIRP_BITS decimal places
+    int32_t  * bluestein_real; //!< real fft of the conjugated chirp with LFFT_BLUESTEIN_BITS decimal places
+    int32_t  * bluestein_imag; //!< imaginary fft of the conjugated chirp with LFFT_BLUESTEIN_BITS decimal places
+
+    bool       generated; //!< true if the tables are generated at build time; the plan is never deallocated
+    uint32_t   references; //!< number of users of the plan
+    struct _lfft_Plan * next; //!< next plan of the registry
+} lfft_Plan;
+
+/*!
+ * Index of the first wk value of a step in lfft_Plan.step_wk.
+ * The step which combines ffts with half samples to ffts with 2*half samples
+ * uses the half wk values e^(-j*2*pi*k/(2*half)), k = 0..half-1, which are
+ * stored contiguously and interleaved (real, imaginary) at
+ * step_wk[LFFT_STEP_WK(half)+2*k]. The values are the same for all sizes, so
+ * ffts smaller than the plan use the same table. Steps with at least 4 wk
+ * values are aligned to LFFT_ALIGNMENT bytes.
+ */
+#define LFFT_STEP_WK(half) (2*(uint32_t) (half))
+
+/*!
+ * largest number of samples of a bluestein plan, the inner fft has at most
+ * 2^31 samples
+ */
+#define LFFT_BLUESTEIN_MAX_SAMPLES (1UL<<30)
+
+/*!
+ * Returns if there can be a plan for samples.
+ * All powers of 2 and products of 2, 3, 5 and 7 are supported, sizes of
+ * bluestein plans only up to LFFT_BLUESTEIN_MAX_SAMPLES.
+ * \param samples number of samples
+ * \return true if samples is supported; false if samples is 0 or too large
+ */
+bool lfft_plan_is_supported(uint32_t samples);
+
+/*!
+ * Returns the plan for samples.
+ * The plan is created if there is no plan with the same number of samples,
+ * otherwise the existing plan is shared.
+ * Every call has to be followed by a call of lfft_plan_release().
+ * \param samples number of samples
+ * \return plan for samples; NULL if samples is not supported (see
+ *         lfft_plan_is_supported()) or if there is not enough memory
+ */
+lfft_Plan * lfft_plan_acquire(uint32_t samples);
+
+/*!
+ * Releases a plan returned by lfft_plan_acquire().
+ * The plan is deallocated if it has no users anymore.
+ * \param plan plan to be released
+ */
+void lfft_plan_release(lfft_Plan * plan);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LFFT_PLAN_H */
@@ -0,0 +1,621 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains a thread pool to calculate many independent ffts on
+ * several cores. Every worker has its own task queue and workspace; a worker
+ * without tasks steals tasks from the queues of the other workers.
+ * The thread pool uses pthreads and is only built with the cmake option
+ * ENABLE_THREADS, it isn't included by lfft.h.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // pthread_setaffinity_np()
+#endif /* _GNU_SOURCE */
+
+#include "lfft_pool.h"
+
+#include "lfft_batch.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/*!
+ * argument of a task of lfft_pool_fft_batch()
+ */
+typedef struct _lfft_PoolBatch
+{
+    const lfft_Fft * fft;
+    uint32_t count;
+    const int32_t * real;
+    const int32_t * imag;
+    uint32_t in_stride;
+    int32_t * result_real;
+    int32_t * result_imag;
+    uint32_t out_stride;
+    bool calculate_ifft;
+} _lfft_PoolBatch;
+
+/*!
+ * argument of a task of lfft_pool_fft2()
+ */
+typedef struct _lfft_PoolFft2
+{
+    lfft_Fft2 * fft2;
+    int32_t ** real;
+    int32_t ** imag;
+    bool calculate_ifft2;
+} _lfft_PoolFft2;
+
+/*!
+ * argument of a task of lfft_pool_large_fft()
+ */
+typedef struct _lfft_PoolLarge
+{
+    const lfft_Large * large;
+    uint8_t pass;
+    uint32_t first;
+    uint32_t rows;
+    const int32_t * real;
+    const int32_t * imag;
+    bool calculate_ifft;
+} _lfft_PoolLarge;
+
+/*!
+ * Function of a worker thread.
+ * \param argument lfft_PoolWorker struct of the worker
+ * \return NULL
+ */
+static void * _lfft_pool_worker(void * argument);
+
+/*!
+ * Takes the newest task of the own queue or steals the oldest task of the
+ * queue of another worker.
+ * \param worker worker which needs a task
+ * \param task the task is stored here
+ * \return true if a task was found
+ */
+static bool _lfft_pool_take(lfft_PoolWorker * worker, lfft_PoolTask * task);
+
+/*!
+ * Appends a task to the queue of a worker, the queue grows if it is full.
+ * \param worker worker which gets the task
+ * \param task task to be appended
+ * \return 0: successful 3: not enough memory
+ */
+static lfft_errno _lfft_pool_push(lfft_PoolWorker * worker, lfft_PoolTask task);
+
+/*!
+ * Task of lfft_pool_fft_batch().
+ * \param argument _lfft_PoolBatch struct
+ * \param workspace workspace of the worker
+ */
+static void _lfft_pool_batch_task(void * argument, void * workspace);
+
+/*!
+ * Task of lfft_pool_fft2().
+ * \param argument _lfft_PoolFft2 struct
+ * \param workspace workspace of the worker; not used
+ */
+static void _lfft_pool_fft2_task(void * argument, void * workspace);
+
+/*!
+ * Task of lfft_pool_large_fft().
+ * \param argument _lfft_PoolLarge struct
+ * \param workspace workspace of the worker
+ */
+static void _lfft_pool_large_task(void * argument, void * workspace);
+
+/*!
+ * Stops and joins the first threads workers and deallocates the memory of
+ * all workers.
+ * \param pool lfft_Pool struct
+ * \param threads number of started worker threads
+ */
+static void _lfft_pool_stop(lfft_Pool * pool, uint16_t threads);
+
+lfft_errno lfft_pool_new(lfft_Pool * pool, uint16_t threads, size_t workspace_size)
+{
+    uint16_t i;
+    long cpus;
+
+    if(threads == 0)
+    {
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cpus > 0) ? (uint16_t) cpus : 1;
+    }
+
+    pool->threads = threads;
+    pool->workspace_size = workspace_size;
+    pool->queued = 0;
+    pool->pending = 0;
+    pool->next_worker = 0;
+    pool->stop = false;
+
+    pool->workers = (lfft_PoolWorker *) calloc(threads, sizeof(lfft_PoolWorker));
+    if(pool->workers == NULL)
+    {
+        return 3;
+    }
+
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->work, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    // all workers have to be initialized before the first thread steals tasks
+    for(i = 0; i < threads; i++)
+    {
+        pthread_mutex_init(&pool->workers[i].mutex, NULL);
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+        pool->workers[i].capacity = 16;
+        pool->workers[i].tasks = (lfft_PoolTask *) malloc(16*sizeof(lfft_PoolTask));
+        pool->workers[i].workspace = (workspace_size > 0) ? malloc(workspace_size) : NULL;
+    }
+
+    for(i = 0; i < threads; i++)
+    {
+        if((pool->workers[i].tasks == NULL)||((workspace_size > 0)&&(pool->workers[i].workspace == NULL)))
+        {
+            _lfft_pool_stop(pool, 0);
+            return 3;
+        }
+    }
+
+    for(i = 0; i < threads; i++)
+    {
+        if(pthread_create(&pool->workers[i].thread, NULL, _lfft_pool_worker, &pool->workers[i]))
+        {
+            _lfft_pool_stop(pool, i);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+void lfft_pool_delete(lfft_Pool * pool)
+{
+    _lfft_pool_stop(pool, pool->threads);
+}
+
+lfft_errno lfft_pool_set_affinity(lfft_Pool * pool, uint16_t worker, uint16_t cpu)
+{
+#if defined(__linux__)
+    cpu_set_t cpus;
+
+    if((worker >= pool->threads)||(cpu >= CPU_SETSIZE))
+    {
+        return 1;
+    }
+
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+
+    if(pthread_setaffinity_np(pool->workers[worker].thread, sizeof(cpus), &cpus))
+    {
+        return 1;
+    }
+
+    return 0;
+#else
+    (void) pool;
+    (void) worker;
+    (void) cpu;
+
+    return 2;
+#endif /* __linux__ */
+}
+
+lfft_errno lfft_pool_submit(lfft_Pool * pool, lfft_PoolFunction function, void * argument)
+{
+    lfft_PoolTask task;
+
+    task.function = function;
+    task.argument = argument;
+
+    // the task is queued and counted with pool->mutex locked, so a worker
+    // can't finish the task before it is counted
+    pthread_mutex_lock(&pool->mutex);
+
+    if(_lfft_pool_push(&pool->workers[pool->next_worker], task))
+    {
+        pthread_mutex_unlock(&pool->mutex);
+        return 3;
+    }
+
+    // distribute the tasks round robin, idle workers steal the rest
+    pool->next_worker = (pool->next_worker+1)%pool->threads;
+    pool->queued++;
+    pool->pending++;
+
+    pthread_cond_signal(&pool->work);
+    pthread_mutex_unlock(&pool->mutex);
+
+    return 0;
+}
+
+void lfft_pool_wait(lfft_Pool * pool)
+{
+    pthread_mutex_lock(&pool->mutex);
+    while(pool->pending > 0)
+    {
+        pthread_cond_wait(&pool->done, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+lfft_errno lfft_pool_fft_batch(lfft_Pool * pool, const lfft_Fft * fft, uint32_t count,
+        const int32_t real[], const int32_t imag[], uint32_t in_stride,
+        int32_t result_real[], int32_t result_imag[], uint32_t out_stride, bool calculate_ifft)
+{
+    uint32_t i;
+    uint32_t tasks;
+    uint32_t chunk;
+    _lfft_PoolBatch * batches;
+    lfft_errno error = 0;
+
+    if(pool->workspace_size < LFFT_BATCH_WORKSPACE(fft->samples)*sizeof(int32_t))
+    {
+        return 2;
+    }
+
+    if(count == 0)
+    {
+        return 0;
+    }
+
+    // about 4 tasks per worker leave enough tasks to steal if the workers
+    // are not equally fast; every task contains full batches of signals
+    chunk = (count+4*pool->threads-1)/(4*pool->threads);
+    chunk = ((chunk+LFFT_BATCH_LANES-1)/LFFT_BATCH_LANES)*LFFT_BATCH_LANES;
+    tasks = (count+chunk-1)/chunk;
+
+    batches = (_lfft_PoolBatch *) malloc(tasks*sizeof(_lfft_PoolBatch));
+    if(batches == NULL)
+    {
+        return 3;
+    }
+
+    for(i = 0; i < tasks; i++)
+    {
+        batches[i].fft = fft;
+        batches[i].count = (count-i*chunk < chunk) ? count-i*chunk : chunk;
+        batches[i].real = &real[(size_t) i*chunk*in_stride];
+        batches[i].imag = (imag == NULL) ? NULL : &imag[(size_t) i*chunk*in_stride];
+        batches[i].in_stride = in_stride;
+        batches[i].result_real = &result_real[(size_t) i*chunk*out_stride];
+        batches[i].result_imag = &result_imag[(size_t) i*chunk*out_stride];
+        batches[i].out_stride = out_stride;
+        batches[i].calculate_ifft = calculate_ifft;
+
+        if(lfft_pool_submit(pool, _lfft_pool_batch_task, &batches[i]))
+        {
+            error = 3;
+            break;
+        }
+    }
+
+    // the submitted tasks use batches, even if not all tasks were submitted
+    lfft_pool_wait(pool);
+    free(batches);
+
+    return error;
+}
+
+lfft_errno lfft_pool_fft2(lfft_Pool * pool, lfft_Fft2 fft2[], int32_t ** real[], int32_t ** imag[],
+        uint32_t count, bool calculate_ifft2)
+{
+    uint32_t i;
+    _lfft_PoolFft2 * jobs;
+    lfft_errno error = 0;
+
+    if(count == 0)
+    {
+        return 0;
+    }
+
+    jobs = (_lfft_PoolFft2 *) malloc(count*sizeof(_lfft_PoolFft2));
+    if(jobs == NULL)
+    {
+        return 3;
+    }
+
+    for(i = 0; i < count; i++)
+    {
+        jobs[i].fft2 = &fft2[i];
+        jobs[i].real = real[i];
+        jobs[i].imag = (imag == NULL) ? NULL : imag[i];
+        jobs[i].calculate_ifft2 = calculate_ifft2;
+
+        if(lfft_pool_submit(pool, _lfft_pool_fft2_task, &jobs[i]))
+        {
+            error = 3;
+            break;
+        }
+    }
+
+    lfft_pool_wait(pool);
+    free(jobs);
+
+    return error;
+}
+
+lfft_errno lfft_pool_large_fft(lfft_Pool * pool, lfft_Large * large,
+        const int32_t real[], const int32_t imag[], bool calculate_ifft)
+{
+    uint32_t i;
+    uint32_t rows[2];
+    uint32_t chunk;
+    uint32_t tasks;
+    uint8_t pass;
+    _lfft_PoolLarge * jobs;
+    lfft_errno error = 0;
+
+    if(pool->workspace_size < LFFT_LARGE_WORKSPACE(large)*sizeof(int32_t))
+    {
+        return 2;
+    }
+
+    rows[0] = large->samples_1;
+    rows[1] = large->samples_2;
+
+    // enough tasks for the larger pass
+    jobs = (_lfft_PoolLarge *) malloc(4*pool->threads*sizeof(_lfft_PoolLarge));
+    if(jobs == NULL)
+    {
+        return 3;
+    }
+
+    // pass 1 needs the complete result of pass 0
+    for(pass = 0; (pass < 2)&&(error == 0); pass++)
+    {
+        // about 4 tasks per worker with full blocks of rows
+        chunk = (rows[pass]+4*pool->threads-1)/(4*pool->threads);
+        chunk = ((chunk+LFFT_LARGE_BLOCK-1)/LFFT_LARGE_BLOCK)*LFFT_LARGE_BLOCK;
+        tasks = (rows[pass]+chunk-1)/chunk;
+
+        for(i = 0; i < tasks; i++)
+        {
+            jobs[i].large = large;
+            jobs[i].pass = pass;
+            jobs[i].first = i*chunk;
+            jobs[i].rows = (rows[pass]-i*chunk < chunk) ? rows[pass]-i*chunk : chunk;
+            jobs[i].real = real;
+            jobs[i].imag = imag;
+            jobs[i].calculate_ifft = calculate_ifft;
+
+            if(lfft_pool_submit(pool, _lfft_pool_large_task, &jobs[i]))
+            {
+                error = 3;
+                break;
+            }
+        }
+
+        lfft_pool_wait(pool);
+    }
+
+    free(jobs);
+
+    return error;
+}
+
+static void * _lfft_pool_worker(void * argument)
+{
+    lfft_PoolWorker * worker = (lfft_PoolWorker *) argument;
+    lfft_Pool * pool = worker->pool;
+    lfft_PoolTask task;
+
+    for(;;)
+    {
+        if(_lfft_pool_take(worker, &task))
+        {
+            task.function(task.argument, worker->workspace);
+
+            pthread_mutex_lock(&pool->mutex);
+            pool->pending--;
+            if(pool->pending == 0)
+            {
+                pthread_cond_broadcast(&pool->done);
+            }
+            pthread_mutex_unlock(&pool->mutex);
+            continue;
+        }
+
+        // sleep until a task is submitted; queued tasks are calculated
+        // before the worker quits
+        pthread_mutex_lock(&pool->mutex);
+        while((pool->queued == 0)&&(!pool->stop))
+        {
+            pthread_cond_wait(&pool->work, &pool->mutex);
+        }
+        if((pool->queued == 0)&&pool->stop)
+        {
+            pthread_mutex_unlock(&pool->mutex);
+            break;
+        }
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    return NULL;
+}
+
+static bool _lfft_pool_take(lfft_PoolWorker * worker, lfft_PoolTask * task)
+{
+    lfft_Pool * pool = worker->pool;
+    lfft_PoolWorker * victim;
+    uint16_t i;
+    bool found = false;
+
+    // newest task of the own queue, its data is probably still cached
+    pthread_mutex_lock(&worker->mutex);
+    if(worker->count > 0)
+    {
+        worker->count--;
+        *task = worker->tasks[(worker->first+worker->count)%worker->capacity];
+        found = true;
+    }
+    pthread_mutex_unlock(&worker->mutex);
+
+    // steal the oldest task of another worker
+    for(i = 1; (i < pool->threads)&&(!found); i++)
+    {
+        victim = &pool->workers[(worker->index+i)%pool->threads];
+
+        pthread_mutex_lock(&victim->mutex);
+        if(victim->count > 0)
+        {
+            *task = victim->tasks[victim->first];
+            victim->first = (victim->first+1)%victim->capacity;
+            victim->count--;
+            found = true;
+        }
+        pthread_mutex_unlock(&victim->mutex);
+    }
+
+    if(found)
+    {
+        pthread_mutex_lock(&pool->mutex);
+        pool->queued--;
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    return found;
+}
+
+static lfft_errno _lfft_pool_push(lfft_PoolWorker * worker, lfft_PoolTask task)
+{
+    uint32_t i;
+    lfft_PoolTask * tasks;
+
+    pthread_mutex_lock(&worker->mutex);
+
+    if(worker->count == worker->capacity)
+    {
+        // double the capacity and unwrap the ring buffer
+        tasks = (lfft_PoolTask *) malloc(2*worker->capacity*sizeof(lfft_PoolTask));
+        if(tasks == NULL)
+        {
+            pthread_mutex_unlock(&worker->mutex);
+            return 3;
+        }
+        for(i = 0; i < worker->count; i++)
+        {
+            tasks[i] = worker->tasks[(worker->first+i)%worker->capacity];
+        }
+        free(worker->tasks);
+        worker->tasks = tasks;
+        worker->first = 0;
+        worker->capacity *= 2;
+    }
+
+    worker->tasks[(worker->first+worker->count)%worker->capacity] = task;
+    worker->count++;
+
+    pthread_mutex_unlock(&worker->mutex);
+
+    return 0;
+}
+
+static void _lfft_pool_batch_task(void * argument, void * workspace)
+{
+    _lfft_PoolBatch * batch = (_lfft_PoolBatch *) argument;
+
+    _lfft_fft_batch_calculation(batch->fft, batch->count, batch->real, batch->imag, batch->in_stride,
+            batch->result_real, batch->result_imag, batch->out_stride, batch->calculate_ifft,
+            (int32_t *) workspace);
+}
+
+static void _lfft_pool_fft2_task(void * argument, void * workspace)
+{
+    _lfft_PoolFft2 * job = (_lfft_PoolFft2 *) argument;
+
+    (void) workspace;
+
+    if(job->calculate_ifft2)
+    {
+        if(job->imag == NULL)
+        {
+            lfft_ifft2(job->fft2, job->real);
+        }
+        else
+        {
+            lfft_ifft2_complex(job->fft2, job->real, job->imag);
+        }
+    }
+    else
+    {
+        if(job->imag == NULL)
+        {
+            lfft_fft2(job->fft2, job->real);
+        }
+        else
+        {
+            lfft_fft2_complex(job->fft2, job->real, job->imag);
+        }
+    }
+}
+
+static void _lfft_pool_large_task(void * argument, void * workspace)
+{
+    _lfft_PoolLarge * job = (_lfft_PoolLarge *) argument;
+
+    _lfft_large_pass(job->large, job->pass, job->first, job->rows,
+            job->real, job->imag, job->calculate_ifft, (int32_t *) workspace);
+}
+
+static void _lfft_pool_stop(lfft_Pool * pool, uint16_t threads)
+{
+    uint16_t i;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for(i = 0; i < threads; i++)
+    {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+
+    for(i = 0; i < pool->threads; i++)
+    {
+        pthread_mutex_destroy(&pool->workers[i].mutex);
+        free(pool->workers[i].tasks);
+        free(pool->workers[i].workspace);
+    }
+
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->work);
+    pthread_cond_destroy(&pool->done);
+    free(pool->workers);
+}
@@ -0,0 +1,197 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains a thread pool to calculate many independent ffts on
+ * several cores. Every worker has its own task queue and workspace; a worker
+ * without tasks steals tasks from the queues of the other workers.
+ * The thread pool uses pthreads and is only built with the cmake option
+ * ENABLE_THREADS, it isn't included by lfft.h.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#ifndef _LFFT_POOL_H
+#define _LFFT_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lfft_config.h"
+#include "lfft_fft.h"
+#include "lfft_fft2.h"
+#include "lfft_large.h"
+
+#include <pthread.h>
+#include <stddef.h>
+
+/*!
+ * function of a task
+ * \param argument argument which was passed to lfft_pool_submit()
+ * \param workspace workspace of the worker which calculates the task
+ */
+typedef void (*lfft_PoolFunction)(void * argument, void * workspace);
+
+typedef struct _lfft_PoolTask
+{
+    lfft_PoolFunction function; //!< function of the task
+    void * argument; //!< argument of the function
+} lfft_PoolTask;
+
+typedef struct _lfft_PoolWorker
+{
+    pthread_t thread; //!< thread of the worker
+    pthread_mutex_t mutex; //!< mutex of the task queue
+
+    lfft_PoolTask * tasks; //!< ring buffer with the queued tasks
+    uint32_t capacity; //!< number of elements of tasks
+    uint32_t first; //!< index of the oldest task
+    uint32_t count; //!< number of queued tasks
+
+    void * workspace; //!< workspace of the worker
+    struct _lfft_Pool * pool; //!< pool of the worker
+    uint16_t index; //!< index of the worker in the pool
+} lfft_PoolWorker;
+
+typedef struct _lfft_Pool
+{
+    uint16_t threads; //!< number of worker threads
+    size_t workspace_size; //!< bytes of the workspace of every worker
+    lfft_PoolWorker * workers; //!< workers of the pool
+
+    pthread_mutex_t mutex; //!< mutex of the counters and conditions
+    pthread_cond_t work; //!< signaled if tasks are submitted or the pool stops
+    pthread_cond_t done; //!< signaled if all tasks are finished
+
+    uint32_t queued; //!< number of tasks which are not started yet
+    uint32_t pending; //!< number of tasks which are not finished yet
+    uint16_t next_worker; //!< worker which gets the next submitted task
+    bool stop; //!< true if the workers have to quit
+} lfft_Pool;
+
+/*!
+ * Initializes the thread pool and starts the worker threads.
+ * \param pool pointer to struct to be initialized
+ * \param threads number of worker threads; 0 to use one thread per online cpu
+ * \param workspace_size bytes of the workspace of every worker; see
+ *        lfft_pool_fft_batch() for the size needed by the batch functions
+ * \return 0: successful 1: a thread can't be started 3: not enough memory
+ */
+lfft_errno lfft_pool_new(lfft_Pool * pool, uint16_t threads, size_t workspace_size);
+
+/*!
+ * Calculates the remaining tasks, stops the worker threads and deallocates
+ * the used memory.
+ * \param pool initialized lfft_Pool struct
+ */
+void lfft_pool_delete(lfft_Pool * pool);
+
+/*!
+ * Binds a worker thread to a cpu.
+ * \param pool initialized lfft_Pool struct
+ * \param worker index of the worker, smaller than pool->threads
+ * \param cpu index of the cpu
+ * \return 0: successful 1: invalid worker or cpu 2: not supported by the system
+ */
+lfft_errno lfft_pool_set_affinity(lfft_Pool * pool, uint16_t worker, uint16_t cpu);
+
+/*!
+ * Submits a task. The task is calculated by one of the workers as soon as
+ * possible, use lfft_pool_wait() to wait until it is finished.
+ * Tasks must not submit tasks to the same pool.
+ * \param pool initialized lfft_Pool struct
+ * \param function function of the task
+ * \param argument argument of the function; must be valid until the task is finished
+ * \return 0: successful 3: not enough memory
+ */
+lfft_errno lfft_pool_submit(lfft_Pool * pool, lfft_PoolFunction function, void * argument);
+
+/*!
+ * Waits until all submitted tasks are finished.
+ * \param pool initialized lfft_Pool struct
+ */
+void lfft_pool_wait(lfft_Pool * pool);
+
+/*!
+ * Calculates the fft or ifft of count signals with the workers of the pool and
+ * waits until all of them are finished. See lfft_fft_batch() for the layout of
+ * the data. The workspace of every worker needs
+ * LFFT_BATCH_WORKSPACE(fft->samples)*sizeof(int32_t) bytes.
+ * \param pool initialized lfft_Pool struct
+ * \param fft initialized lfft_Fft struct
+ * \param count number of signals
+ * \param real real input data; must not overlap with the result
+ * \param imag imaginary input data; must not overlap with the result; NULL if the imaginary part is 0
+ * \param in_stride distance between the first samples of two signals
+ * \param result_real array for the real results
+ * \param result_imag array for the imaginary results
+ * \param out_stride distance between the first results of two signals
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ * \return 0: successful 2: workspace of the workers is too small 3: not enough memory
+ */
+lfft_errno lfft_pool_fft_batch(lfft_Pool * pool, const lfft_Fft * fft, uint32_t count,
+        const int32_t real[], const int32_t imag[], uint32_t in_stride,
+        int32_t result_real[], int32_t result_imag[], uint32_t out_stride, bool calculate_ifft);
+
+/*!
+ * Calculates the 2D-fft or 2D-ifft of count independent lfft_Fft2 structs with
+ * the workers of the pool and waits until all of them are finished. The
+ * results are stored in the structs. The workers don't need a workspace.
+ * \param pool initialized lfft_Pool struct
+ * \param fft2 count initialized lfft_Fft2 structs
+ * \param real 2D-real input data of every struct
+ * \param imag 2D-imaginary input data of every struct; NULL if the imaginary part is 0
+ * \param count number of 2D-ffts
+ * \param calculate_ifft2 false to calculate 2D-fft, true to calculate 2D-ifft
+ * \return 0: successful 3: not enough memory
+ */
+lfft_errno lfft_pool_fft2(lfft_Pool * pool, lfft_Fft2 fft2[], int32_t ** real[], int32_t ** imag[],
+        uint32_t count, bool calculate_ifft2);
+
+/*!
+ * Calculates a large fft or ifft with the workers of the pool and waits until
+ * it is finished. The small ffts of each pass of the six-step algorithm are
+ * distributed to the workers. The workspace of every worker needs
+ * LFFT_LARGE_WORKSPACE(large)*sizeof(int32_t) bytes.
+ * See lfft_large_fft().
+ * \param pool initialized lfft_Pool struct
+ * \param large initialized lfft_Large struct
+ * \param real real input data
+ * \param imag imaginary input data; NULL if the imaginary part is 0
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ * \return 0: successful 2: workspace of the workers is too small 3: not enough memory
+ */
+lfft_errno lfft_pool_large_fft(lfft_Pool * pool, lfft_Large * large,
+        const int32_t real[], const int32_t imag[], bool calculate_ifft);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LFFT_POOL_H */
@@ -0,0 +1,617 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains functions to calculate only selected bins of the fft.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#include "lfft_pruned.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+/*!
+ * Creates the butterfly indices of every step of a pruned fft.
+ * \param samples number of samples of the fft
+ * \param bins bins which are calculated
+ * \param bin_count number of elements of bins
+ * \param butterflies pointer to the allocated butterfly indices
+ * \param step_offset pointer to the allocated start of every step in butterflies
+ * \return 0: successful 3: not enough memory
+ */
+static lfft_errno _lfft_pruned_butterflies(uint32_t samples, const uint32_t bins[], uint32_t bin_count,
+        uint32_t ** butterflies, uint32_t ** step_offset);
+
+/*!
+ * Returns the number of butterflies of the pruned fft of the bins.
+ * \param samples number of samples of the fft
+ * \param bins bins which are calculated
+ * \param bin_count number of elements of bins
+ * \param marks samples/2+1 elements of memory
+ * \return number of butterflies
+ */
+static uint32_t _lfft_pruned_count(uint32_t samples, const uint32_t bins[], uint32_t bin_count, uint8_t marks[]);
+
+/*!
+ * Returns the bins of the fft of half the size which are needed for the bins
+ * of the real fft, see _lfft_rfft_calculation().
+ * \param samples number of input samples; at least 2
+ * \param bins bins of the real fft
+ * \param bin_count number of elements of bins
+ * \param half_bins 2*bin_count elements for the bins of the fft of half the size
+ */
+static void _lfft_pruned_half_bins(uint32_t samples, const uint32_t bins[], uint32_t bin_count, uint32_t half_bins[]);
+
+/*!
+ * Calculates the butterflies of a pruned fft with reordered input data.
+ * \param pruned initialized lfft_Pruned struct
+ * \param samples number of samples of the fft
+ * \param butterflies butterfly indices of every step
+ * \param step_offset start of every step in butterflies
+ * \param real real part of reordered data
+ * \param imag imaginary part of reordered data
+ */
+static void _lfft_pruned_calculation(const lfft_Pruned * pruned, uint32_t samples,
+        const uint32_t butterflies[], const uint32_t step_offset[], int32_t real[], int32_t imag[]);
+
+/*!
+ * Calculates the selected bins of complex input data with the pruned fft.
+ * \param pruned initialized lfft_Pruned struct
+ * \param real real part of integer input data
+ * \param imag imaginary part of integer input data; NULL for real input data
+ */
+static void _lfft_pruned_fft(lfft_Pruned * pruned, const int32_t real[], const int32_t imag[]);
+
+/*!
+ * Calculates the selected bins of real input data with the pruned real fft
+ * of half the size, see lfft_rfft().
+ * \param pruned initialized lfft_Pruned struct
+ * \param real integer input data
+ */
+static void _lfft_pruned_rfft(lfft_Pruned * pruned, const int32_t real[]);
+
+/*!
+ * Calculates the selected bins with the goertzel algorithm.
+ * \param pruned initialized lfft_Pruned struct
+ * \param real real part of integer input data
+ * \param imag imaginary part of integer input data; NULL for real input data
+ */
+static void _lfft_pruned_goertzel(lfft_Pruned * pruned, const int32_t real[], const int32_t imag[]);
+
+/*!
+ * Returns (x*coefficient)>>LFFT_GOERTZEL_BITS without overflow of the
+ * product if |x| < 2^46.
+ * \param x value
+ * \param coefficient value with LFFT_GOERTZEL_BITS decimal places
+ * \return rounded product
+ */
+static int64_t _lfft_goertzel_multiply(int64_t x, int32_t coefficient);
+
+lfft_errno lfft_pruned_new(lfft_Pruned * pruned, uint32_t samples, const uint32_t bins[], uint32_t bin_count)
+{
+    return lfft_pruned_new_pruning(pruned, samples, bins, bin_count, LFFT_PRUNING_AUTO);
+}
+
+lfft_errno lfft_pruned_new_pruning(lfft_Pruned * pruned, uint32_t samples, const uint32_t bins[], uint32_t bin_count,
+        lfft_Pruning pruning)
+{
+    uint32_t i;
+    uint8_t * marks;
+    uint32_t * half_bins;
+    uint64_t fft_cost;
+    uint64_t goertzel_cost;
+    lfft_errno error;
+    double angle;
+
+    // samples is not to the power of 2
+    if((samples == 0)||(samples&(samples-1)))
+    {
+        return 1;
+    }
+
+    if((bin_count == 0)||(pruning > LFFT_PRUNING_GOERTZEL))
+    {
+        return 2;
+    }
+
+    for(i = 0; i < bin_count; i++)
+    {
+        if(bins[i] >= samples)
+        {
+            return 2;
+        }
+    }
+
+    pruned->plan = lfft_plan_acquire(samples);
+    if(pruned->plan == NULL)
+    {
+        return 3;
+    }
+
+    pruned->samples          = samples;
+    pruned->steps            = pruned->plan->steps;
+    pruned->bin_count        = bin_count;
+    pruned->butterflies      = NULL;
+    pruned->step_offset      = NULL;
+    pruned->real_butterflies = NULL;
+    pruned->real_step_offset = NULL;
+    pruned->coefficients     = NULL;
+    pruned->workspace        = NULL;
+
+    // allocate memory
+    pruned->bins        = (uint32_t *) malloc(bin_count*sizeof(uint32_t));
+    pruned->result_real = (int32_t *)  calloc(bin_count, sizeof(int32_t));
+    pruned->result_imag = (int32_t *)  calloc(bin_count, sizeof(int32_t));
+    half_bins           = (uint32_t *) malloc(2*bin_count*sizeof(uint32_t));
+    marks               = (uint8_t *)  malloc(samples/2+1);
+
+    if((pruned->bins == NULL)||(pruned->result_real == NULL)||(pruned->result_imag == NULL)||
+            (half_bins == NULL)||(marks == NULL))
+    {
+        free(half_bins);
+        free(marks);
+        lfft_pruned_delete(pruned);
+        return 3;
+    }
+
+    for(i = 0; i < bin_count; i++)
+    {
+        pruned->bins[i] = bins[i];
+    }
+
+    // the pruned fft reorders all samples and calculates its butterflies,
+    // the goertzel algorithm iterates over all samples for every bin
+    fft_cost = samples;
+
+    // the real fft of half the size is used for real input data
+    if(samples > 1)
+    {
+        _lfft_pruned_half_bins(samples, bins, bin_count, half_bins);
+        if(pruning == LFFT_PRUNING_AUTO)
+        {
+            fft_cost += _lfft_pruned_count(samples/2, half_bins, 2*bin_count, marks)+bin_count;
+        }
+    }
+
+    if(pruning == LFFT_PRUNING_AUTO)
+    {
+        goertzel_cost = (uint64_t) bin_count*samples*LFFT_GOERTZEL_COST;
+
+        pruning = (goertzel_cost < fft_cost) ? LFFT_PRUNING_GOERTZEL : LFFT_PRUNING_FFT;
+    }
+    pruned->pruning = pruning;
+    free(marks);
+
+    if(pruning == LFFT_PRUNING_FFT)
+    {
+        pruned->workspace = (int32_t *) malloc(2*samples*sizeof(int32_t));
+        error = (pruned->workspace == NULL) ? 3 :
+                _lfft_pruned_butterflies(samples, bins, bin_count, &pruned->butterflies, &pruned->step_offset);
+        if((error == 0)&&(samples > 1))
+        {
+            error = _lfft_pruned_butterflies(samples/2, half_bins, 2*bin_count,
+                    &pruned->real_butterflies, &pruned->real_step_offset);
+        }
+        free(half_bins);
+
+        if(error != 0)
+        {
+            lfft_pruned_delete(pruned);
+            return 3;
+        }
+        return 0;
+    }
+    free(half_bins);
+
+    pruned->coefficients = (int32_t *) malloc(3*bin_count*sizeof(int32_t));
+    if(pruned->coefficients == NULL)
+    {
+        lfft_pruned_delete(pruned);
+        return 3;
+    }
+
+    for(i = 0; i < bin_count; i++)
+    {
+        angle = (2.0*M_PI*bins[i])/samples;
+        pruned->coefficients[3*i]   = (int32_t) floor(2.0*cos(angle)*(1<<LFFT_GOERTZEL_BITS)+0.5);
+        pruned->coefficients[3*i+1] = (int32_t) floor(cos(angle)*(1<<LFFT_GOERTZEL_BITS)+0.5);
+        pruned->coefficients[3*i+2] = (int32_t) floor(sin(angle)*(1<<LFFT_GOERTZEL_BITS)+0.5);
+    }
+
+    return 0;
+}
+
+void lfft_pruned_delete(lfft_Pruned * pruned)
+{
+    lfft_plan_release(pruned->plan);
+    free(pruned->bins);
+    free(pruned->butterflies);
+    free(pruned->step_offset);
+    free(pruned->real_butterflies);
+    free(pruned->real_step_offset);
+    free(pruned->coefficients);
+    free(pruned->workspace);
+    free(pruned->result_real);
+    free(pruned->result_imag);
+}
+
+void lfft_pruned_fft(lfft_Pruned * pruned, const int32_t real[])
+{
+    if(pruned->pruning == LFFT_PRUNING_GOERTZEL)
+    {
+        _lfft_pruned_goertzel(pruned, real, NULL);
+    }
+    else if(pruned->samples == 1)
+    {
+        _lfft_pruned_fft(pruned, real, NULL);
+    }
+    else
+    {
+        _lfft_pruned_rfft(pruned, real);
+    }
+}
+
+void lfft_pruned_fft_complex(lfft_Pruned * pruned, const int32_t real[], const int32_t imag[])
+{
+    if(pruned->pruning == LFFT_PRUNING_GOERTZEL)
+    {
+        _lfft_pruned_goertzel(pruned, real, imag);
+    }
+    else
+    {
+        _lfft_pruned_fft(pruned, real, imag);
+    }
+}
+
+static lfft_errno _lfft_pruned_butterflies(uint32_t samples, const uint32_t bins[], uint32_t bin_count,
+        uint32_t ** butterflies, uint32_t ** step_offset)
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t count;
+    uint32_t space;
+    uint8_t * marks;
+
+    marks = (uint8_t *) malloc(samples/2+1);
+    *step_offset = (uint32_t *) malloc(33*sizeof(uint32_t));
+    if((marks == NULL)||(*step_offset == NULL))
+    {
+        free(marks);
+        return 3;
+    }
+
+    count = _lfft_pruned_count(samples, bins, bin_count, marks);
+    *butterflies = (uint32_t *) malloc((count+1)*sizeof(uint32_t));
+    if(*butterflies == NULL)
+    {
+        free(marks);
+        return 3;
+    }
+
+    // the butterfly with index j of the step with space is needed in every
+    // block of 2*space elements if a bin k satisfies k%space == j
+    count = 0;
+    for(i = 0, space = 1; space < samples; i++, space <<= 1)
+    {
+        (*step_offset)[i] = count;
+        for(j = 0; j < space; j++)
+        {
+            marks[j] = 0;
+        }
+        for(j = 0; j < bin_count; j++)
+        {
+            marks[bins[j]&(space-1)] = 1;
+        }
+        for(j = 0; j < space; j++)
+        {
+            if(marks[j])
+            {
+                (*butterflies)[count++] = j;
+            }
+        }
+    }
+    (*step_offset)[i] = count;
+
+    free(marks);
+    return 0;
+}
+
+static uint32_t _lfft_pruned_count(uint32_t samples, const uint32_t bins[], uint32_t bin_count, uint8_t marks[])
+{
+    uint32_t j;
+    uint32_t space;
+    uint32_t unique;
+    uint32_t count = 0;
+
+    for(space = 1; space < samples; space <<= 1)
+    {
+        for(j = 0; j < space; j++)
+        {
+            marks[j] = 0;
+        }
+        unique = 0;
+        for(j = 0; j < bin_count; j++)
+        {
+            unique += !marks[bins[j]&(space-1)];
+            marks[bins[j]&(space-1)] = 1;
+        }
+        // unique butterflies in every block of 2*space elements
+        count += unique*(samples/(2*space));
+    }
+
+    return count;
+}
+
+static void _lfft_pruned_half_bins(uint32_t samples, const uint32_t bins[], uint32_t bin_count, uint32_t half_bins[])
+{
+    uint32_t i;
+    uint32_t k;
+    uint32_t half = samples/2;
+
+    // X[k] needs Z[k] and Z[half-k], the bins above half are mirrored
+    for(i = 0; i < bin_count; i++)
+    {
+        k = (bins[i] <= half) ? bins[i] : samples-bins[i];
+        half_bins[2*i]   = k&(half-1);
+        half_bins[2*i+1] = (half-k)&(half-1);
+    }
+}
+
+static void _lfft_pruned_calculation(const lfft_Pruned * pruned, uint32_t samples,
+        const uint32_t butterflies[], const uint32_t step_offset[], int32_t real[], int32_t imag[])
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t k;
+    uint32_t n;
+    uint32_t space;
+    uint32_t butterfly_count;
+    const uint32_t * step_butterflies;
+    const int32_t * wk;
+
+    // temporary variables
+    int32_t real_1;
+    int32_t real_2;
+    int32_t imag_1;
+    int32_t imag_2;
+    int32_t wk_real;
+    int32_t wk_imag;
+
+    // the same butterflies as _lfft_fft_radix2()
+    for(i = 0, space = 1; space < samples; i++, space <<= 1)
+    {
+        wk = &pruned->plan->step_wk[LFFT_STEP_WK(space)];
+        step_butterflies = &butterflies[step_offset[i]];
+        butterfly_count = step_offset[i+1]-step_offset[i];
+
+        for(j = 0; j < samples; j += 2*space)
+        {
+            for(k = 0; k < butterfly_count; k++)
+            {
+                n = j+step_butterflies[k];
+
+                real_1 = real[n];
+                imag_1 = imag[n];
+                real_2 = real[n+space];
+                imag_2 = imag[n+space];
+                wk_real = wk[2*step_butterflies[k]];
+                wk_imag = wk[2*step_butterflies[k]+1];
+
+                real[n] = real_1+
+                        ((real_2*wk_real)>>LFFT_RHS_BITS)-
+                        ((imag_2*wk_imag)>>LFFT_RHS_BITS);
+                imag[n] = imag_1+
+                        ((imag_2*wk_real)>>LFFT_RHS_BITS)+
+                        ((real_2*wk_imag)>>LFFT_RHS_BITS);
+                real[n+space] = real_1-
+                        ((real_2*wk_real)>>LFFT_RHS_BITS)+
+                        ((imag_2*wk_imag)>>LFFT_RHS_BITS);
+                imag[n+space] = imag_1-
+                        ((imag_2*wk_real)>>LFFT_RHS_BITS)-
+                        ((real_2*wk_imag)>>LFFT_RHS_BITS);
+            }
+        }
+    }
+}
+
+static void _lfft_pruned_fft(lfft_Pruned * pruned, const int32_t real[], const int32_t imag[])
+{
+    uint32_t i;
+    uint32_t n;
+    int32_t * work_real = pruned->workspace;
+    int32_t * work_imag = &pruned->workspace[pruned->samples];
+
+    // every bin depends on all input samples, so all samples are reordered
+    for(i = 0; i < pruned->samples; i++)
+    {
+        n = pruned->plan->switching_table[i];
+        work_real[i] = real[n]<<LFFT_RHS_BITS;
+        work_imag[i] = (imag == NULL) ? 0 : imag[n]<<LFFT_RHS_BITS;
+    }
+
+    _lfft_pruned_calculation(pruned, pruned->samples, pruned->butterflies, pruned->step_offset, work_real, work_imag);
+
+    for(i = 0; i < pruned->bin_count; i++)
+    {
+        pruned->result_real[i] = work_real[pruned->bins[i]];
+        pruned->result_imag[i] = work_imag[pruned->bins[i]];
+    }
+}
+
+static void _lfft_pruned_rfft(lfft_Pruned * pruned, const int32_t real[])
+{
+    uint32_t i;
+    uint32_t k;
+    uint32_t n;
+    uint32_t half = pruned->samples/2;
+    int32_t * work_real = pruned->workspace;
+    int32_t * work_imag = &pruned->workspace[half];
+
+    // temporary variables
+    int32_t real_1;
+    int32_t real_2;
+    int32_t imag_1;
+    int32_t imag_2;
+    int32_t even_real;
+    int32_t even_imag;
+    int32_t odd_real;
+    int32_t odd_imag;
+    int32_t t_real;
+    int32_t t_imag;
+
+    // z[n] = x[2n]+j*x[2n+1], see _lfft_rfft_pack()
+    for(i = 0; i < half; i++)
+    {
+        n = pruned->plan->switching_table[2*i]<<1;
+        work_real[i] = real[n]<<LFFT_RHS_BITS;
+        work_imag[i] = real[n+1]<<LFFT_RHS_BITS;
+    }
+
+    _lfft_pruned_calculation(pruned, half, pruned->real_butterflies, pruned->real_step_offset, work_real, work_imag);
+
+    // the same combination as _lfft_rfft_calculation() for every bin
+    for(i = 0; i < pruned->bin_count; i++)
+    {
+        k = (pruned->bins[i] <= half) ? pruned->bins[i] : pruned->samples-pruned->bins[i];
+
+        if((k == 0)||(k == half))
+        {
+            pruned->result_real[i] = (k == 0) ? work_real[0]+work_imag[0] : work_real[0]-work_imag[0];
+            pruned->result_imag[i] = 0;
+            continue;
+        }
+
+        // X[half-k] is calculated with k' = half-k
+        n = (k <= half/2) ? k : half-k;
+        real_1 = work_real[n];
+        imag_1 = work_imag[n];
+        real_2 = work_real[half-n];
+        imag_2 = work_imag[half-n];
+
+        even_real = (real_1+real_2)>>1;
+        even_imag = (imag_1-imag_2)>>1;
+        odd_real  = (imag_1+imag_2)>>1;
+        odd_imag  = (real_2-real_1)>>1;
+
+        t_real = ((odd_real*pruned->plan->wk_real[n])>>LFFT_RHS_BITS)-
+                ((odd_imag*pruned->plan->wk_imag[n])>>LFFT_RHS_BITS);
+        t_imag = ((odd_imag*pruned->plan->wk_real[n])>>LFFT_RHS_BITS)+
+                ((odd_real*pruned->plan->wk_imag[n])>>LFFT_RHS_BITS);
+
+        if(n == k)
+        {
+            pruned->result_real[i] = even_real+t_real;
+            pruned->result_imag[i] = even_imag+t_imag;
+        }
+        else
+        {
+            pruned->result_real[i] = even_real-t_real;
+            pruned->result_imag[i] = t_imag-even_imag;
+        }
+
+        // the bins above half are the conjugated mirror, see _lfft_rfft_mirror()
+        if(pruned->bins[i] > half)
+        {
+            pruned->result_imag[i] = -pruned->result_imag[i];
+        }
+    }
+}
+
+static void _lfft_pruned_goertzel(lfft_Pruned * pruned, const int32_t real[], const int32_t imag[])
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t n;
+    uint32_t part;
+    uint32_t group;
+    int64_t x;
+    int32_t coefficient[LFFT_GOERTZEL_GROUP];
+    int64_t s_0;
+    int64_t s_1[2][LFFT_GOERTZEL_GROUP];
+    int64_t s_2[2][LFFT_GOERTZEL_GROUP];
+    const int32_t * data;
+
+    // the bins of a group are calculated at once, so the dependent
+    // multiplications of different bins overlap
+    for(i = 0; i < pruned->bin_count; i += LFFT_GOERTZEL_GROUP)
+    {
+        group = (pruned->bin_count-i < LFFT_GOERTZEL_GROUP) ? pruned->bin_count-i : LFFT_GOERTZEL_GROUP;
+        for(j = 0; j < group; j++)
+        {
+            coefficient[j] = pruned->coefficients[3*(i+j)];
+        }
+
+        // s[n] = x[n]+2*cos(w)*s[n-1]-s[n-2]
+        // real and imaginary part of the input are independent
+        for(part = 0; part < 2; part++)
+        {
+            data = (part == 0) ? real : imag;
+            for(j = 0; j < group; j++)
+            {
+                s_1[part][j] = 0;
+                s_2[part][j] = 0;
+            }
+
+            for(n = 0; (data != NULL)&&(n < pruned->samples); n++)
+            {
+                x = (int64_t) data[n]<<LFFT_RHS_BITS;
+                for(j = 0; j < group; j++)
+                {
+                    s_0 = x+_lfft_goertzel_multiply(s_1[part][j], coefficient[j])-s_2[part][j];
+                    s_2[part][j] = s_1[part][j];
+                    s_1[part][j] = s_0;
+                }
+            }
+        }
+
+        // X = cos(w)*s[N-1]-s[N-2]+j*sin(w)*s[N-1] for both parts
+        //   real = Re(X_real)-Im(X_imag)
+        //   imag = Im(X_real)+Re(X_imag)
+        for(j = 0; j < group; j++)
+        {
+            pruned->result_real[i+j] = (int32_t) (
+                    _lfft_goertzel_multiply(s_1[0][j], pruned->coefficients[3*(i+j)+1])-s_2[0][j]-
+                    _lfft_goertzel_multiply(s_1[1][j], pruned->coefficients[3*(i+j)+2]));
+            pruned->result_imag[i+j] = (int32_t) (
+                    _lfft_goertzel_multiply(s_1[0][j], pruned->coefficients[3*(i+j)+2])+
+                    _lfft_goertzel_multiply(s_1[1][j], pruned->coefficients[3*(i+j)+1])-s_2[1][j]);
+        }
+    }
+}
+
+static int64_t _lfft_goertzel_multiply(int64_t x, int32_t coefficient)
+{
+    // the product of the upper bits and the product of the lower 15 bits
+    // are added without the 64 bit overflow of x*coefficient
+    int64_t high = (x>>15)*coefficient;
+    int64_t low  = ((x&0x7FFF)*coefficient)>>15;
+
+    return (high+low+(1<<(LFFT_GOERTZEL_BITS-16)))>>(LFFT_GOERTZEL_BITS-15);
+}
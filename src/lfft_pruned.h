@@ -0,0 +1,151 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains functions to calculate only selected bins of the fft.
+ * The output pruned fft calculates the radix-2 butterflies which feed the
+ * selected bins: after the step with butterfly space h every block of 2*h
+ * elements contains the fft of a part of the input, so bin k only needs the
+ * butterflies with the index k%h in every block. The result is bit for bit
+ * the same as the result of lfft_fft_complex() with LFFT_KERNEL_RADIX_2.
+ * The goertzel algorithm calculates every bin with one real multiplication
+ * per input sample and doesn't need a workspace. lfft_pruned_new() selects
+ * the cheaper algorithm, see LFFT_GOERTZEL_COST. Real input data uses the
+ * pruned real fft of half the size, so the result is the same as the result
+ * of lfft_fft() with LFFT_KERNEL_RADIX_2.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#ifndef _LFFT_PRUNED_H
+#define _LFFT_PRUNED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lfft_config.h"
+#include "lfft_fft.h"
+
+/*!
+ * bits for decimal places of the coefficients of the goertzel algorithm
+ */
+#define LFFT_GOERTZEL_BITS 29
+
+/*!
+ * number of bins which are calculated at once by the goertzel algorithm
+ */
+#define LFFT_GOERTZEL_GROUP 4
+
+/*!
+ * cost of one goertzel iteration relative to a butterfly of the pruned fft
+ * (the goertzel algorithm needs two 64 bit multiplications per iteration);
+ * lfft_pruned_new() compares the costs of real input data
+ */
+#define LFFT_GOERTZEL_COST 2
+
+/*!
+ * Algorithms used for the calculation of the selected bins.
+ */
+typedef enum _lfft_Pruning
+{
+    LFFT_PRUNING_AUTO = 0, //!< the cheaper algorithm is selected by lfft_pruned_new()
+    LFFT_PRUNING_FFT = 1, //!< output pruned radix-2 fft
+    LFFT_PRUNING_GOERTZEL = 2 //!< goertzel algorithm for every bin
+} lfft_Pruning;
+
+typedef struct _lfft_Pruned
+{
+    uint32_t   samples; //!< number of samples
+    uint8_t    steps; //!< number of steps
+    uint32_t   bin_count; //!< number of calculated bins
+    uint8_t    pruning; //!< lfft_Pruning used for the calculation; never LFFT_PRUNING_AUTO
+
+    lfft_Plan * plan; //!< plan shared by all structs with the same number of samples
+    uint32_t * bins; //!< calculated bins
+    uint32_t * butterflies; //!< butterfly indices of every step of the pruned fft; NULL for LFFT_PRUNING_GOERTZEL
+    uint32_t * step_offset; //!< the butterflies of step i are butterflies[step_offset[i]..step_offset[i+1]-1]; NULL for LFFT_PRUNING_GOERTZEL
+    uint32_t * real_butterflies; //!< butterfly indices of the fft of half the size for real input data; NULL for LFFT_PRUNING_GOERTZEL
+    uint32_t * real_step_offset; //!< start of every step in real_butterflies; NULL for LFFT_PRUNING_GOERTZEL
+    int32_t  * coefficients; //!< 2*cos(2*pi*bins[i]/samples), cos and sin at 3*i with LFFT_GOERTZEL_BITS decimal places; NULL for LFFT_PRUNING_FFT
+    int32_t  * workspace; //!< 2*samples elements for LFFT_PRUNING_FFT; NULL otherwise
+
+    int32_t  * result_real; //!< real result of bins[i] at index i
+    int32_t  * result_imag; //!< imaginary result of bins[i] at index i
+} lfft_Pruned;
+
+/*!
+ * Initializes the calculation of selected bins with the cheaper algorithm.
+ * \param pruned pointer to struct to be initialized
+ * \param samples number of input samples; must be to the power of 2
+ * \param bins bins which are calculated
+ * \param bin_count number of elements of bins
+ * \return 0: successful 1: samples is not to the power of 2 2: a bin is not smaller than samples or bin_count is 0 3: not enough memory
+ */
+lfft_errno lfft_pruned_new(lfft_Pruned * pruned, uint32_t samples, const uint32_t bins[], uint32_t bin_count);
+
+/*!
+ * Initializes the calculation of selected bins with the given algorithm.
+ * \param pruned pointer to struct to be initialized
+ * \param samples number of input samples; must be to the power of 2
+ * \param bins bins which are calculated
+ * \param bin_count number of elements of bins
+ * \param pruning algorithm used for the calculation
+ * \return 0: successful 1: samples is not to the power of 2 2: a bin is not smaller than samples, bin_count is 0 or unknown pruning 3: not enough memory
+ */
+lfft_errno lfft_pruned_new_pruning(lfft_Pruned * pruned, uint32_t samples, const uint32_t bins[], uint32_t bin_count,
+        lfft_Pruning pruning);
+
+/*!
+ * Deallocate the used memory.
+ * \param pruned initialized lfft_Pruned struct
+ */
+void lfft_pruned_delete(lfft_Pruned * pruned);
+
+/*!
+ * Calculates the selected bins of the fft of real input data.
+ * The result is saved in pruned->result_real and pruned->result_imag.
+ * \param pruned initialized lfft_Pruned struct
+ * \param real integer input data
+ */
+void lfft_pruned_fft(lfft_Pruned * pruned, const int32_t real[]);
+
+/*!
+ * Calculates the selected bins of the fft of complex input data.
+ * The result is saved in pruned->result_real and pruned->result_imag.
+ * \param pruned initialized lfft_Pruned struct
+ * \param real real part of integer input data
+ * \param imag imaginary part of integer input data
+ */
+void lfft_pruned_fft_complex(lfft_Pruned * pruned, const int32_t real[], const int32_t imag[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LFFT_PRUNED_H */
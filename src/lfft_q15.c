@@ -0,0 +1,647 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains functions to calculate the fft with int16_t data in Q15
+ * format and block floating point scaling.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#include "lfft_q15.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#ifdef LFFT_USE_AVX2
+#include <immintrin.h>
+#endif /* LFFT_USE_AVX2 */
+
+/*!
+ * Calculates the fft or ifft into the arrays of q15.
+ * \param q15 initialized lfft_Q15 struct
+ * \param real real input data
+ * \param imag imaginary input data; NULL if the imaginary part is 0
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ */
+static void _lfft_q15_fft(lfft_Q15 * q15, const int16_t real[], const int16_t imag[], bool calculate_ifft);
+
+/*!
+ * Reorders the data in place by swapping the elements with the switching
+ * table.
+ * \param q15 initialized lfft_Q15 struct
+ * \param real real data
+ * \param imag imaginary data
+ */
+static void _lfft_q15_reorder(const lfft_Q15 * q15, int16_t real[], int16_t imag[]);
+
+/*!
+ * Calculates the rounding Q15 multiplication (a*b+2^14)>>15 like vpmulhrsw.
+ * \param a first factor
+ * \param b second factor
+ * \return product
+ */
+static int16_t _lfft_q15_mul(int16_t a, int16_t b);
+
+/*!
+ * Returns the largest absolute value of the block.
+ * \param real real data
+ * \param imag imaginary data
+ * \param samples number of elements
+ * \return largest absolute value of real and imag
+ */
+static int32_t _lfft_q15_max(const int16_t real[], const int16_t imag[], uint32_t samples);
+
+/*!
+ * Returns the shift of the input of a step, so that the largest absolute
+ * value divided by 2^shift with rounding (see _lfft_q15_scale()) is at most
+ * LFFT_Q15_HEADROOM.
+ * \param max largest absolute value of the input of the step
+ * \return number of bits; 0, 1 or 2
+ */
+static uint8_t _lfft_q15_shift(int32_t max);
+
+/*!
+ * Divides a value by 2^shift with rounding like _mm256_mulhrs_epi16() with
+ * 2^(15-shift).
+ * \param value value to be divided
+ * \param shift number of bits; 0, 1 or 2
+ * \return value/2^shift
+ */
+static int16_t _lfft_q15_scale(int16_t value, uint8_t shift);
+
+/*!
+ * Calculates one radix-2 step.
+ * The input of the step is divided by 2^shift before the butterflies.
+ * \param q15 initialized lfft_Q15 struct
+ * \param real real data; replaced by the result of the step
+ * \param imag imaginary data; replaced by the result of the step
+ * \param space space between the operants of the butterflies
+ * \param shift number of bits the input is shifted to the right; 0, 1 or 2
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ * \return largest absolute value of the result
+ */
+static int32_t _lfft_q15_step(const lfft_Q15 * q15, int16_t real[], int16_t imag[],
+        uint32_t space, uint8_t shift, bool calculate_ifft);
+
+#ifdef LFFT_USE_AVX2
+/*!
+ * Calculates 16 butterflies with AVX2 instructions.
+ * The result is bit for bit the same as the result of _lfft_q15_step().
+ * \param real_1 real values of the first operants; replaced by the sums
+ * \param imag_1 imaginary values of the first operants; replaced by the sums
+ * \param real_2 real values of the second operants; replaced by the differences
+ * \param imag_2 imaginary values of the second operants; replaced by the differences
+ * \param wk_real real wk values
+ * \param wk_imag imaginary wk values
+ * \param shift number of bits the operants are shifted to the right; 0, 1 or 2
+ * \param max largest absolute values as unsigned values; updated with the result
+ */
+static void _lfft_q15_butterflies_avx2(__m256i * real_1, __m256i * imag_1, __m256i * real_2, __m256i * imag_2,
+        __m256i wk_real, __m256i wk_imag, uint8_t shift, __m256i * max);
+
+/*!
+ * Calculates one radix-2 step with AVX2 instructions.
+ * 16 consecutive butterflies of a group are calculated at once.
+ * \param q15 initialized lfft_Q15 struct
+ * \param real real data; replaced by the result of the step
+ * \param imag imaginary data; replaced by the result of the step
+ * \param space space between the operants of the butterflies; at least 16
+ * \param shift number of bits the input is shifted to the right; 0, 1 or 2
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ * \return largest absolute value of the result
+ */
+static int32_t _lfft_q15_step_avx2(const lfft_Q15 * q15, int16_t real[], int16_t imag[],
+        uint32_t space, uint8_t shift, bool calculate_ifft);
+
+/*!
+ * Calculates one radix-2 step with less than 16 butterflies per group with
+ * AVX2 instructions.
+ * 32 samples are loaded and the first and second operants are separated by
+ * shuffling the elements inside the 128 bit lanes.
+ * \param q15 initialized lfft_Q15 struct; at least 32 samples
+ * \param real real data; replaced by the result of the step
+ * \param imag imaginary data; replaced by the result of the step
+ * \param space space between the operants of the butterflies; 1, 2, 4 or 8
+ * \param shift number of bits the input is shifted to the right; 0, 1 or 2
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ * \return largest absolute value of the result
+ */
+static int32_t _lfft_q15_step_avx2_small(const lfft_Q15 * q15, int16_t real[], int16_t imag[],
+        uint32_t space, uint8_t shift, bool calculate_ifft);
+
+/*!
+ * Returns the largest element of a vector of unsigned values.
+ * \param max vector of unsigned values
+ * \return largest element
+ */
+static int32_t _lfft_q15_max_avx2(__m256i max);
+#endif /* LFFT_USE_AVX2 */
+
+lfft_errno lfft_q15_new(lfft_Q15 * q15, uint32_t samples)
+{
+    uint32_t i;
+    uint32_t half;
+    double angle;
+
+    // samples is not to the power of 2
+    if((samples == 0)||(samples&(samples-1)))
+    {
+        return 1;
+    }
+
+    q15->plan = lfft_plan_acquire(samples);
+    if(q15->plan == NULL)
+    {
+        return 3;
+    }
+
+    q15->samples  = samples;
+    q15->steps    = q15->plan->steps;
+    q15->exponent = 0;
+
+    // allocate memory
+    q15->wk_real     = (int16_t *) calloc(samples, sizeof(int16_t));
+    q15->wk_imag     = (int16_t *) calloc(samples, sizeof(int16_t));
+    q15->result_real = (int16_t *) calloc(samples, sizeof(int16_t));
+    q15->result_imag = (int16_t *) calloc(samples, sizeof(int16_t));
+
+    if((q15->wk_real == NULL)||(q15->wk_imag == NULL)||(q15->result_real == NULL)||(q15->result_imag == NULL))
+    {
+        lfft_q15_delete(q15);
+        return 3;
+    }
+
+    // wk = e^(-j*2*pi*k/(2*half)) in Q15, 1.0 is rounded down to 32767
+    for(half = 1; half < samples; half <<= 1)
+    {
+        for(i = 0; i < half; i++)
+        {
+            angle = (M_PI*i)/half;
+            q15->wk_real[half+i] = (int16_t) floor(cos(angle)*32767.0+0.5);
+            q15->wk_imag[half+i] = (int16_t) floor(-sin(angle)*32767.0+0.5);
+        }
+    }
+
+    return 0;
+}
+
+void lfft_q15_delete(lfft_Q15 * q15)
+{
+    lfft_plan_release(q15->plan);
+    free(q15->wk_real);
+    free(q15->wk_imag);
+    free(q15->result_real);
+    free(q15->result_imag);
+}
+
+void lfft_q15_fft(lfft_Q15 * q15, const int16_t real[])
+{
+    _lfft_q15_fft(q15, real, NULL, false);
+}
+
+void lfft_q15_fft_complex(lfft_Q15 * q15, const int16_t real[], const int16_t imag[])
+{
+    _lfft_q15_fft(q15, real, imag, false);
+}
+
+void lfft_q15_ifft(lfft_Q15 * q15, const int16_t real[])
+{
+    _lfft_q15_fft(q15, real, NULL, true);
+}
+
+void lfft_q15_ifft_complex(lfft_Q15 * q15, const int16_t real[], const int16_t imag[])
+{
+    _lfft_q15_fft(q15, real, imag, true);
+}
+
+int8_t lfft_q15_fft_inplace(const lfft_Q15 * q15, int16_t real[], int16_t imag[])
+{
+    _lfft_q15_reorder(q15, real, imag);
+    return _lfft_q15_calculation(q15, real, imag, false);
+}
+
+int8_t lfft_q15_ifft_inplace(const lfft_Q15 * q15, int16_t real[], int16_t imag[])
+{
+    _lfft_q15_reorder(q15, real, imag);
+    return _lfft_q15_calculation(q15, real, imag, true);
+}
+
+float lfft_q15_result_real_float_at(const lfft_Q15 * q15, uint32_t n)
+{
+    return ldexpf((float) q15->result_real[n], q15->exponent);
+}
+
+float lfft_q15_result_imag_float_at(const lfft_Q15 * q15, uint32_t n)
+{
+    return ldexpf((float) q15->result_imag[n], q15->exponent);
+}
+
+int8_t _lfft_q15_calculation(const lfft_Q15 * q15, int16_t real[], int16_t imag[], bool calculate_ifft)
+{
+    uint8_t i;
+    uint8_t shift;
+    int32_t max;
+    int8_t exponent = 0;
+    uint32_t space = 1;
+
+    max = _lfft_q15_max(real, imag, q15->samples);
+
+    for(i = 0; i < q15->steps; i++)
+    {
+        // shift the block only if the butterflies could overflow
+        shift = _lfft_q15_shift(max);
+        exponent += shift;
+
+        // every step returns the largest value for the next step
+#ifdef LFFT_USE_AVX2
+        if(space >= 16)
+        {
+            max = _lfft_q15_step_avx2(q15, real, imag, space, shift, calculate_ifft);
+        }
+        else if(q15->samples >= 32)
+        {
+            max = _lfft_q15_step_avx2_small(q15, real, imag, space, shift, calculate_ifft);
+        }
+        else
+#endif /* LFFT_USE_AVX2 */
+        {
+            max = _lfft_q15_step(q15, real, imag, space, shift, calculate_ifft);
+        }
+
+        space <<= 1;
+    }
+
+    // ifft(x) = fft(x, conjugated wk)/samples
+    if(calculate_ifft)
+    {
+        exponent -= q15->steps;
+    }
+
+    return exponent;
+}
+
+static void _lfft_q15_fft(lfft_Q15 * q15, const int16_t real[], const int16_t imag[], bool calculate_ifft)
+{
+    uint32_t i;
+
+    // reorder the input data
+    for(i = 0; i < q15->samples; i++)
+    {
+        q15->result_real[i] = real[q15->plan->switching_table[i]];
+        q15->result_imag[i] = (imag == NULL) ? 0 : imag[q15->plan->switching_table[i]];
+    }
+
+    q15->exponent = _lfft_q15_calculation(q15, q15->result_real, q15->result_imag, calculate_ifft);
+}
+
+static void _lfft_q15_reorder(const lfft_Q15 * q15, int16_t real[], int16_t imag[])
+{
+    uint32_t i;
+    uint32_t j;
+    int16_t temp;
+
+    // the switching table is a permutation of pairs, every pair is swapped once
+    for(i = 0; i < q15->samples; i++)
+    {
+        j = q15->plan->switching_table[i];
+        if(i < j)
+        {
+            temp = real[i];
+            real[i] = real[j];
+            real[j] = temp;
+
+            temp = imag[i];
+            imag[i] = imag[j];
+            imag[j] = temp;
+        }
+    }
+}
+
+static int16_t _lfft_q15_mul(int16_t a, int16_t b)
+{
+    return (int16_t) ((((int32_t) a)*b+(1<<14))>>15);
+}
+
+static int32_t _lfft_q15_max(const int16_t real[], const int16_t imag[], uint32_t samples)
+{
+    uint32_t i;
+    int32_t value;
+    int32_t max = 0;
+
+    for(i = 0; i < samples; i++)
+    {
+        value = abs(real[i]);
+        max = (value > max) ? value : max;
+        value = abs(imag[i]);
+        max = (value > max) ? value : max;
+    }
+
+    return max;
+}
+
+static uint8_t _lfft_q15_shift(int32_t max)
+{
+    uint8_t shift = 0;
+
+    // the scaling rounds to nearest, e.g. 27145 is scaled to 13573 by 1 bit
+    while(((max+((1<<shift)>>1))>>shift) > LFFT_Q15_HEADROOM)
+    {
+        shift++;
+    }
+
+    return shift;
+}
+
+static int16_t _lfft_q15_scale(int16_t value, uint8_t shift)
+{
+    // (value*2^15+2^14)>>15 == value, so there is no need for a branch
+    return (int16_t) ((((int32_t) value)*(1<<(15-shift))+(1<<14))>>15);
+}
+
+static int32_t _lfft_q15_step(const lfft_Q15 * q15, int16_t real[], int16_t imag[],
+        uint32_t space, uint8_t shift, bool calculate_ifft)
+{
+    uint32_t j;
+    uint32_t k;
+    int32_t max = 0;
+    // local copies, the compiler can't know that the data doesn't overwrite the struct
+    uint32_t samples = q15->samples;
+    const int16_t * wk_real = &q15->wk_real[space];
+    const int16_t * wk_imag = &q15->wk_imag[space];
+    // -sin(x) == sin(-x)
+    int16_t wk_sign = calculate_ifft ? -1 : 1;
+
+    // temporary variables
+    int16_t real_1;
+    int16_t imag_1;
+    int16_t real_2;
+    int16_t imag_2;
+    int16_t real_wk;
+    int16_t imag_wk;
+    int16_t wk_imag_k;
+    int32_t value;
+
+    for(j = 0; j < samples; j += 2*space)
+    {
+        for(k = 0; k < space; k++)
+        {
+            wk_imag_k = wk_sign*wk_imag[k];
+
+            real_1 = _lfft_q15_scale(real[j+k], shift);
+            imag_1 = _lfft_q15_scale(imag[j+k], shift);
+            real_2 = _lfft_q15_scale(real[j+k+space], shift);
+            imag_2 = _lfft_q15_scale(imag[j+k+space], shift);
+
+            real_wk = _lfft_q15_mul(real_2, wk_real[k])-_lfft_q15_mul(imag_2, wk_imag_k);
+            imag_wk = _lfft_q15_mul(imag_2, wk_real[k])+_lfft_q15_mul(real_2, wk_imag_k);
+
+            real_2 = real_1-real_wk;
+            imag_2 = imag_1-imag_wk;
+            real_1 = real_1+real_wk;
+            imag_1 = imag_1+imag_wk;
+
+            real[j+k+space] = real_2;
+            imag[j+k+space] = imag_2;
+            real[j+k] = real_1;
+            imag[j+k] = imag_1;
+
+            value = abs(real_1);
+            max = (value > max) ? value : max;
+            value = abs(imag_1);
+            max = (value > max) ? value : max;
+            value = abs(real_2);
+            max = (value > max) ? value : max;
+            value = abs(imag_2);
+            max = (value > max) ? value : max;
+        }
+    }
+
+    return max;
+}
+
+#ifdef LFFT_USE_AVX2
+static void _lfft_q15_butterflies_avx2(__m256i * real_1, __m256i * imag_1, __m256i * real_2, __m256i * imag_2,
+        __m256i wk_real, __m256i wk_imag, uint8_t shift, __m256i * max)
+{
+    __m256i real_wk;
+    __m256i imag_wk;
+    __m256i factor;
+
+    // 2^15 is not an int16_t, so a shift of 0 bits is skipped
+    if(shift > 0)
+    {
+        factor = _mm256_set1_epi16((int16_t) (1<<(15-shift)));
+        *real_1 = _mm256_mulhrs_epi16(*real_1, factor);
+        *imag_1 = _mm256_mulhrs_epi16(*imag_1, factor);
+        *real_2 = _mm256_mulhrs_epi16(*real_2, factor);
+        *imag_2 = _mm256_mulhrs_epi16(*imag_2, factor);
+    }
+
+    real_wk = _mm256_sub_epi16(_mm256_mulhrs_epi16(*real_2, wk_real), _mm256_mulhrs_epi16(*imag_2, wk_imag));
+    imag_wk = _mm256_add_epi16(_mm256_mulhrs_epi16(*imag_2, wk_real), _mm256_mulhrs_epi16(*real_2, wk_imag));
+
+    *real_2 = _mm256_sub_epi16(*real_1, real_wk);
+    *imag_2 = _mm256_sub_epi16(*imag_1, imag_wk);
+    *real_1 = _mm256_add_epi16(*real_1, real_wk);
+    *imag_1 = _mm256_add_epi16(*imag_1, imag_wk);
+
+    // |-32768| is 0x8000 as unsigned value
+    *max = _mm256_max_epu16(*max, _mm256_abs_epi16(*real_1));
+    *max = _mm256_max_epu16(*max, _mm256_abs_epi16(*imag_1));
+    *max = _mm256_max_epu16(*max, _mm256_abs_epi16(*real_2));
+    *max = _mm256_max_epu16(*max, _mm256_abs_epi16(*imag_2));
+}
+
+static int32_t _lfft_q15_step_avx2(const lfft_Q15 * q15, int16_t real[], int16_t imag[],
+        uint32_t space, uint8_t shift, bool calculate_ifft)
+{
+    uint32_t j;
+    uint32_t k;
+
+    __m256i real_1;
+    __m256i imag_1;
+    __m256i real_2;
+    __m256i imag_2;
+    __m256i wk_real;
+    __m256i wk_imag;
+    __m256i max = _mm256_setzero_si256();
+
+    for(j = 0; j < q15->samples; j += 2*space)
+    {
+        for(k = 0; k < space; k += 16)
+        {
+            wk_real = _mm256_loadu_si256((const __m256i *) &q15->wk_real[space+k]);
+            wk_imag = _mm256_loadu_si256((const __m256i *) &q15->wk_imag[space+k]);
+            if(calculate_ifft)
+            {
+                wk_imag = _mm256_sub_epi16(_mm256_setzero_si256(), wk_imag);
+            }
+
+            real_1 = _mm256_loadu_si256((const __m256i *) &real[j+k]);
+            imag_1 = _mm256_loadu_si256((const __m256i *) &imag[j+k]);
+            real_2 = _mm256_loadu_si256((const __m256i *) &real[j+k+space]);
+            imag_2 = _mm256_loadu_si256((const __m256i *) &imag[j+k+space]);
+
+            _lfft_q15_butterflies_avx2(&real_1, &imag_1, &real_2, &imag_2, wk_real, wk_imag, shift, &max);
+
+            _mm256_storeu_si256((__m256i *) &real[j+k], real_1);
+            _mm256_storeu_si256((__m256i *) &imag[j+k], imag_1);
+            _mm256_storeu_si256((__m256i *) &real[j+k+space], real_2);
+            _mm256_storeu_si256((__m256i *) &imag[j+k+space], imag_2);
+        }
+    }
+
+    return _lfft_q15_max_avx2(max);
+}
+
+static int32_t _lfft_q15_step_avx2_small(const lfft_Q15 * q15, int16_t real[], int16_t imag[],
+        uint32_t space, uint8_t shift, bool calculate_ifft)
+{
+    uint32_t j;
+    uint32_t k;
+    int16_t wk_real_values[16];
+    int16_t wk_imag_values[16];
+
+    __m256i real_1;
+    __m256i imag_1;
+    __m256i real_2;
+    __m256i imag_2;
+    __m256i real_3;
+    __m256i imag_3;
+    __m256i wk_real;
+    __m256i wk_imag;
+    __m256i order;
+    __m256i max = _mm256_setzero_si256();
+
+    // the element k of every group uses the same wk value
+    for(k = 0; k < 16; k++)
+    {
+        wk_real_values[k] = q15->wk_real[space+(k&(space-1))];
+        wk_imag_values[k] = calculate_ifft ? -q15->wk_imag[space+(k&(space-1))] : q15->wk_imag[space+(k&(space-1))];
+    }
+    wk_real = _mm256_loadu_si256((const __m256i *) wk_real_values);
+    wk_imag = _mm256_loadu_si256((const __m256i *) wk_imag_values);
+
+    // moves the first operants of a lane to the lower and the second operants to the upper 64 bits
+    if(space == 1)
+    {
+        order = _mm256_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15,
+                0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+    }
+    else
+    {
+        order = _mm256_setr_epi8(0, 1, 2, 3, 8, 9, 10, 11, 4, 5, 6, 7, 12, 13, 14, 15,
+                0, 1, 2, 3, 8, 9, 10, 11, 4, 5, 6, 7, 12, 13, 14, 15);
+    }
+
+    for(j = 0; j < q15->samples; j += 32)
+    {
+        real_1 = _mm256_loadu_si256((const __m256i *) &real[j]);
+        imag_1 = _mm256_loadu_si256((const __m256i *) &imag[j]);
+        real_3 = _mm256_loadu_si256((const __m256i *) &real[j+16]);
+        imag_3 = _mm256_loadu_si256((const __m256i *) &imag[j+16]);
+
+        // separate the first and the second operants
+        if(space == 8)
+        {
+            real_2 = _mm256_permute2x128_si256(real_1, real_3, 0x31);
+            imag_2 = _mm256_permute2x128_si256(imag_1, imag_3, 0x31);
+            real_1 = _mm256_permute2x128_si256(real_1, real_3, 0x20);
+            imag_1 = _mm256_permute2x128_si256(imag_1, imag_3, 0x20);
+        }
+        else
+        {
+            if(space < 4)
+            {
+                real_1 = _mm256_shuffle_epi8(real_1, order);
+                imag_1 = _mm256_shuffle_epi8(imag_1, order);
+                real_3 = _mm256_shuffle_epi8(real_3, order);
+                imag_3 = _mm256_shuffle_epi8(imag_3, order);
+            }
+            real_2 = _mm256_unpackhi_epi64(real_1, real_3);
+            imag_2 = _mm256_unpackhi_epi64(imag_1, imag_3);
+            real_1 = _mm256_unpacklo_epi64(real_1, real_3);
+            imag_1 = _mm256_unpacklo_epi64(imag_1, imag_3);
+        }
+
+        _lfft_q15_butterflies_avx2(&real_1, &imag_1, &real_2, &imag_2, wk_real, wk_imag, shift, &max);
+
+        // restore the order of the elements
+        switch(space)
+        {
+            case 1:
+                real_3 = _mm256_unpackhi_epi16(real_1, real_2);
+                imag_3 = _mm256_unpackhi_epi16(imag_1, imag_2);
+                real_1 = _mm256_unpacklo_epi16(real_1, real_2);
+                imag_1 = _mm256_unpacklo_epi16(imag_1, imag_2);
+                break;
+            case 2:
+                real_3 = _mm256_unpackhi_epi32(real_1, real_2);
+                imag_3 = _mm256_unpackhi_epi32(imag_1, imag_2);
+                real_1 = _mm256_unpacklo_epi32(real_1, real_2);
+                imag_1 = _mm256_unpacklo_epi32(imag_1, imag_2);
+                break;
+            case 4:
+                real_3 = _mm256_unpackhi_epi64(real_1, real_2);
+                imag_3 = _mm256_unpackhi_epi64(imag_1, imag_2);
+                real_1 = _mm256_unpacklo_epi64(real_1, real_2);
+                imag_1 = _mm256_unpacklo_epi64(imag_1, imag_2);
+                break;
+            default:
+                real_3 = _mm256_permute2x128_si256(real_1, real_2, 0x31);
+                imag_3 = _mm256_permute2x128_si256(imag_1, imag_2, 0x31);
+                real_1 = _mm256_permute2x128_si256(real_1, real_2, 0x20);
+                imag_1 = _mm256_permute2x128_si256(imag_1, imag_2, 0x20);
+                break;
+        }
+
+        _mm256_storeu_si256((__m256i *) &real[j], real_1);
+        _mm256_storeu_si256((__m256i *) &imag[j], imag_1);
+        _mm256_storeu_si256((__m256i *) &real[j+16], real_3);
+        _mm256_storeu_si256((__m256i *) &imag[j+16], imag_3);
+    }
+
+    return _lfft_q15_max_avx2(max);
+}
+
+static int32_t _lfft_q15_max_avx2(__m256i max)
+{
+    uint32_t k;
+    uint16_t lanes[16];
+    int32_t result = 0;
+
+    _mm256_storeu_si256((__m256i *) lanes, max);
+    for(k = 0; k < 16; k++)
+    {
+        result = (lanes[k] > result) ? lanes[k] : result;
+    }
+
+    return result;
+}
+#endif /* LFFT_USE_AVX2 */
@@ -0,0 +1,178 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains functions to calculate the fft with int16_t data in Q15
+ * format and block floating point scaling.
+ * Before every step the largest value of the block is checked. If the
+ * butterflies could overflow, the whole block is shifted right and the block
+ * exponent is incremented, otherwise all 16 bits are kept. The result is
+ * result*2^exponent.
+ * With AVX2 (see LFFT_USE_AVX2) the butterflies of 16 samples are calculated
+ * at once with rounding Q15 multiplications (vpmulhrsw). The result is bit for
+ * bit the same as the result of the portable calculation.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#ifndef _LFFT_Q15_H
+#define _LFFT_Q15_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lfft_config.h"
+#include "lfft_fft.h"
+
+/*!
+ * largest absolute value of the input of a step after the rounded shift
+ * a butterfly adds at most (1+sqrt(2))*LFFT_Q15_HEADROOM+1 < 2^15
+ */
+#define LFFT_Q15_HEADROOM 13572
+
+typedef struct _lfft_Q15
+{
+    uint32_t   samples; //!< number of samples
+    uint8_t    steps; //!< number of steps
+
+    lfft_Plan * plan; //!< plan shared by all lfft_Fft structs with the same number of samples
+    int16_t  * wk_real; //!< real wk values in Q15 of every step; step half starts at element half
+    int16_t  * wk_imag; //!< imaginary wk values in Q15 of every step; step half starts at element half
+
+    int16_t  * result_real; //!< array where the real part of the result is saved
+    int16_t  * result_imag; //!< array where the imaginary part of the result is saved
+    int8_t     exponent; //!< block exponent of the result, the result is result*2^exponent
+} lfft_Q15;
+
+/*!
+ * Initializes the Q15 fft.
+ * \param q15 pointer to struct to be initialized
+ * \param samples number of input samples; must be to the power of 2
+ * \return 0: successful 1: samples is not to the power of 2 3: not enough memory
+ */
+lfft_errno lfft_q15_new(lfft_Q15 * q15, uint32_t samples);
+
+/*!
+ * Deallocate the used memory.
+ * \param q15 initialized lfft_Q15 struct
+ */
+void lfft_q15_delete(lfft_Q15 * q15);
+
+/*!
+ * Calculates the fft.
+ * It uses only real input data, the imaginary part is set to 0.
+ * The result is saved in q15->result_real, q15->result_imag and q15->exponent.
+ * \param q15 initialized lfft_Q15 struct
+ * \param real real input data for fft
+ */
+void lfft_q15_fft(lfft_Q15 * q15, const int16_t real[]);
+
+/*!
+ * Calculates the fft.
+ * It uses real input and imaginary input data.
+ * The result is saved in q15->result_real, q15->result_imag and q15->exponent.
+ * \param q15 initialized lfft_Q15 struct
+ * \param real real input data for fft
+ * \param imag imaginary input data for fft
+ */
+void lfft_q15_fft_complex(lfft_Q15 * q15, const int16_t real[], const int16_t imag[]);
+
+/*!
+ * Calculates the inverse-fft.
+ * It uses only real input data, the imaginary part is set to 0.
+ * The division by samples is part of q15->exponent.
+ * \param q15 initialized lfft_Q15 struct
+ * \param real real input data for ifft
+ */
+void lfft_q15_ifft(lfft_Q15 * q15, const int16_t real[]);
+
+/*!
+ * Calculates the inverse-fft.
+ * It uses real input and imaginary input data.
+ * The division by samples is part of q15->exponent.
+ * \param q15 initialized lfft_Q15 struct
+ * \param real real input data for ifft
+ * \param imag imaginary input data for ifft
+ */
+void lfft_q15_ifft_complex(lfft_Q15 * q15, const int16_t real[], const int16_t imag[]);
+
+/*!
+ * Calculates the fft in place.
+ * The data is reordered by swapping the elements and replaced by the result.
+ * Several threads can use one lfft_Q15 struct with their own arrays.
+ * \param q15 initialized lfft_Q15 struct
+ * \param real real data with q15->samples elements; replaced by the real result
+ * \param imag imaginary data with q15->samples elements; replaced by the imaginary result
+ * \return block exponent of the result
+ */
+int8_t lfft_q15_fft_inplace(const lfft_Q15 * q15, int16_t real[], int16_t imag[]);
+
+/*!
+ * Calculates the inverse-fft in place.
+ * See lfft_q15_fft_inplace(). The division by samples is part of the exponent.
+ * \param q15 initialized lfft_Q15 struct
+ * \param real real data with q15->samples elements; replaced by the real result
+ * \param imag imaginary data with q15->samples elements; replaced by the imaginary result
+ * \return block exponent of the result
+ */
+int8_t lfft_q15_ifft_inplace(const lfft_Q15 * q15, int16_t real[], int16_t imag[]);
+
+/*!
+ * Returns a real value of the result.
+ * \param q15 initialized lfft_Q15 struct
+ * \param n index of the value
+ * \return q15->result_real[n]*2^q15->exponent
+ */
+float lfft_q15_result_real_float_at(const lfft_Q15 * q15, uint32_t n);
+
+/*!
+ * Returns an imaginary value of the result.
+ * \param q15 initialized lfft_Q15 struct
+ * \param n index of the value
+ * \return q15->result_imag[n]*2^q15->exponent
+ */
+float lfft_q15_result_imag_float_at(const lfft_Q15 * q15, uint32_t n);
+
+/*!
+ * Calculates the butterflies of reordered data with block floating point
+ * scaling.
+ * Don't use this function if it is possible to use the above functions.
+ * \param q15 initialized lfft_Q15 struct
+ * \param real reordered real data; replaced by the real result
+ * \param imag reordered imaginary data; replaced by the imaginary result
+ * \param calculate_ifft false to calculate fft, true to calculate ifft
+ * \return block exponent of the result
+ */
+int8_t _lfft_q15_calculation(const lfft_Q15 * q15, int16_t real[], int16_t imag[], bool calculate_ifft);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LFFT_Q15_H */
@@ -0,0 +1,188 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains functions to calculate the spectrum of the last samples
+ * input samples after every input sample with the modulated sliding dft.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#include "lfft_sdft.h"
+
+#include <stdlib.h>
+
+/*!
+ * Returns wk^n = e^(-j*2*pi*n/samples) with LFFT_RHS_BITS decimal places.
+ * \param sdft initialized lfft_Sdft struct
+ * \param n exponent; 0..samples-1
+ * \param wk_real real wk^n
+ * \param wk_imag imaginary wk^n
+ */
+static void _lfft_sdft_wk(const lfft_Sdft * sdft, uint32_t n, int32_t * wk_real, int32_t * wk_imag);
+
+lfft_errno lfft_sdft_new(lfft_Sdft * sdft, uint32_t samples, const uint32_t bins[], uint32_t bin_count)
+{
+    uint32_t i;
+
+    // samples is not to the power of 2
+    if((samples == 0)||(samples&(samples-1)))
+    {
+        return 1;
+    }
+
+    if(bins == NULL)
+    {
+        bin_count = samples;
+    }
+    else if(bin_count == 0)
+    {
+        return 2;
+    }
+
+    for(i = 0; (bins != NULL)&&(i < bin_count); i++)
+    {
+        if(bins[i] >= samples)
+        {
+            return 2;
+        }
+    }
+
+    sdft->plan = lfft_plan_acquire(samples);
+    if(sdft->plan == NULL)
+    {
+        return 3;
+    }
+
+    sdft->samples   = samples;
+    sdft->bin_count = bin_count;
+    sdft->position  = 0;
+
+    // allocate memory, all sums and samples start with zero
+    sdft->bins        = (uint32_t *) malloc(bin_count*sizeof(uint32_t));
+    sdft->ring        = (int32_t *)  calloc(samples, sizeof(int32_t));
+    sdft->sum_real    = (int64_t *)  calloc(bin_count, sizeof(int64_t));
+    sdft->sum_imag    = (int64_t *)  calloc(bin_count, sizeof(int64_t));
+    sdft->result_real = (int32_t *)  calloc(bin_count, sizeof(int32_t));
+    sdft->result_imag = (int32_t *)  calloc(bin_count, sizeof(int32_t));
+
+    if((sdft->bins == NULL)||(sdft->ring == NULL)||(sdft->sum_real == NULL)||(sdft->sum_imag == NULL)||
+            (sdft->result_real == NULL)||(sdft->result_imag == NULL))
+    {
+        lfft_sdft_delete(sdft);
+        return 3;
+    }
+
+    for(i = 0; i < bin_count; i++)
+    {
+        sdft->bins[i] = (bins == NULL) ? i : bins[i];
+    }
+
+    return 0;
+}
+
+void lfft_sdft_delete(lfft_Sdft * sdft)
+{
+    lfft_plan_release(sdft->plan);
+    free(sdft->bins);
+    free(sdft->ring);
+    free(sdft->sum_real);
+    free(sdft->sum_imag);
+    free(sdft->result_real);
+    free(sdft->result_imag);
+}
+
+void lfft_sdft_write(lfft_Sdft * sdft, const int32_t data[], uint32_t n)
+{
+    uint32_t i;
+    uint32_t k;
+    uint32_t mask = sdft->samples-1;
+    int32_t delta;
+    int32_t wk_real;
+    int32_t wk_imag;
+    int64_t sum_real;
+    int64_t sum_imag;
+
+    if(n == 0)
+    {
+        return;
+    }
+
+    //   sum[k] += (x_new-x_old)*wk^(k*t)
+    // x_old was added with the same wk value, so it is removed exactly
+    for(i = 0; i < n; i++)
+    {
+        delta = data[i]-sdft->ring[sdft->position];
+        sdft->ring[sdft->position] = data[i];
+
+        if(delta != 0)
+        {
+            for(k = 0; k < sdft->bin_count; k++)
+            {
+                _lfft_sdft_wk(sdft, (sdft->bins[k]*sdft->position)&mask, &wk_real, &wk_imag);
+                sdft->sum_real[k] += (int64_t) delta*wk_real;
+                sdft->sum_imag[k] += (int64_t) delta*wk_imag;
+            }
+        }
+
+        sdft->position = (sdft->position+1)&mask;
+    }
+
+    // the oldest sample at sdft->position is sample 0 of the dft
+    //   X[k] = sum[k]*wk^(-k*position)
+    for(k = 0; k < sdft->bin_count; k++)
+    {
+        _lfft_sdft_wk(sdft, (sdft->bins[k]*sdft->position)&mask, &wk_real, &wk_imag);
+        sum_real = sdft->sum_real[k];
+        sum_imag = sdft->sum_imag[k];
+
+        // rounding to LFFT_RHS_BITS decimal places
+        sdft->result_real[k] = (int32_t) ((sum_real*wk_real+sum_imag*wk_imag+(1<<(LFFT_RHS_BITS-1)))>>LFFT_RHS_BITS);
+        sdft->result_imag[k] = (int32_t) ((sum_imag*wk_real-sum_real*wk_imag+(1<<(LFFT_RHS_BITS-1)))>>LFFT_RHS_BITS);
+    }
+}
+
+static void _lfft_sdft_wk(const lfft_Sdft * sdft, uint32_t n, int32_t * wk_real, int32_t * wk_imag)
+{
+    uint32_t half = sdft->samples/2;
+
+    // the plan has no wk values for samples == 1
+    if(half == 0)
+    {
+        *wk_real = 1<<LFFT_RHS_BITS;
+        *wk_imag = 0;
+        return;
+    }
+
+    // the plan contains wk^n for n < samples/2, so wk^n = -wk^(n-samples/2)
+    // is used for the other half; the sign is selected without a branch
+    *wk_real = sdft->plan->wk_real[n&(half-1)];
+    *wk_imag = sdft->plan->wk_imag[n&(half-1)];
+    *wk_real = (n&half) ? -*wk_real : *wk_real;
+    *wk_imag = (n&half) ? -*wk_imag : *wk_imag;
+}
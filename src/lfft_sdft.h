@@ -0,0 +1,102 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains functions to calculate the spectrum of the last samples
+ * input samples after every input sample with the modulated sliding dft.
+ * Every bin k keeps the sum of x[t]*wk^(k*t) of the last samples input
+ * samples, t is the index of the sample in the ring buffer. A new sample adds
+ * its product and removes the product of the sample it replaces, which was
+ * calculated with the same wk value, so the sums are exact 64 bit integers and
+ * never drift. Only the result is rotated to the oldest sample of the ring
+ * buffer and rounded. Without a recursive multiplication there is no
+ * resynchronisation with a full fft.
+ * An input sample costs one complex multiplication for every selected bin.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#ifndef _LFFT_SDFT_H
+#define _LFFT_SDFT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lfft_config.h"
+#include "lfft_fft.h"
+
+typedef struct _lfft_Sdft
+{
+    uint32_t   samples; //!< number of samples of the dft
+    uint32_t   bin_count; //!< number of calculated bins
+
+    lfft_Plan * plan; //!< plan providing the wk values; shared with other structs of the same size
+    uint32_t * bins; //!< calculated bins
+    int32_t  * ring; //!< ring buffer containing the last samples input samples
+    uint32_t   position; //!< index of the next input sample in ring
+    int64_t  * sum_real; //!< real sums of every bin with LFFT_RHS_BITS decimal places
+    int64_t  * sum_imag; //!< imaginary sums of every bin with LFFT_RHS_BITS decimal places
+    int32_t  * result_real; //!< real result of bins[i] at index i
+    int32_t  * result_imag; //!< imaginary result of bins[i] at index i
+} lfft_Sdft;
+
+/*!
+ * Initializes the sliding dft.
+ * All input samples before the first lfft_sdft_write() are zero.
+ * \param sdft pointer to struct to be initialized
+ * \param samples number of samples of the dft; must be to the power of 2
+ * \param bins bins which are calculated; NULL for all samples bins
+ * \param bin_count number of elements of bins; ignored if bins is NULL
+ * \return 0: successful 1: samples is not to the power of 2 2: a bin is not smaller than samples or bin_count is 0 3: not enough memory
+ */
+lfft_errno lfft_sdft_new(lfft_Sdft * sdft, uint32_t samples, const uint32_t bins[], uint32_t bin_count);
+
+/*!
+ * Deallocate the used memory.
+ * \param sdft initialized lfft_Sdft struct
+ */
+void lfft_sdft_delete(lfft_Sdft * sdft);
+
+/*!
+ * Writes input samples and calculates the dft of the last samples input
+ * samples into sdft->result_real and sdft->result_imag.
+ * The result is the same as the result of lfft_fft() with the last samples
+ * input samples except for rounding. The result is only calculated once after
+ * the last input sample, so n = 1 updates the spectrum with every sample.
+ * \param sdft initialized lfft_Sdft struct
+ * \param data integer input samples
+ * \param n number of input samples
+ */
+void lfft_sdft_write(lfft_Sdft * sdft, const int32_t data[], uint32_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LFFT_SDFT_H */
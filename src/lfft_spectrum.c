@@ -0,0 +1,328 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*! \file
+ * This file contains functions to calculate the power, the magnitude and the
+ * logarithmic power of a whole spectrum.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#include "lfft_spectrum.h"
+#include "lfft_fft.h"
+
+#ifdef LFFT_USE_AVX2
+#include <immintrin.h>
+#endif /* LFFT_USE_AVX2 */
+
+/*!
+ * decimal places of the binary logarithms of _lfft_log2_table
+ */
+#define LFFT_LOG_BITS 16
+
+/*!
+ * bits of the mantissa which select the interval of _lfft_log2_table
+ */
+#define LFFT_LOG_TABLE_BITS 6
+
+/*!
+ * 10*log10(2) with LFFT_LOG_BITS decimal places
+ */
+#define LFFT_LOG_DB_FACTOR 197283
+
+/*!
+ * log2(1+i/2^LFFT_LOG_TABLE_BITS) with LFFT_LOG_BITS decimal places
+ */
+static const int32_t _lfft_log2_table[(1<<LFFT_LOG_TABLE_BITS)+1] = {
+        0,  1466,  2909,  4331,  5732,  7112,  8473,  9814, 11136, 12440, 13727, 14996, 16248,
+    17484, 18704, 19909, 21098, 22272, 23433, 24579, 25711, 26830, 27936, 29029, 30109, 31178,
+    32234, 33279, 34312, 35334, 36346, 37346, 38336, 39316, 40286, 41246, 42196, 43137, 44068,
+    44990, 45904, 46809, 47705, 48593, 49472, 50344, 51207, 52063, 52911, 53751, 54584, 55410,
+    56229, 57040, 57845, 58643, 59434, 60219, 60997, 61769, 62534, 63294, 64047, 64794, 65536};
+
+/*!
+ * Calculates the binary logarithm of a power with the bit length and
+ * _lfft_log2_table. The decimal places of the power are removed.
+ * \param power power with 2*LFFT_RHS_BITS decimal places; not 0
+ * \return log2(power) with LFFT_LOG_BITS decimal places
+ */
+static int32_t _lfft_spectrum_log2(uint64_t power);
+
+#ifdef LFFT_USE_AVX2
+/*!
+ * Calculates the binary logarithm of the power of 4 bins with AVX2
+ * instructions, the exponent and the mantissa are taken from the power as
+ * double, see _lfft_spectrum_log2().
+ * \param real real part of the 4 bins
+ * \param imag imaginary part of the 4 bins
+ * \param zero set to all bits for the lanes with zero power
+ * \return log2(power) with LFFT_LOG_BITS decimal places
+ */
+static __m128i _lfft_spectrum_log2_avx2(const int32_t real[], const int32_t imag[], __m128i * zero);
+#endif /* LFFT_USE_AVX2 */
+
+void lfft_spectrum_power(const int32_t real[], const int32_t imag[], uint64_t power[], uint32_t n)
+{
+    uint32_t i = 0;
+
+#ifdef LFFT_USE_AVX2
+    __m256i r;
+    __m256i m;
+
+    // the 32 bit values are sign extended, 64 bit products
+    for(; i+4 <= n; i += 4)
+    {
+        r = _mm256_cvtepi32_epi64(_mm_loadu_si128((__m128i *) &real[i]));
+        m = _mm256_cvtepi32_epi64(_mm_loadu_si128((__m128i *) &imag[i]));
+        _mm256_storeu_si256((__m256i *) &power[i], _mm256_add_epi64(_mm256_mul_epi32(r, r), _mm256_mul_epi32(m, m)));
+    }
+#endif /* LFFT_USE_AVX2 */
+
+    for(; i < n; i++)
+    {
+        power[i] = (uint64_t) ((int64_t) real[i]*real[i])+(uint64_t) ((int64_t) imag[i]*imag[i]);
+    }
+}
+
+void lfft_spectrum_magnitude(const int32_t real[], const int32_t imag[], uint32_t magnitude[], uint32_t n,
+        lfft_Magnitude calculation)
+{
+    uint32_t i = 0;
+    uint32_t big;
+    uint32_t small;
+
+#ifdef LFFT_USE_AVX2
+    const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+    const __m256i lower = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    const __m256d offset = _mm256_set1_pd(2147483648.0);
+    __m256d real_d;
+    __m256d imag_d;
+    __m256d root_d;
+    __m256i r;
+    __m256i m;
+    __m256i power;
+    __m256i root;
+    __m256i square;
+    __m256i a;
+    __m256i b;
+
+    if(calculation == LFFT_MAGNITUDE_APPROXIMATE)
+    {
+        // the absolute values are unsigned, |INT32_MIN| == 2^31
+        for(; i+8 <= n; i += 8)
+        {
+            a = _mm256_abs_epi32(_mm256_loadu_si256((__m256i *) &real[i]));
+            b = _mm256_abs_epi32(_mm256_loadu_si256((__m256i *) &imag[i]));
+            r = _mm256_max_epu32(a, b);
+            m = _mm256_min_epu32(a, b);
+            a = _mm256_add_epi32(_mm256_sub_epi32(r, _mm256_srli_epi32(r, 3)), _mm256_srli_epi32(m, 1));
+            _mm256_storeu_si256((__m256i *) &magnitude[i], _mm256_max_epu32(r, a));
+        }
+    }
+    else
+    {
+        for(; i+4 <= n; i += 4)
+        {
+            // the square root of the power as double is floor(sqrt(power))
+            // or one of its neighbours
+            real_d = _mm256_cvtepi32_pd(_mm_loadu_si128((__m128i *) &real[i]));
+            imag_d = _mm256_cvtepi32_pd(_mm_loadu_si128((__m128i *) &imag[i]));
+            root_d = _mm256_floor_pd(_mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(real_d, real_d), _mm256_mul_pd(imag_d, imag_d))));
+
+            // root < 2^32 is converted with an offset of 2^31
+            root = _mm256_cvtepu32_epi64(_mm_xor_si128(_mm256_cvttpd_epi32(_mm256_sub_pd(root_d, offset)),
+                    _mm_set1_epi32(INT32_MIN)));
+
+            // exact power, see lfft_spectrum_power()
+            r = _mm256_cvtepi32_epi64(_mm_loadu_si128((__m128i *) &real[i]));
+            m = _mm256_cvtepi32_epi64(_mm_loadu_si128((__m128i *) &imag[i]));
+            power = _mm256_add_epi64(_mm256_mul_epi32(r, r), _mm256_mul_epi32(m, m));
+
+            // root = root-1 if root^2 > power (unsigned comparison)
+            square = _mm256_mul_epu32(root, root);
+            a = _mm256_cmpgt_epi64(_mm256_xor_si256(square, sign), _mm256_xor_si256(power, sign));
+            root = _mm256_add_epi64(root, a);
+            square = _mm256_mul_epu32(root, root);
+
+            // root = root+1 if (root+1)^2 <= power <=> power-root^2 > 2*root
+            b = _mm256_cmpgt_epi64(_mm256_xor_si256(_mm256_sub_epi64(power, square), sign),
+                    _mm256_xor_si256(_mm256_add_epi64(root, root), sign));
+            root = _mm256_sub_epi64(root, b);
+
+            _mm_storeu_si128((__m128i *) &magnitude[i], _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(root, lower)));
+        }
+    }
+#endif /* LFFT_USE_AVX2 */
+
+    for(; i < n; i++)
+    {
+        if(calculation == LFFT_MAGNITUDE_APPROXIMATE)
+        {
+            // |INT32_MIN| is calculated unsigned
+            big   = (real[i] < 0) ? 0U-(uint32_t) real[i] : (uint32_t) real[i];
+            small = (imag[i] < 0) ? 0U-(uint32_t) imag[i] : (uint32_t) imag[i];
+            if(small > big)
+            {
+                big   ^= small;
+                small ^= big;
+                big   ^= small;
+            }
+            magnitude[i] = big-(big>>3)+(small>>1);
+            magnitude[i] = (magnitude[i] > big) ? magnitude[i] : big;
+        }
+        else
+        {
+            magnitude[i] = lfft_isqrt64((uint64_t) ((int64_t) real[i]*real[i])+(uint64_t) ((int64_t) imag[i]*imag[i]));
+        }
+    }
+}
+
+void lfft_spectrum_log2(const int32_t real[], const int32_t imag[], int32_t log2_power[], uint32_t n)
+{
+    uint32_t i = 0;
+    uint64_t power;
+    int32_t value;
+
+#ifdef LFFT_USE_AVX2
+    __m128i zero;
+    __m128i log2_value;
+
+    for(; i+4 <= n; i += 4)
+    {
+        // the same rounding as below
+        log2_value = _mm_sub_epi32(_lfft_spectrum_log2_avx2(&real[i], &imag[i], &zero),
+                _mm_set1_epi32((2*LFFT_RHS_BITS)<<LFFT_LOG_BITS));
+        log2_value = _mm_srai_epi32(_mm_add_epi32(log2_value, _mm_set1_epi32(1<<(LFFT_LOG_BITS-LFFT_RHS_BITS-1))),
+                LFFT_LOG_BITS-LFFT_RHS_BITS);
+        _mm_storeu_si128((__m128i *) &log2_power[i], _mm_blendv_epi8(log2_value, _mm_set1_epi32(LFFT_LOG_ZERO), zero));
+    }
+#endif /* LFFT_USE_AVX2 */
+
+    for(; i < n; i++)
+    {
+        power = (uint64_t) ((int64_t) real[i]*real[i])+(uint64_t) ((int64_t) imag[i]*imag[i]);
+        if(power == 0)
+        {
+            log2_power[i] = LFFT_LOG_ZERO;
+            continue;
+        }
+
+        // remove the 2*LFFT_RHS_BITS decimal places of the power, round to
+        // LFFT_RHS_BITS decimal places
+        value = _lfft_spectrum_log2(power)-((2*LFFT_RHS_BITS)<<LFFT_LOG_BITS);
+        log2_power[i] = (value+(1<<(LFFT_LOG_BITS-LFFT_RHS_BITS-1)))>>(LFFT_LOG_BITS-LFFT_RHS_BITS);
+    }
+}
+
+void lfft_spectrum_db(const int32_t real[], const int32_t imag[], int32_t db[], uint32_t n)
+{
+    uint32_t i = 0;
+    uint64_t power;
+    int64_t value;
+
+#ifdef LFFT_USE_AVX2
+    __m128i zero;
+    __m128i log2_value;
+    __m256d db_d;
+
+    for(; i+4 <= n; i += 4)
+    {
+        // 10*log10(power) = 10*log10(2)*log2(power), rounded like below
+        log2_value = _mm_sub_epi32(_lfft_spectrum_log2_avx2(&real[i], &imag[i], &zero),
+                _mm_set1_epi32((2*LFFT_RHS_BITS)<<LFFT_LOG_BITS));
+        db_d = _mm256_mul_pd(_mm256_cvtepi32_pd(log2_value),
+                _mm256_set1_pd((double) LFFT_LOG_DB_FACTOR/(1LL<<(2*LFFT_LOG_BITS-LFFT_RHS_BITS))));
+        db_d = _mm256_floor_pd(_mm256_add_pd(db_d, _mm256_set1_pd(0.5)));
+        _mm_storeu_si128((__m128i *) &db[i], _mm_blendv_epi8(_mm256_cvttpd_epi32(db_d), _mm_set1_epi32(LFFT_LOG_ZERO), zero));
+    }
+#endif /* LFFT_USE_AVX2 */
+
+    for(; i < n; i++)
+    {
+        power = (uint64_t) ((int64_t) real[i]*real[i])+(uint64_t) ((int64_t) imag[i]*imag[i]);
+        if(power == 0)
+        {
+            db[i] = LFFT_LOG_ZERO;
+            continue;
+        }
+
+        // 10*log10(power) = 10*log10(2)*log2(power) with 2*LFFT_LOG_BITS
+        // decimal places, rounded to LFFT_RHS_BITS decimal places
+        value = (int64_t) (_lfft_spectrum_log2(power)-((2*LFFT_RHS_BITS)<<LFFT_LOG_BITS))*LFFT_LOG_DB_FACTOR;
+        db[i] = (int32_t) ((value+(1LL<<(2*LFFT_LOG_BITS-LFFT_RHS_BITS-1)))>>(2*LFFT_LOG_BITS-LFFT_RHS_BITS));
+    }
+}
+
+static int32_t _lfft_spectrum_log2(uint64_t power)
+{
+    uint8_t exponent = _lfft_bit_length(power)-1;
+    uint64_t mantissa = power<<(63-exponent); // highest bit is set
+    uint32_t index;
+    int32_t fraction;
+
+    // the bits after the highest bit select the interval of the table, the
+    // next LFFT_LOG_BITS bits interpolate linearly
+    index    = (uint32_t) (mantissa>>(63-LFFT_LOG_TABLE_BITS))&((1<<LFFT_LOG_TABLE_BITS)-1);
+    fraction = (int32_t) ((mantissa>>(63-LFFT_LOG_TABLE_BITS-LFFT_LOG_BITS))&((1<<LFFT_LOG_BITS)-1));
+
+    return (exponent<<LFFT_LOG_BITS)+_lfft_log2_table[index]+
+            (((_lfft_log2_table[index+1]-_lfft_log2_table[index])*fraction)>>LFFT_LOG_BITS);
+}
+
+#ifdef LFFT_USE_AVX2
+static __m128i _lfft_spectrum_log2_avx2(const int32_t real[], const int32_t imag[], __m128i * zero)
+{
+    const __m256i lower = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    __m256d real_d = _mm256_cvtepi32_pd(_mm_loadu_si128((__m128i *) real));
+    __m256d imag_d = _mm256_cvtepi32_pd(_mm_loadu_si128((__m128i *) imag));
+    __m256d power_d = _mm256_add_pd(_mm256_mul_pd(real_d, real_d), _mm256_mul_pd(imag_d, imag_d));
+    __m256i bits = _mm256_castpd_si256(power_d);
+    __m128i exponent;
+    __m128i index;
+    __m128i fraction;
+    __m128i low;
+    __m128i high;
+
+    *zero = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(
+            _mm256_castpd_si256(_mm256_cmp_pd(power_d, _mm256_setzero_pd(), _CMP_EQ_OQ)), lower));
+
+    // the power is an integer, so the exponent of the double is the exponent
+    // of _lfft_spectrum_log2(), the mantissa follows the hidden bit
+    exponent = _mm_sub_epi32(_mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_srli_epi64(bits, 52), lower)),
+            _mm_set1_epi32(1023));
+    index    = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_srli_epi64(bits, 52-LFFT_LOG_TABLE_BITS), lower));
+    index    = _mm_and_si128(index, _mm_set1_epi32((1<<LFFT_LOG_TABLE_BITS)-1));
+    fraction = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_srli_epi64(bits, 52-LFFT_LOG_TABLE_BITS-LFFT_LOG_BITS), lower));
+    fraction = _mm_and_si128(fraction, _mm_set1_epi32((1<<LFFT_LOG_BITS)-1));
+
+    low  = _mm_i32gather_epi32(_lfft_log2_table, index, 4);
+    high = _mm_i32gather_epi32(&_lfft_log2_table[1], index, 4);
+
+    return _mm_add_epi32(_mm_add_epi32(_mm_slli_epi32(exponent, LFFT_LOG_BITS), low),
+            _mm_srai_epi32(_mm_mullo_epi32(_mm_sub_epi32(high, low), fraction), LFFT_LOG_BITS));
+}
+#endif /* LFFT_USE_AVX2 */
@@ -0,0 +1,116 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*! \file
+ * This file contains functions to calculate the power, the magnitude and the
+ * logarithmic power of a whole spectrum, e.g. of lfft_Fft::result_real and
+ * lfft_Fft::result_imag. The squares are calculated with 64 bits, so they
+ * never overflow. The magnitude uses lfft_isqrt64() or the approximation
+ * max(big, big-big/8+small/2) of the larger and the smaller absolute value,
+ * which is between -3.0% and +0.8% of the magnitude. The logarithm uses the
+ * bit length and a table with linear interpolation.
+ * If LFFT_USE_AVX2 is defined, the kernels calculate 4 or 8 bins at once;
+ * the exact magnitude is the same, the logarithm can differ in the last
+ * decimal place.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#ifndef _LFFT_SPECTRUM_H
+#define _LFFT_SPECTRUM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lfft_config.h"
+
+/*!
+ * value of lfft_spectrum_log2() and lfft_spectrum_db() for a bin with zero power
+ */
+#define LFFT_LOG_ZERO INT32_MIN
+
+/*!
+ * Calculations of the magnitude.
+ */
+typedef enum _lfft_Magnitude
+{
+    LFFT_MAGNITUDE_EXACT = 0, //!< floor(sqrt(real^2+imag^2))
+    LFFT_MAGNITUDE_APPROXIMATE = 1 //!< max(big, big-big/8+small/2) of the absolute values; for screening
+} lfft_Magnitude;
+
+/*!
+ * Calculates the power of every bin.
+ * power[i] = real[i]^2+imag[i]^2
+ * \param real real part of the spectrum with LFFT_RHS_BITS decimal places
+ * \param imag imaginary part of the spectrum with LFFT_RHS_BITS decimal places
+ * \param power array with n elements for the power with 2*LFFT_RHS_BITS decimal places
+ * \param n number of bins
+ */
+void lfft_spectrum_power(const int32_t real[], const int32_t imag[], uint64_t power[], uint32_t n);
+
+/*!
+ * Calculates the magnitude of every bin.
+ * magnitude[i] = sqrt(real[i]^2+imag[i]^2)
+ * \param real real part of the spectrum with LFFT_RHS_BITS decimal places
+ * \param imag imaginary part of the spectrum with LFFT_RHS_BITS decimal places
+ * \param magnitude array with n elements for the magnitude with LFFT_RHS_BITS decimal places
+ * \param n number of bins
+ * \param calculation exact or approximated magnitude
+ */
+void lfft_spectrum_magnitude(const int32_t real[], const int32_t imag[], uint32_t magnitude[], uint32_t n,
+        lfft_Magnitude calculation);
+
+/*!
+ * Calculates the binary logarithm of the power of every bin.
+ * log2_power[i] = log2(real[i]^2+imag[i]^2), the decimal places of the
+ * spectrum are removed; LFFT_LOG_ZERO for a bin with zero power.
+ * \param real real part of the spectrum with LFFT_RHS_BITS decimal places
+ * \param imag imaginary part of the spectrum with LFFT_RHS_BITS decimal places
+ * \param log2_power array with n elements for the logarithm with LFFT_RHS_BITS decimal places
+ * \param n number of bins
+ */
+void lfft_spectrum_log2(const int32_t real[], const int32_t imag[], int32_t log2_power[], uint32_t n);
+
+/*!
+ * Calculates the power of every bin in decibel.
+ * db[i] = 10*log10(real[i]^2+imag[i]^2), the decimal places of the spectrum
+ * are removed; LFFT_LOG_ZERO for a bin with zero power.
+ * The power isn't normalized; the caller can normalize the power of a fft
+ * with samples elements by subtracting 20*log10(samples)*2^LFFT_RHS_BITS.
+ * \param real real part of the spectrum with LFFT_RHS_BITS decimal places
+ * \param imag imaginary part of the spectrum with LFFT_RHS_BITS decimal places
+ * \param db array with n elements for the power in decibel with LFFT_RHS_BITS decimal places
+ * \param n number of bins
+ */
+void lfft_spectrum_db(const int32_t real[], const int32_t imag[], int32_t db[], uint32_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LFFT_SPECTRUM_H */
@@ -0,0 +1,189 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains functions to calculate the short-time fourier
+ * transformation of a stream of samples.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#include "lfft_stft.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*!
+ * Calculates the spectrum of the last samples input samples.
+ * The windowed frame is gathered from the ring buffer directly into the
+ * packed and reordered input of the real fft, see lfft_rfft().
+ * \param stft initialized lfft_Stft struct
+ */
+static void _lfft_stft_frame(lfft_Stft * stft);
+
+lfft_errno lfft_stft_new(lfft_Stft * stft, uint32_t samples, uint32_t hop, lfft_Window window)
+{
+    uint32_t i;
+    double value;
+    lfft_errno error;
+
+    // samples is not to the power of 2
+    if((samples < 2)||(samples&(samples-1)))
+    {
+        return 1;
+    }
+
+    if((hop == 0)||(hop > samples)||(window > LFFT_WINDOW_HAMMING))
+    {
+        return 2;
+    }
+
+    error = lfft_fft_new(&stft->fft, samples);
+    if(error != 0)
+    {
+        return error;
+    }
+
+    stft->samples  = samples;
+    stft->hop      = hop;
+    stft->position = 0;
+    stft->count    = 0;
+    stft->frames   = 0;
+    stft->ready    = false;
+
+    // allocate memory, the ring buffer starts with zeros
+    stft->window = (int32_t *) malloc(samples*sizeof(int32_t));
+    stft->ring   = (int32_t *) calloc(samples, sizeof(int32_t));
+
+    if((stft->window == NULL)||(stft->ring == NULL))
+    {
+        lfft_stft_delete(stft);
+        return 3;
+    }
+
+    for(i = 0; i < samples; i++)
+    {
+        switch(window)
+        {
+            case LFFT_WINDOW_HANN:
+                value = 0.5-0.5*cos((2.0*M_PI*i)/samples);
+                break;
+            case LFFT_WINDOW_HAMMING:
+                value = 0.54-0.46*cos((2.0*M_PI*i)/samples);
+                break;
+            default:
+                value = 1.0;
+                break;
+        }
+        stft->window[i] = (int32_t) floor(value*(1<<LFFT_RHS_BITS)+0.5);
+    }
+
+    return 0;
+}
+
+void lfft_stft_delete(lfft_Stft * stft)
+{
+    lfft_fft_delete(&stft->fft);
+    free(stft->window);
+    free(stft->ring);
+}
+
+uint32_t lfft_stft_write(lfft_Stft * stft, const int32_t data[], uint32_t n)
+{
+    uint32_t used;
+    uint32_t part;
+
+    // use the samples up to the end of the hop
+    used = stft->hop-stft->count;
+    used = (n < used) ? n : used;
+
+    // the ring buffer wraps at most once
+    part = stft->samples-stft->position;
+    part = (used < part) ? used : part;
+    memcpy(&stft->ring[stft->position], data, part*sizeof(int32_t));
+    memcpy(stft->ring, &data[part], (used-part)*sizeof(int32_t));
+
+    stft->position = (stft->position+used)&(stft->samples-1);
+    stft->count += used;
+    stft->ready = (stft->count == stft->hop);
+
+    if(stft->ready)
+    {
+        _lfft_stft_frame(stft);
+        stft->count = 0;
+        stft->frames++;
+    }
+
+    return used;
+}
+
+uint32_t lfft_stft_process(lfft_Stft * stft, const int32_t data[], uint32_t n,
+        lfft_stft_callback callback, void * argument)
+{
+    uint32_t used;
+    uint32_t frames = 0;
+
+    while(n > 0)
+    {
+        used = lfft_stft_write(stft, data, n);
+        data += used;
+        n -= used;
+
+        if(stft->ready)
+        {
+            callback(argument, stft);
+            frames++;
+        }
+    }
+
+    return frames;
+}
+
+static void _lfft_stft_frame(lfft_Stft * stft)
+{
+    uint32_t i;
+    uint32_t n;
+    uint32_t mask = stft->samples-1;
+    const int32_t * window = stft->window;
+    const int32_t * ring = stft->ring;
+    int32_t * result_real = stft->fft.result_real;
+    int32_t * result_imag = stft->fft.result_imag;
+
+    // the oldest sample (at stft->position) is sample 0 of the frame
+    // input*window has LFFT_RHS_BITS decimal places like the packing of lfft_rfft()
+    for(i = 0; i < stft->samples/2; i++)
+    {
+        // the stockham kernel uses the input data in natural order
+        n = (stft->fft.kernel == LFFT_KERNEL_STOCKHAM) ? 2*i : stft->fft.switching_table[2*i]<<1;
+        result_real[i] = ring[(stft->position+n)&mask]*window[n];
+        result_imag[i] = ring[(stft->position+n+1)&mask]*window[n+1];
+    }
+
+    _lfft_rfft_calculation(&stft->fft, result_real, result_imag, stft->fft.workspace);
+}
@@ -0,0 +1,142 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains functions to calculate the short-time fourier
+ * transformation of a stream of samples.
+ * The input is written in chunks of any length into a ring buffer. After
+ * every hop samples the spectrum of the last samples elements is calculated.
+ * The window is applied while the frame is gathered from the ring buffer into
+ * the reordered input of the fft, so every sample of a frame is read once
+ * and there is no copy of the frame.
+ * The ring buffer starts with zeros, so the first spectrum is calculated
+ * after hop samples and the latency is never more than hop samples.
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#ifndef _LFFT_STFT_H
+#define _LFFT_STFT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lfft_config.h"
+#include "lfft_fft.h"
+
+/*!
+ * Windows of the short-time fourier transformation.
+ */
+typedef enum _lfft_Window
+{
+    LFFT_WINDOW_RECTANGULAR = 0, //!< all values are 1
+    LFFT_WINDOW_HANN = 1, //!< periodic hann window 0.5-0.5*cos(2*pi*n/samples)
+    LFFT_WINDOW_HAMMING = 2 //!< periodic hamming window 0.54-0.46*cos(2*pi*n/samples)
+} lfft_Window;
+
+typedef struct _lfft_Stft lfft_Stft;
+
+/*!
+ * Function which is called with every spectrum of lfft_stft_process().
+ * \param argument argument of lfft_stft_process()
+ * \param stft lfft_Stft struct containing the spectrum in stft->fft.result_real and stft->fft.result_imag
+ */
+typedef void (*lfft_stft_callback)(void * argument, const lfft_Stft * stft);
+
+struct _lfft_Stft
+{
+    uint32_t   samples; //!< number of samples of a frame
+    uint32_t   hop; //!< number of samples between the starts of two frames
+
+    lfft_Fft   fft; //!< fft of a frame; elements 0..samples/2 of fft.result_real and fft.result_imag are the spectrum of the last frame
+    int32_t  * window; //!< window values with LFFT_RHS_BITS decimal places
+    int32_t  * ring; //!< ring buffer containing the last samples input samples
+    uint32_t   position; //!< index of the oldest sample in ring
+    uint32_t   count; //!< number of input samples since the last frame
+    uint32_t   frames; //!< number of calculated spectra
+    bool       ready; //!< true if the last call of lfft_stft_write() calculated a spectrum
+};
+
+/*!
+ * Initializes the short-time fourier transformation.
+ * \param stft pointer to struct to be initialized
+ * \param samples number of samples of a frame; must be to the power of 2 and at least 2
+ * \param hop number of samples between the starts of two frames; 1..samples
+ * \param window window which is applied to every frame
+ * \return 0: successful 1: samples is not to the power of 2 2: invalid hop or unknown window 3: not enough memory
+ */
+lfft_errno lfft_stft_new(lfft_Stft * stft, uint32_t samples, uint32_t hop, lfft_Window window);
+
+/*!
+ * Deallocate the used memory.
+ * \param stft initialized lfft_Stft struct
+ */
+void lfft_stft_delete(lfft_Stft * stft);
+
+/*!
+ * Writes input samples until the next spectrum is calculated.
+ * If the samples complete a hop, the spectrum is calculated into
+ * stft->fft.result_real and stft->fft.result_imag and stft->ready is set.
+ * The remaining samples have to be written with further calls:
+ *
+ *     while(n > 0)
+ *     {
+ *         used = lfft_stft_write(&stft, data, n);
+ *         data += used;
+ *         n -= used;
+ *         if(stft.ready)
+ *         {
+ *             // use stft.fft.result_real[0..samples/2] and stft.fft.result_imag[0..samples/2]
+ *         }
+ *     }
+ *
+ * \param stft initialized lfft_Stft struct
+ * \param data integer input samples
+ * \param n number of input samples
+ * \return number of used input samples
+ */
+uint32_t lfft_stft_write(lfft_Stft * stft, const int32_t data[], uint32_t n);
+
+/*!
+ * Writes all input samples and calls callback with every spectrum.
+ * \param stft initialized lfft_Stft struct
+ * \param data integer input samples
+ * \param n number of input samples
+ * \param callback function which is called after every spectrum
+ * \param argument first argument of callback
+ * \return number of calculated spectra
+ */
+uint32_t lfft_stft_process(lfft_Stft * stft, const int32_t data[], uint32_t n,
+        lfft_stft_callback callback, void * argument);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LFFT_STFT_H */
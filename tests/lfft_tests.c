@@ -26,6 +26,7 @@
  */
 
 #include <inttypes.h>
+#include <float.h>
 #include <math.h>
 #include <stdlib.h>
 
@@ -33,6 +34,22 @@
 
 #include "lfft.h"
 #include "lfft_fft.c"
+#include "lfft_fft2.c"
+#include "lfft_batch.c"
+#include "lfft_large.c"
+#include "lfft_mixed.c"
+#include "lfft_q15.c"
+#include "lfft_float.c"
+#include "lfft_stft.c"
+#include "lfft_sdft.c"
+#include "lfft_pruned.c"
+#include "lfft_conv.c"
+#include "lfft_partitioned.c"
+#include "lfft_spectrum.c"
+#ifdef LFFT_USE_THREADS
+#include "lfft_pool.c"
+#endif /* LFFT_USE_THREADS */
+#include "lfft_plan.c"
 
 #define B_0000 0x0
 #define B_0001 0x1
@@ -104,9 +121,9 @@ START_TEST(test_f_lfft_isqrt)
 }
 END_TEST
 
-void test_switching_table_test_loop(uint16_t samples, uint16_t * switching_table)
+void test_switching_table_test_loop(uint32_t samples, uint32_t * switching_table)
 {
-    uint16_t i;
+    uint32_t i;
     lfft_Fft fft;
 
     if(!lfft_fft_new(&fft, samples))
@@ -114,8 +131,8 @@ void test_switching_table_test_loop(uint16_t samples, uint16_t * switching_table
         for(i = 0; i < samples; ++i)
         {
             fail_unless(fft.switching_table[i] == switching_table[i],
-                    "False assumption: fft.switching_table[%"PRIu16"]=%"PRIu16" | "
-                    "switching_table[%"PRIu16"]=%"PRIu16" (Samples = %"PRIu16")\n",
+                    "False assumption: fft.switching_table[%"PRIu32"]=%"PRIu32" | "
+                    "switching_table[%"PRIu32"]=%"PRIu32" (Samples = %"PRIu32")\n",
                     i, fft.switching_table[i], i, switching_table[i], samples);
         }
         lfft_fft_delete(&fft);
@@ -124,24 +141,24 @@ void test_switching_table_test_loop(uint16_t samples, uint16_t * switching_table
 
 START_TEST(test_switching_table)
 {
-    uint16_t samples;
-    uint16_t * switching_table;
+    uint32_t samples;
+    uint32_t * switching_table;
 
     samples = 2;
-    switching_table = (uint16_t *) calloc(samples, sizeof(uint16_t));
+    switching_table = (uint32_t *) calloc(samples, sizeof(uint32_t));
     switching_table[0] = B_0000; switching_table[1] = B_0001;
     test_switching_table_test_loop(samples, switching_table);
     free(switching_table);
 
     samples = 4;
-    switching_table = (uint16_t *) calloc(samples, sizeof(uint16_t));
+    switching_table = (uint32_t *) calloc(samples, sizeof(uint32_t));
     switching_table[0] = B_0000; switching_table[1] = B_0010;
     switching_table[2] = B_0001; switching_table[3] = B_0011;
     test_switching_table_test_loop(samples, switching_table);
     free(switching_table);
 
     samples = 8;
-    switching_table = (uint16_t *) calloc(samples, sizeof(uint16_t));
+    switching_table = (uint32_t *) calloc(samples, sizeof(uint32_t));
     switching_table[0] = B_0000; switching_table[1] = B_0100;
     switching_table[2] = B_0010; switching_table[3] = B_0110;
     switching_table[4] = B_0001; switching_table[5] = B_0101;
@@ -150,7 +167,7 @@ START_TEST(test_switching_table)
     free(switching_table);
 
     samples = 16;
-    switching_table = (uint16_t *) calloc(samples, sizeof(uint16_t));
+    switching_table = (uint32_t *) calloc(samples, sizeof(uint32_t));
     switching_table[0]  = B_0000; switching_table[1]  = B_1000;
     switching_table[2]  = B_0100; switching_table[3]  = B_1100;
     switching_table[4]  = B_0010; switching_table[5]  = B_1010;
@@ -259,6 +276,2340 @@ START_TEST(test_fft_ifft)
 }
 END_TEST
 
+void test_rfft_loop(uint16_t samples)
+{
+    uint16_t i;
+    int32_t * data_real = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * n_zeros   = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * result_real = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * result_imag = (int32_t *) calloc(samples, sizeof(int32_t));
+    lfft_Fft fft;
+
+    srand(samples);
+    for(i = 0; i < samples; ++i)
+    {
+        data_real[i] = (rand()%128)-64;
+    }
+
+    if(!lfft_fft_new(&fft, samples))
+    {
+        // reference: complex fft with the imaginary part set to 0
+        lfft_fft_complex(&fft, data_real, n_zeros);
+        for(i = 0; i < samples; ++i)
+        {
+            result_real[i] = lfft_fft_result_real_at(&fft, i);
+            result_imag[i] = lfft_fft_result_imag_at(&fft, i);
+        }
+
+        lfft_fft(&fft, data_real);
+        for(i = 0; i < samples; ++i)
+        {
+            fail_unless((abs(lfft_fft_result_real_at(&fft, i)-result_real[i]) <= 1) &&
+                    (abs(lfft_fft_result_imag_at(&fft, i)-result_imag[i]) <= 1),
+                    "False assumption: lfft_fft(&fft, data)[%"PRIu16"]=%"PRId32"%+"PRId32"j | "
+                    "lfft_fft_complex(&fft, data, 0)[%"PRIu16"]=%"PRId32"%+"PRId32"j (Samples = %"PRIu16")\n",
+                    i, lfft_fft_result_real_at(&fft, i), lfft_fft_result_imag_at(&fft, i),
+                    i, result_real[i], result_imag[i], samples);
+        }
+
+        // only the non-redundant elements are calculated
+        lfft_rfft(&fft, data_real);
+        for(i = 0; i <= samples/2; ++i)
+        {
+            fail_unless((abs(lfft_fft_result_real_at(&fft, i)-result_real[i]) <= 1) &&
+                    (abs(lfft_fft_result_imag_at(&fft, i)-result_imag[i]) <= 1),
+                    "False assumption: lfft_rfft(&fft, data)[%"PRIu16"]=%"PRId32"%+"PRId32"j | "
+                    "lfft_fft_complex(&fft, data, 0)[%"PRIu16"]=%"PRId32"%+"PRId32"j (Samples = %"PRIu16")\n",
+                    i, lfft_fft_result_real_at(&fft, i), lfft_fft_result_imag_at(&fft, i),
+                    i, result_real[i], result_imag[i], samples);
+        }
+
+        lfft_fft_delete(&fft);
+    }
+
+    free(data_real);
+    free(n_zeros);
+    free(result_real);
+    free(result_imag);
+}
+
+START_TEST(test_rfft)
+{
+    uint16_t samples;
+
+    for(samples = 1; samples <= 256; samples <<= 1)
+    {
+        test_rfft_loop(samples);
+    }
+}
+END_TEST
+
+double test_q15_max_error(lfft_Q15 * q15, const int16_t real[], const int16_t imag[], bool inverse)
+{
+    uint32_t n;
+    uint32_t k;
+    double angle;
+    double dft_real;
+    double dft_imag;
+    double error;
+    double max_error = 0.0;
+    double sign = inverse ? 1.0 : -1.0;
+
+    if(inverse)
+    {
+        lfft_q15_ifft_complex(q15, real, imag);
+    }
+    else
+    {
+        lfft_q15_fft_complex(q15, real, imag);
+    }
+
+    for(k = 0; k < q15->samples; k++)
+    {
+        dft_real = 0.0;
+        dft_imag = 0.0;
+        for(n = 0; n < q15->samples; n++)
+        {
+            angle = sign*2.0*M_PI*(((uint64_t) n*k)%q15->samples)/q15->samples;
+            dft_real += real[n]*cos(angle)-imag[n]*sin(angle);
+            dft_imag += real[n]*sin(angle)+imag[n]*cos(angle);
+        }
+        if(inverse)
+        {
+            dft_real /= q15->samples;
+            dft_imag /= q15->samples;
+        }
+
+        error = fabs(lfft_q15_result_real_float_at(q15, k)-dft_real);
+        max_error = (error > max_error) ? error : max_error;
+        error = fabs(lfft_q15_result_imag_float_at(q15, k)-dft_imag);
+        max_error = (error > max_error) ? error : max_error;
+    }
+
+    return max_error;
+}
+
+double test_float_max_error(lfft_Float * fft, const lfft_float real[], const lfft_float imag[], bool inverse)
+{
+    uint32_t n;
+    uint32_t k;
+    double angle;
+    double dft_real;
+    double dft_imag;
+    double error;
+    double max_error = 0.0;
+    double sign = inverse ? 1.0 : -1.0;
+
+    if(inverse)
+    {
+        lfft_float_ifft_complex(fft, real, imag);
+    }
+    else
+    {
+        lfft_float_fft_complex(fft, real, imag);
+    }
+
+    for(k = 0; k < fft->samples; k++)
+    {
+        dft_real = 0.0;
+        dft_imag = 0.0;
+        for(n = 0; n < fft->samples; n++)
+        {
+            angle = sign*2.0*M_PI*(((uint64_t) n*k)%fft->samples)/fft->samples;
+            dft_real += real[n]*cos(angle)-imag[n]*sin(angle);
+            dft_imag += real[n]*sin(angle)+imag[n]*cos(angle);
+        }
+        if(inverse)
+        {
+            dft_real /= fft->samples;
+            dft_imag /= fft->samples;
+        }
+
+        error = fabs(fft->result_real[k]-dft_real);
+        max_error = (error > max_error) ? error : max_error;
+        error = fabs(fft->result_imag[k]-dft_imag);
+        max_error = (error > max_error) ? error : max_error;
+    }
+
+    return max_error;
+}
+
+double test_dft_max_error(lfft_Fft * fft, const int32_t real[], const int32_t imag[], bool inverse)
+{
+    uint16_t k;
+    uint16_t n;
+    double angle;
+    double dft_real;
+    double dft_imag;
+    double error;
+    double max_error = 0.0;
+
+    // compare the result of fft with a dft calculated with double precision
+    for(k = 0; k < fft->samples; ++k)
+    {
+        dft_real = 0.0;
+        dft_imag = 0.0;
+        for(n = 0; n < fft->samples; ++n)
+        {
+            angle = (inverse ? 2.0 : -2.0)*M_PI*((k*n)%fft->samples)/fft->samples;
+            dft_real += real[n]*cos(angle)-imag[n]*sin(angle);
+            dft_imag += real[n]*sin(angle)+imag[n]*cos(angle);
+        }
+        if(inverse)
+        {
+            dft_real /= fft->samples;
+            dft_imag /= fft->samples;
+        }
+
+        error = fabs(lfft_fft_result_real_float_at(fft, k)-dft_real)+
+                fabs(lfft_fft_result_imag_float_at(fft, k)-dft_imag);
+        if(error > max_error)
+        {
+            max_error = error;
+        }
+    }
+
+    return max_error;
+}
+
+void test_kernel_loop(uint16_t samples, lfft_Kernel kernel)
+{
+    uint16_t i;
+    int32_t * data_real = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * data_imag = (int32_t *) calloc(samples, sizeof(int32_t));
+    double error;
+    double error_kernel;
+    lfft_Fft fft;
+    lfft_Fft fft_kernel;
+
+    srand(samples);
+    for(i = 0; i < samples; ++i)
+    {
+        data_real[i] = (rand()%128)-64;
+        data_imag[i] = (rand()%128)-64;
+    }
+
+    if(!lfft_fft_new(&fft, samples) && !lfft_fft_new_kernel(&fft_kernel, samples, kernel))
+    {
+        // the kernel must not be less accurate than the radix-2 kernel
+        lfft_fft_complex(&fft, data_real, data_imag);
+        lfft_fft_complex(&fft_kernel, data_real, data_imag);
+        error = test_dft_max_error(&fft, data_real, data_imag, false);
+        error_kernel = test_dft_max_error(&fft_kernel, data_real, data_imag, false);
+        fail_unless(error_kernel <= error+1.0,
+                "False assumption: fft error of kernel %d = %f | "
+                "fft error of radix-2 = %f (Samples = %"PRIu16")\n",
+                kernel, error_kernel, error, samples);
+
+        lfft_ifft_complex(&fft, data_real, data_imag);
+        lfft_ifft_complex(&fft_kernel, data_real, data_imag);
+        error = test_dft_max_error(&fft, data_real, data_imag, true);
+        error_kernel = test_dft_max_error(&fft_kernel, data_real, data_imag, true);
+        fail_unless(error_kernel <= error+1.0,
+                "False assumption: ifft error of kernel %d = %f | "
+                "ifft error of radix-2 = %f (Samples = %"PRIu16")\n",
+                kernel, error_kernel, error, samples);
+
+        lfft_fft_delete(&fft);
+        lfft_fft_delete(&fft_kernel);
+    }
+
+    free(data_real);
+    free(data_imag);
+}
+
+START_TEST(test_kernel_radix4)
+{
+    uint16_t samples;
+    lfft_Fft fft;
+
+    fail_unless(lfft_fft_new_kernel(&fft, 8, (lfft_Kernel) 0xFF) == 2,
+            "False assumption: lfft_fft_new_kernel(&fft, 8, 0xFF) == 2\n");
+
+    for(samples = 1; samples <= 256; samples <<= 1)
+    {
+        test_kernel_loop(samples, LFFT_KERNEL_RADIX_4);
+    }
+}
+END_TEST
+
+void test_stockham_loop(uint16_t samples)
+{
+    uint16_t i;
+    int32_t * data_real = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * data_imag = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * buffer_real = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * buffer_imag = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * workspace;
+    lfft_Fft fft;
+    lfft_Fft fft_stockham;
+
+    srand(samples);
+    for(i = 0; i < samples; ++i)
+    {
+        data_real[i] = (rand()%128)-64;
+        data_imag[i] = (rand()%128)-64;
+    }
+
+    lfft_fft_new(&fft, samples);
+    lfft_fft_new_kernel(&fft_stockham, samples, LFFT_KERNEL_STOCKHAM);
+    workspace = (int32_t *) malloc(LFFT_FFT_WORKSPACE(&fft_stockham)*sizeof(int32_t));
+
+    // the stockham kernel calculates the same butterflies as the radix-2 kernel
+    lfft_fft_complex(&fft, data_real, data_imag);
+    lfft_fft_complex(&fft_stockham, data_real, data_imag);
+    fail_unless(!memcmp(fft.result_real, fft_stockham.result_real, samples*sizeof(int32_t)) &&
+            !memcmp(fft.result_imag, fft_stockham.result_imag, samples*sizeof(int32_t)),
+            "False assumption: fft of stockham == fft of radix-2 (Samples = %"PRIu16")\n", samples);
+
+    lfft_fft_import(data_real, buffer_real, samples);
+    lfft_fft_import(data_imag, buffer_imag, samples);
+    lfft_fft_inplace(&fft_stockham, buffer_real, buffer_imag, workspace);
+    fail_unless(!memcmp(fft.result_real, buffer_real, samples*sizeof(int32_t)) &&
+            !memcmp(fft.result_imag, buffer_imag, samples*sizeof(int32_t)),
+            "False assumption: in place fft of stockham == fft of radix-2 (Samples = %"PRIu16")\n", samples);
+
+    lfft_ifft_complex(&fft, data_real, data_imag);
+    lfft_ifft_complex(&fft_stockham, data_real, data_imag);
+    fail_unless(!memcmp(fft.result_real, fft_stockham.result_real, samples*sizeof(int32_t)) &&
+            !memcmp(fft.result_imag, fft_stockham.result_imag, samples*sizeof(int32_t)),
+            "False assumption: ifft of stockham == ifft of radix-2 (Samples = %"PRIu16")\n", samples);
+
+    lfft_fft(&fft, data_real);
+    lfft_fft(&fft_stockham, data_real);
+    fail_unless(!memcmp(fft.result_real, fft_stockham.result_real, samples*sizeof(int32_t)) &&
+            !memcmp(fft.result_imag, fft_stockham.result_imag, samples*sizeof(int32_t)),
+            "False assumption: real fft of stockham == real fft of radix-2 (Samples = %"PRIu16")\n", samples);
+
+    lfft_fft_delete(&fft);
+    lfft_fft_delete(&fft_stockham);
+    free(data_real);
+    free(data_imag);
+    free(buffer_real);
+    free(buffer_imag);
+    free(workspace);
+}
+
+START_TEST(test_kernel_stockham)
+{
+    uint16_t samples;
+
+    for(samples = 1; samples <= 4096; samples <<= 1)
+    {
+        test_stockham_loop(samples);
+    }
+}
+END_TEST
+
+void test_radix2_avx2_loop(uint16_t samples, uint16_t samples_calculated, bool calculate_ifft)
+{
+#ifdef LFFT_USE_AVX2
+    uint16_t i;
+    uint8_t steps;
+    int32_t * real = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * imag = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * real_avx2 = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * imag_avx2 = (int32_t *) calloc(samples, sizeof(int32_t));
+    lfft_Fft fft;
+
+    lfft_fft_new(&fft, samples);
+    steps = fft.steps-(samples_calculated < samples);
+
+    srand(samples);
+    for(i = 0; i < samples_calculated; ++i)
+    {
+        real[i] = real_avx2[i] = ((rand()%128)-64)<<LFFT_RHS_BITS;
+        imag[i] = imag_avx2[i] = ((rand()%128)-64)<<LFFT_RHS_BITS;
+    }
+
+    _lfft_fft_radix2(&fft, samples_calculated, steps, 0, real, imag, calculate_ifft);
+    _lfft_fft_radix2_avx2(&fft, samples_calculated, steps, 0, real_avx2, imag_avx2, calculate_ifft);
+    for(i = 0; i < samples_calculated; ++i)
+    {
+        fail_unless((real[i] == real_avx2[i]) && (imag[i] == imag_avx2[i]),
+                "False assumption: radix2[%"PRIu16"]=%"PRId32"%+"PRId32"j | "
+                "radix2_avx2[%"PRIu16"]=%"PRId32"%+"PRId32"j (Samples = %"PRIu16"/%"PRIu16")\n",
+                i, real[i], imag[i], i, real_avx2[i], imag_avx2[i], samples_calculated, samples);
+    }
+
+    lfft_fft_delete(&fft);
+
+    free(real);
+    free(imag);
+    free(real_avx2);
+    free(imag_avx2);
+#endif /* LFFT_USE_AVX2 */
+}
+
+START_TEST(test_radix2_avx2)
+{
+    uint16_t samples;
+
+    // the results of the scalar and the vectorized calculation must be the
+    // same for the fft, the ifft and a fft with half the size
+    for(samples = 16; samples <= 1024; samples <<= 1)
+    {
+        test_radix2_avx2_loop(samples, samples, false);
+        test_radix2_avx2_loop(samples, samples, true);
+        test_radix2_avx2_loop(samples<<1, samples, false);
+    }
+}
+END_TEST
+
+START_TEST(test_fft_input)
+{
+    lfft_Fft fft;
+    lfft_Fft padded;
+    uint32_t samples;
+    uint32_t input_samples;
+    uint32_t counts[5];
+    uint32_t c;
+    uint32_t i;
+    int32_t amplitude;
+    int32_t * data_real;
+    int32_t * data_imag;
+    int32_t * padded_real;
+    int32_t * padded_imag;
+    int32_t * full;
+    float * data_float;
+    float * padded_float;
+
+    fail_unless(lfft_fft_new_input(&fft, 48, 12) == 1, "False assumption: lfft_fft_new_input(&fft, 48, 12) == 1\n");
+    fail_unless(lfft_fft_new_input(&fft, 64, 0) == 2, "False assumption: lfft_fft_new_input(&fft, 64, 0) == 2\n");
+    fail_unless(lfft_fft_new_input(&fft, 64, 65) == 2, "False assumption: lfft_fft_new_input(&fft, 64, 65) == 2\n");
+
+    for(samples = 1; samples <= 4096; samples <<= 1)
+    {
+        // the products of the butterflies must not overflow
+        amplitude = 16384/samples;
+        counts[0] = 1;
+        counts[1] = (samples > 3) ? 3 : samples;
+        counts[2] = (samples > 16) ? samples/16 : samples;
+        counts[3] = (samples > 1) ? samples/2+1 : samples;
+        counts[4] = samples;
+
+        fail_unless(lfft_fft_new(&padded, samples) == 0, "False assumption: lfft_fft_new(&padded, %u) == 0\n", samples);
+        padded_real = (int32_t *) calloc(samples, sizeof(int32_t));
+        padded_imag = (int32_t *) calloc(samples, sizeof(int32_t));
+        padded_float = (float *) calloc(samples, sizeof(float));
+        full = (int32_t *) malloc(2*samples*sizeof(int32_t));
+        for(i = 0; i < 2*samples; i++)
+        {
+            full[i] = (rand()%(2*amplitude+1))-amplitude;
+        }
+
+        for(c = 0; c < 5; c++)
+        {
+            input_samples = counts[c];
+            fail_unless(lfft_fft_new_input(&fft, samples, input_samples) == 0, "False assumption: lfft_fft_new_input(&fft, %u, %u) == 0\n", samples, input_samples);
+
+            // the input arrays only contain the leading samples
+            data_real = (int32_t *) malloc(input_samples*sizeof(int32_t));
+            data_imag = (int32_t *) malloc(input_samples*sizeof(int32_t));
+            data_float = (float *) malloc(input_samples*sizeof(float));
+            srand(samples+input_samples);
+            for(i = 0; i < input_samples; i++)
+            {
+                data_real[i] = padded_real[i] = (rand()%(2*amplitude+1))-amplitude;
+                data_imag[i] = padded_imag[i] = (rand()%(2*amplitude+1))-amplitude;
+                data_float[i] = padded_float[i] = (float) data_real[i]/8;
+            }
+
+            lfft_fft(&fft, data_real);
+            lfft_fft(&padded, padded_real);
+            for(i = 0; i < samples; i++)
+            {
+                fail_unless((fft.result_real[i] == padded.result_real[i]) && (fft.result_imag[i] == padded.result_imag[i]),
+                        "False assumption: lfft_fft() with %u of %u input samples == zero padded lfft_fft()\n", input_samples, samples);
+            }
+
+            lfft_fft_complex(&fft, data_real, data_imag);
+            lfft_fft_complex(&padded, padded_real, padded_imag);
+            for(i = 0; i < samples; i++)
+            {
+                fail_unless((fft.result_real[i] == padded.result_real[i]) && (fft.result_imag[i] == padded.result_imag[i]),
+                        "False assumption: lfft_fft_complex() with %u of %u input samples == zero padded lfft_fft_complex()\n", input_samples, samples);
+            }
+
+            lfft_fft_float(&fft, data_float);
+            lfft_fft_float(&padded, padded_float);
+            for(i = 0; i < samples; i++)
+            {
+                fail_unless((fft.result_real[i] == padded.result_real[i]) && (fft.result_imag[i] == padded.result_imag[i]),
+                        "False assumption: lfft_fft_float() with %u of %u input samples == zero padded lfft_fft_float()\n", input_samples, samples);
+            }
+
+            // the ifft uses all samples
+            lfft_ifft_complex(&fft, full, &full[samples]);
+            lfft_ifft_complex(&padded, full, &full[samples]);
+            for(i = 0; i < samples; i++)
+            {
+                fail_unless((fft.result_real[i] == padded.result_real[i]) && (fft.result_imag[i] == padded.result_imag[i]),
+                        "False assumption: lfft_ifft_complex() with %u of %u input samples uses all samples\n", input_samples, samples);
+            }
+
+            // the padding is zero again for the next input_samples
+            for(i = 0; i < input_samples; i++)
+            {
+                padded_real[i] = 0;
+                padded_imag[i] = 0;
+                padded_float[i] = 0;
+            }
+            lfft_fft_delete(&fft);
+            free(data_real);
+            free(data_imag);
+            free(data_float);
+        }
+
+        lfft_fft_delete(&padded);
+        free(padded_real);
+        free(padded_imag);
+        free(padded_float);
+        free(full);
+    }
+}
+END_TEST
+
+START_TEST(test_buffer_api)
+{
+    uint16_t i;
+    uint16_t samples = 64;
+    int32_t * data_real = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * data_imag = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * out_real  = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * out_imag  = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * in_real   = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * in_imag   = (int32_t *) calloc(samples, sizeof(int32_t));
+    float * out_float   = (float *) calloc(samples, sizeof(float));
+    lfft_Fft fft;
+
+    srand(samples);
+    for(i = 0; i < samples; ++i)
+    {
+        data_real[i] = (rand()%128)-64;
+        data_imag[i] = (rand()%128)-64;
+    }
+
+    lfft_fft_new(&fft, samples);
+
+    // caller provided arrays
+    lfft_fft_complex(&fft, data_real, data_imag);
+    lfft_fft_complex_out(&fft, data_real, data_imag, out_real, out_imag, NULL);
+    fail_if(memcmp(out_real, fft.result_real, samples*sizeof(int32_t)) ||
+            memcmp(out_imag, fft.result_imag, samples*sizeof(int32_t)),
+            "False assumption: lfft_fft_complex_out() == lfft_fft_complex()\n");
+
+    // in place
+    lfft_fft_import(data_real, in_real, samples);
+    lfft_fft_import(data_imag, in_imag, samples);
+    lfft_fft_inplace(&fft, in_real, in_imag, NULL);
+    fail_if(memcmp(in_real, fft.result_real, samples*sizeof(int32_t)) ||
+            memcmp(in_imag, fft.result_imag, samples*sizeof(int32_t)),
+            "False assumption: lfft_fft_inplace() == lfft_fft_complex()\n");
+
+    // the integer input of lfft_ifft_complex() has no decimal places
+    lfft_fft_export(out_real, out_real, samples);
+    lfft_fft_export(out_imag, out_imag, samples);
+    lfft_fft_import(out_real, in_real, samples);
+    lfft_fft_import(out_imag, in_imag, samples);
+    lfft_ifft_inplace(&fft, in_real, in_imag, NULL);
+    lfft_ifft_complex_out(&fft, out_real, out_imag, data_real, data_imag, NULL);
+    lfft_ifft_complex(&fft, out_real, out_imag);
+    fail_if(memcmp(in_real, fft.result_real, samples*sizeof(int32_t)) ||
+            memcmp(in_imag, fft.result_imag, samples*sizeof(int32_t)),
+            "False assumption: lfft_ifft_inplace() == lfft_ifft_complex()\n");
+    fail_if(memcmp(data_real, fft.result_real, samples*sizeof(int32_t)) ||
+            memcmp(data_imag, fft.result_imag, samples*sizeof(int32_t)),
+            "False assumption: lfft_ifft_complex_out() == lfft_ifft_complex()\n");
+
+    // real input data
+    lfft_fft_export(data_real, data_real, samples);
+    lfft_fft(&fft, data_real);
+    lfft_fft_out(&fft, data_real, out_real, out_imag, NULL);
+    fail_if(memcmp(out_real, fft.result_real, samples*sizeof(int32_t)) ||
+            memcmp(out_imag, fft.result_imag, samples*sizeof(int32_t)),
+            "False assumption: lfft_fft_out() == lfft_fft()\n");
+
+    // export of the whole result
+    lfft_fft_result(&fft, out_real, out_imag);
+    lfft_fft_export_float(fft.result_real, out_float, samples);
+    for(i = 0; i < samples; ++i)
+    {
+        fail_unless((out_real[i] == lfft_fft_result_real_at(&fft, i)) &&
+                (out_imag[i] == lfft_fft_result_imag_at(&fft, i)) &&
+                (out_float[i] == lfft_fft_result_real_float_at(&fft, i)),
+                "False assumption: lfft_fft_result()[%"PRIu16"] == lfft_fft_result_*_at(&fft, %"PRIu16")\n",
+                i, i);
+    }
+
+    lfft_fft_delete(&fft);
+
+    free(data_real);
+    free(data_imag);
+    free(out_real);
+    free(out_imag);
+    free(in_real);
+    free(in_imag);
+    free(out_float);
+}
+END_TEST
+
+START_TEST(test_plan_sharing)
+{
+    lfft_Fft fft_1;
+    lfft_Fft fft_2;
+    lfft_Fft fft_3;
+    lfft_Plan * plan;
+
+    fail_unless(lfft_plan_acquire(0) == NULL, "False assumption: lfft_plan_acquire(0) == NULL\n");
+
+    lfft_fft_new(&fft_1, 64);
+    lfft_fft_new_kernel(&fft_2, 64, LFFT_KERNEL_RADIX_4);
+    lfft_fft_new(&fft_3, 32);
+    plan = fft_1.plan;
+
+    // structs with the same number of samples share the tables
+    fail_unless((fft_2.plan == plan) && (fft_2.wk_real == fft_1.wk_real) &&
+            (fft_2.switching_table == fft_1.switching_table),
+            "False assumption: lfft_Fft structs with 64 samples share one plan\n");
+    fail_unless(fft_3.plan != plan, "False assumption: lfft_Fft structs with 32 and 64 samples share one plan\n");
+    fail_unless(plan->references == 2, "False assumption: plan->references=%"PRIu32" == 2\n", plan->references);
+    fail_unless(fft_2.result_real != fft_1.result_real,
+            "False assumption: lfft_Fft structs have different result arrays\n");
+
+    lfft_fft_delete(&fft_1);
+    fail_unless(plan->references == 1, "False assumption: plan->references=%"PRIu32" == 1\n", plan->references);
+    lfft_fft_delete(&fft_2);
+    lfft_fft_delete(&fft_3);
+
+    // deallocated plans are removed from the registry
+    fail_unless(_lfft_plans == NULL, "False assumption: all plans are released\n");
+}
+END_TEST
+
+START_TEST(test_step_wk)
+{
+    uint32_t samples;
+    uint32_t half;
+    uint32_t k;
+    lfft_Plan * plan;
+
+    for(samples = 2; samples <= 4096; samples <<= 1)
+    {
+        plan = lfft_plan_acquire(samples);
+
+        // steps with at least 4 wk values can be loaded with aligned vector loads
+        fail_unless((samples < 8) || (((uintptr_t) &plan->step_wk[LFFT_STEP_WK(4)])%LFFT_ALIGNMENT == 0),
+                "False assumption: wk values of the steps are aligned (Samples = %"PRIu32")\n", samples);
+
+        for(half = 1; half < samples; half <<= 1)
+        {
+            for(k = 0; k < half; k++)
+            {
+                fail_unless((plan->step_wk[LFFT_STEP_WK(half)+2*k] == plan->wk_real[k*(samples/(2*half))]) &&
+                        (plan->step_wk[LFFT_STEP_WK(half)+2*k+1] == plan->wk_imag[k*(samples/(2*half))]),
+                        "False assumption: step_wk[%"PRIu32"] of step %"PRIu32" == wk[%"PRIu32"] "
+                        "(Samples = %"PRIu32")\n", k, half, k*(samples/(2*half)), samples);
+            }
+        }
+
+        lfft_plan_release(plan);
+    }
+}
+END_TEST
+
+#ifdef LFFT_USE_GENERATED
+START_TEST(test_generated)
+{
+    uint8_t i;
+    uint32_t n;
+    lfft_Plan * plan;
+    lfft_Plan * computed;
+
+    for(i = 0; i < LFFT_GENERATED_COUNT; i++)
+    {
+        plan = lfft_plan_acquire(_lfft_generated_tables[i].samples);
+        fail_unless(plan->generated, "False assumption: plan of %"PRIu32" samples is generated\n", plan->samples);
+
+        // the generated tables are the same as the computed tables
+        computed = (lfft_Plan *) calloc(1, sizeof(lfft_Plan));
+        computed->samples = plan->samples;
+        _lfft_plan_power_2(computed);
+        fail_unless((computed->steps == plan->steps) && (computed->ones_mask == plan->ones_mask),
+                "False assumption: generated steps and ones_mask == computed (Samples = %"PRIu32")\n", plan->samples);
+        for(n = 0; n < plan->samples; n++)
+        {
+            fail_unless(computed->switching_table[n] == plan->switching_table[n],
+                    "False assumption: generated switching_table[%"PRIu32"] == computed (Samples = %"PRIu32")\n",
+                    n, plan->samples);
+        }
+        for(n = 0; n < plan->samples/2; n++)
+        {
+            fail_unless((computed->wk_real[n] == plan->wk_real[n]) && (computed->wk_imag[n] == plan->wk_imag[n]),
+                    "False assumption: generated wk[%"PRIu32"] == computed (Samples = %"PRIu32")\n", n, plan->samples);
+        }
+        for(n = LFFT_STEP_WK(1); n < 2*plan->samples; n++)
+        {
+            fail_unless(computed->step_wk[n] == plan->step_wk[n],
+                    "False assumption: generated step_wk[%"PRIu32"] == computed (Samples = %"PRIu32")\n",
+                    n, plan->samples);
+        }
+        _lfft_plan_delete(computed);
+
+        // generated plans are never deallocated
+        lfft_plan_release(plan);
+        fail_unless(lfft_plan_acquire(_lfft_generated_tables[i].samples) == plan,
+                "False assumption: generated plan is reused (Samples = %"PRIu32")\n", plan->samples);
+        lfft_plan_release(plan);
+    }
+}
+END_TEST
+#endif /* LFFT_USE_GENERATED */
+
+START_TEST(test_fft2_tiles)
+{
+    const uint16_t rows = 72;
+    const uint16_t columns = 128;
+    lfft_Fft2 fft2;
+    lfft_Fft fft_rows;
+    lfft_Fft fft_columns;
+    int32_t ** real;
+    int32_t ** imag;
+    int32_t * expected_real;
+    int32_t * expected_imag;
+    int32_t column_real[72];
+    int32_t column_imag[72];
+    uint16_t i;
+    uint16_t j;
+
+    fail_unless(lfft_fft2_new(&fft2, 0, columns) == 1, "False assumption: lfft_fft2_new(0 rows) == 1\n");
+
+    // sizes which are no multiple of LFFT_FFT2_TILE use partial blocks
+    fail_unless(lfft_fft2_new(&fft2, rows, columns) == 0, "False assumption: lfft_fft2_new() == 0\n");
+    lfft_fft_new(&fft_rows, columns);
+    lfft_fft_new(&fft_columns, rows);
+
+    fail_unless((((uintptr_t) fft2.data_real)%LFFT_ALIGNMENT == 0) && (((uintptr_t) fft2.data_imag)%LFFT_ALIGNMENT == 0),
+            "False assumption: 2D-fft data is aligned\n");
+
+    real = (int32_t **) malloc(rows*sizeof(int32_t *));
+    imag = (int32_t **) malloc(rows*sizeof(int32_t *));
+    expected_real = (int32_t *) malloc((size_t) rows*columns*sizeof(int32_t));
+    expected_imag = (int32_t *) malloc((size_t) rows*columns*sizeof(int32_t));
+
+    srand(24);
+    for(i = 0; i < rows; i++)
+    {
+        real[i] = (int32_t *) malloc(columns*sizeof(int32_t));
+        imag[i] = (int32_t *) malloc(columns*sizeof(int32_t));
+        for(j = 0; j < columns; j++)
+        {
+            real[i][j] = rand()%65 - 32;
+            imag[i][j] = rand()%65 - 32;
+            expected_real[i*columns+j] = real[i][j]<<LFFT_RHS_BITS;
+            expected_imag[i*columns+j] = imag[i][j]<<LFFT_RHS_BITS;
+        }
+    }
+
+    // reference: 1D-ffts of the rows and the columns
+    for(i = 0; i < rows; i++)
+    {
+        lfft_fft_inplace(&fft_rows, &expected_real[i*columns], &expected_imag[i*columns], fft_rows.workspace);
+    }
+    for(j = 0; j < columns; j++)
+    {
+        for(i = 0; i < rows; i++)
+        {
+            column_real[i] = expected_real[i*columns+j];
+            column_imag[i] = expected_imag[i*columns+j];
+        }
+        lfft_fft_inplace(&fft_columns, column_real, column_imag, fft_columns.workspace);
+        for(i = 0; i < rows; i++)
+        {
+            expected_real[i*columns+j] = column_real[i];
+            expected_imag[i*columns+j] = column_imag[i];
+        }
+    }
+
+    lfft_fft2_complex(&fft2, real, imag);
+
+    for(i = 0; i < rows; i++)
+    {
+        for(j = 0; j < columns; j++)
+        {
+            fail_unless((abs(lfft_fft2_result_real_at(&fft2, i, j) - (expected_real[i*columns+j]>>LFFT_RHS_BITS)) <= 4)
+                    && (abs(lfft_fft2_result_imag_at(&fft2, i, j) - (expected_imag[i*columns+j]>>LFFT_RHS_BITS)) <= 4),
+                    "False assumption: 2D-fft[%"PRIu16"][%"PRIu16"] == fft of rows and columns\n", i, j);
+            fail_unless(fft2.result_real[i][j] == fft2.data_real[i*fft2.stride+j],
+                    "False assumption: rows point into the contiguous data\n");
+        }
+    }
+
+    for(i = 0; i < rows; i++)
+    {
+        free(real[i]);
+        free(imag[i]);
+    }
+    free(real);
+    free(imag);
+    free(expected_real);
+    free(expected_imag);
+    lfft_fft_delete(&fft_rows);
+    lfft_fft_delete(&fft_columns);
+    lfft_fft2_delete(&fft2);
+}
+END_TEST
+
+START_TEST(test_rfft2)
+{
+    const uint16_t rows = 24;
+    const uint16_t sizes[2] = {64, 12};
+    lfft_Fft2 fft2;
+    lfft_Fft2 rfft2;
+    int32_t ** real;
+    int32_t ** spectrum_real;
+    int32_t ** spectrum_imag;
+    float ** real_float;
+    float ** spectrum_real_float;
+    float ** spectrum_imag_float;
+    uint16_t columns;
+    uint16_t i;
+    uint16_t j;
+    uint8_t s;
+
+    real = (int32_t **) malloc(rows*sizeof(int32_t *));
+    spectrum_real = (int32_t **) malloc(rows*sizeof(int32_t *));
+    spectrum_imag = (int32_t **) malloc(rows*sizeof(int32_t *));
+    real_float = (float **) malloc(rows*sizeof(float *));
+    spectrum_real_float = (float **) malloc(rows*sizeof(float *));
+    spectrum_imag_float = (float **) malloc(rows*sizeof(float *));
+    for(i = 0; i < rows; i++)
+    {
+        real[i] = (int32_t *) malloc(64*sizeof(int32_t));
+        spectrum_real[i] = (int32_t *) malloc(64*sizeof(int32_t));
+        spectrum_imag[i] = (int32_t *) malloc(64*sizeof(int32_t));
+        real_float[i] = (float *) malloc(64*sizeof(float));
+        spectrum_real_float[i] = (float *) malloc(64*sizeof(float));
+        spectrum_imag_float[i] = (float *) malloc(64*sizeof(float));
+    }
+
+    srand(25);
+    // 64 columns use the real row ffts, 12 columns the complete 2D-fft
+    for(s = 0; s < 2; s++)
+    {
+        columns = sizes[s];
+        lfft_fft2_new(&fft2, rows, columns);
+        lfft_fft2_new(&rfft2, rows, columns);
+
+        for(i = 0; i < rows; i++)
+        {
+            for(j = 0; j < columns; j++)
+            {
+                real[i][j] = rand()%129 - 64;
+                real_float[i][j] = (float) real[i][j];
+            }
+        }
+
+        lfft_fft2(&fft2, real);
+        lfft_rfft2(&rfft2, real);
+
+        for(i = 0; i < rows; i++)
+        {
+            for(j = 0; j <= columns/2; j++)
+            {
+                fail_unless((abs(lfft_fft2_result_real_at(&rfft2, i, j) - lfft_fft2_result_real_at(&fft2, i, j)) <= 8)
+                        && (abs(lfft_fft2_result_imag_at(&rfft2, i, j) - lfft_fft2_result_imag_at(&fft2, i, j)) <= 8),
+                        "False assumption: rfft2[%"PRIu16"][%"PRIu16"] == fft2 (%"PRIu16" columns)\n", i, j, columns);
+                spectrum_real[i][j] = lfft_fft2_result_real_at(&rfft2, i, j);
+                spectrum_imag[i][j] = lfft_fft2_result_imag_at(&rfft2, i, j);
+                spectrum_real_float[i][j] = (float) spectrum_real[i][j];
+                spectrum_imag_float[i][j] = (float) spectrum_imag[i][j];
+            }
+        }
+
+        lfft_rfft2_float(&fft2, real_float);
+        for(i = 0; i < rows; i++)
+        {
+            for(j = 0; j <= columns/2; j++)
+            {
+                fail_unless((fft2.result_real[i][j] == rfft2.result_real[i][j])
+                        && (fft2.result_imag[i][j] == rfft2.result_imag[i][j]),
+                        "False assumption: rfft2_float[%"PRIu16"][%"PRIu16"] == rfft2\n", i, j);
+            }
+        }
+
+        // the inverse restores the real input data from the half spectrum
+        lfft_irfft2(&rfft2, spectrum_real, spectrum_imag);
+        lfft_irfft2_float(&fft2, spectrum_real_float, spectrum_imag_float);
+        for(i = 0; i < rows; i++)
+        {
+            for(j = 0; j < columns; j++)
+            {
+                fail_unless(abs(lfft_fft2_result_real_at(&rfft2, i, j) - real[i][j]) <= 4,
+                        "False assumption: irfft2[%"PRIu16"][%"PRIu16"]=%"PRId32" == %"PRId32" (%"PRIu16" columns)\n",
+                        i, j, lfft_fft2_result_real_at(&rfft2, i, j), real[i][j], columns);
+                fail_unless(lfft_fft2_result_imag_at(&rfft2, i, j) == 0,
+                        "False assumption: imaginary part of irfft2 == 0\n");
+                fail_unless(fft2.result_real[i][j] == rfft2.result_real[i][j],
+                        "False assumption: irfft2_float[%"PRIu16"][%"PRIu16"] == irfft2\n", i, j);
+            }
+        }
+
+        lfft_fft2_delete(&fft2);
+        lfft_fft2_delete(&rfft2);
+    }
+
+    for(i = 0; i < rows; i++)
+    {
+        free(real[i]);
+        free(spectrum_real[i]);
+        free(spectrum_imag[i]);
+        free(real_float[i]);
+        free(spectrum_real_float[i]);
+        free(spectrum_imag_float[i]);
+    }
+    free(real);
+    free(spectrum_real);
+    free(spectrum_imag);
+    free(real_float);
+    free(spectrum_real_float);
+    free(spectrum_imag_float);
+}
+END_TEST
+
+START_TEST(test_shared_plan_buffers)
+{
+    const uint16_t samples = 64;
+    lfft_Fft fft;
+    lfft_Fft2 fft2;
+    int32_t * rows_real;
+    int32_t * rows_imag;
+    int32_t ** real;
+    int32_t real_1[64];
+    int32_t imag_1[64];
+    int32_t real_2[64];
+    int32_t imag_2[64];
+    int32_t data[64];
+    int32_t zero[64];
+    int32_t workspace_1[256];
+    int32_t workspace_2[256];
+    size_t n;
+    uint16_t i;
+    uint16_t j;
+    uint16_t k;
+
+    lfft_fft_new(&fft, samples);
+
+    // two workspaces of one read-only plan don't influence each other
+    for(i = 0; i < samples; i++)
+    {
+        real_1[i] = ((int32_t) (i%7) - 3)<<LFFT_RHS_BITS;
+        imag_1[i] = 0;
+        real_2[i] = (i == 1) ? 1<<LFFT_RHS_BITS : 0;
+        imag_2[i] = 0;
+    }
+    lfft_fft_inplace(&fft, real_1, imag_1, NULL);
+    lfft_fft_inplace(&fft, real_2, imag_2, NULL);
+    lfft_ifft_inplace(&fft, real_1, imag_1, NULL);
+
+    for(i = 0; i < samples; i++)
+    {
+        fail_unless(abs(real_1[i] - (((int32_t) (i%7) - 3)<<LFFT_RHS_BITS)) <= (1<<LFFT_RHS_BITS),
+                "False assumption: real_1[%"PRIu16"]=%"PRId32" is restored\n", i, real_1[i]);
+        // fft of a shifted impulse has a magnitude of 1 in every bin
+        fail_unless(abs(lfft_isqrt(real_2[i]*real_2[i] + imag_2[i]*imag_2[i]) - (1<<LFFT_RHS_BITS)) <= 8,
+                "False assumption: |X_2[%"PRIu16"]| == 1\n", i);
+    }
+
+    lfft_fft_delete(&fft);
+
+    // the bluestein algorithm and the stockham kernel only use the workspace
+    // of the caller, the workspace of the struct is not changed
+    for(k = 0; k < 2; k++)
+    {
+        if(k == 0)
+        {
+            lfft_fft_new(&fft, 61);
+        }
+        else
+        {
+            lfft_fft_new_kernel(&fft, 64, LFFT_KERNEL_STOCKHAM);
+        }
+        fail_unless((LFFT_FFT_WORKSPACE(&fft) > 0) && (LFFT_FFT_WORKSPACE(&fft) <= 256),
+                "False assumption: 0 < LFFT_FFT_WORKSPACE() <= 256 (Samples = %"PRIu32")\n", fft.samples);
+        memset(fft.workspace, 0x5a, LFFT_FFT_WORKSPACE(&fft)*sizeof(int32_t));
+
+        for(i = 0; i < fft.samples; i++)
+        {
+            data[i] = (int32_t) (i%7) - 3;
+            zero[i] = 0;
+            real_1[i] = data[i]<<LFFT_RHS_BITS;
+            imag_1[i] = 0;
+            real_2[i] = (i == 1) ? 1<<LFFT_RHS_BITS : 0;
+            imag_2[i] = 0;
+        }
+        lfft_fft_inplace(&fft, real_1, imag_1, workspace_1);
+        lfft_fft_inplace(&fft, real_2, imag_2, workspace_2);
+        lfft_ifft_inplace(&fft, real_2, imag_2, workspace_1);
+
+        for(n = 0; n < LFFT_FFT_WORKSPACE(&fft); n++)
+        {
+            fail_unless(fft.workspace[n] == 0x5a5a5a5a,
+                    "False assumption: fft.workspace[%u] is unchanged (Samples = %"PRIu32")\n", (unsigned) n, fft.samples);
+        }
+
+        lfft_fft_complex(&fft, data, zero);
+        fail_unless(!memcmp(real_1, fft.result_real, fft.samples*sizeof(int32_t)) &&
+                !memcmp(imag_1, fft.result_imag, fft.samples*sizeof(int32_t)),
+                "False assumption: lfft_fft_inplace() with a workspace == lfft_fft_complex() (Samples = %"PRIu32")\n",
+                fft.samples);
+        for(i = 0; i < fft.samples; i++)
+        {
+            fail_unless(abs(real_2[i] - ((i == 1) ? 1<<LFFT_RHS_BITS : 0)) <= 8,
+                    "False assumption: real_2[%"PRIu16"]=%"PRId32" is restored\n", i, real_2[i]);
+        }
+
+        lfft_fft_delete(&fft);
+    }
+
+    // the 2D-fft doesn't replace the result arrays of its 1D-ffts
+    lfft_fft2_new(&fft2, 4, 8);
+    rows_real = fft2.fft_rows->result_real;
+    rows_imag = fft2.fft_rows->result_imag;
+
+    real = (int32_t **) malloc(4*sizeof(int32_t *));
+    for(i = 0; i < 4; i++)
+    {
+        real[i] = (int32_t *) calloc(8, sizeof(int32_t));
+    }
+    real[0][0] = 1;
+
+    lfft_fft2(&fft2, real);
+
+    fail_unless((fft2.fft_rows->result_real == rows_real) && (fft2.fft_rows->result_imag == rows_imag),
+            "False assumption: fft2.fft_rows result arrays are unchanged\n");
+    for(i = 0; i < 4; i++)
+    {
+        for(j = 0; j < 8; j++)
+        {
+            fail_unless((lfft_fft2_result_real_at(&fft2, i, j) == 1) && (lfft_fft2_result_imag_at(&fft2, i, j) == 0),
+                    "False assumption: 2D-fft of an impulse at [%"PRIu16"][%"PRIu16"] == 1\n", i, j);
+        }
+        free(real[i]);
+    }
+
+    free(real);
+    lfft_fft2_delete(&fft2);
+}
+END_TEST
+
+START_TEST(test_batch)
+{
+    const uint16_t samples = 32;
+    const uint32_t count = 11; // one full batch and one partial batch
+    const uint32_t in_stride = 40;
+    const uint32_t out_stride = 36;
+    lfft_Fft fft;
+    int32_t * real = (int32_t *) malloc(count*in_stride*sizeof(int32_t));
+    int32_t * imag = (int32_t *) malloc(count*in_stride*sizeof(int32_t));
+    int32_t * zero = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * batch_real = (int32_t *) malloc(count*out_stride*sizeof(int32_t));
+    int32_t * batch_imag = (int32_t *) malloc(count*out_stride*sizeof(int32_t));
+    int32_t single_real[32];
+    int32_t single_imag[32];
+    uint32_t b;
+    uint16_t i;
+    uint8_t mode;
+
+    lfft_fft_new(&fft, samples);
+
+    for(b = 0; b < count*in_stride; b++)
+    {
+        real[b] = (int32_t) ((b*37)%61) - 30;
+        imag[b] = (int32_t) ((b*53)%29) - 14;
+    }
+
+    // mode 0: fft complex, 1: fft real, 2: ifft complex, 3: ifft real
+    for(mode = 0; mode < 4; mode++)
+    {
+        switch(mode)
+        {
+            case 0:
+                fail_unless(lfft_fft_batch_complex(&fft, count, real, imag, in_stride,
+                        batch_real, batch_imag, out_stride) == 0, "False assumption: lfft_fft_batch_complex() == 0\n");
+                break;
+            case 1:
+                fail_unless(lfft_fft_batch(&fft, count, real, in_stride,
+                        batch_real, batch_imag, out_stride) == 0, "False assumption: lfft_fft_batch() == 0\n");
+                break;
+            case 2:
+                fail_unless(lfft_ifft_batch_complex(&fft, count, real, imag, in_stride,
+                        batch_real, batch_imag, out_stride) == 0, "False assumption: lfft_ifft_batch_complex() == 0\n");
+                break;
+            default:
+                fail_unless(lfft_ifft_batch(&fft, count, real, in_stride,
+                        batch_real, batch_imag, out_stride) == 0, "False assumption: lfft_ifft_batch() == 0\n");
+                break;
+        }
+
+        // every signal of the batch has the same result as a single fft
+        for(b = 0; b < count; b++)
+        {
+            if(mode < 2)
+            {
+                lfft_fft_complex_out(&fft, &real[b*in_stride], (mode == 0) ? &imag[b*in_stride] : zero,
+                        single_real, single_imag, fft.workspace);
+            }
+            else
+            {
+                lfft_ifft_complex_out(&fft, &real[b*in_stride], (mode == 2) ? &imag[b*in_stride] : zero,
+                        single_real, single_imag, fft.workspace);
+            }
+
+            for(i = 0; i < samples; i++)
+            {
+                fail_unless((batch_real[b*out_stride+i] == single_real[i]) &&
+                        (batch_imag[b*out_stride+i] == single_imag[i]),
+                        "False assumption: batch result of signal %"PRIu32" at %"PRIu16" equals the single fft (mode %"PRIu8")\n",
+                        b, i, mode);
+            }
+        }
+    }
+
+    lfft_fft_delete(&fft);
+    free(real);
+    free(imag);
+    free(zero);
+    free(batch_real);
+    free(batch_imag);
+}
+END_TEST
+
+void test_large_loop(uint32_t samples)
+{
+    uint32_t i;
+    lfft_Fft fft;
+    lfft_Large large;
+    int32_t * data_real = (int32_t *) malloc(samples*sizeof(int32_t));
+    int32_t * data_imag = (int32_t *) malloc(samples*sizeof(int32_t));
+    double error;
+    double error_large;
+
+    lfft_fft_new(&fft, samples);
+    fail_unless(lfft_large_new(&large, samples) == 0,
+            "False assumption: lfft_large_new(&large, %"PRIu32") == 0\n", samples);
+    fail_unless(large.samples_1*large.samples_2 == samples,
+            "False assumption: %"PRIu32"*%"PRIu32" == %"PRIu32"\n", large.samples_1, large.samples_2, samples);
+
+    for(i = 0; i < samples; i++)
+    {
+        data_real[i] = (int32_t) ((i*37)%5) - 2;
+        data_imag[i] = (int32_t) ((i*53)%3) - 1;
+    }
+
+    // the six-step fft is at least as exact as the radix-2 fft
+    lfft_fft_complex(&fft, data_real, data_imag);
+    error = test_dft_max_error(&fft, data_real, data_imag, false);
+    lfft_large_fft_complex(&large, data_real, data_imag);
+    memcpy(fft.result_real, large.result_real, samples*sizeof(int32_t));
+    memcpy(fft.result_imag, large.result_imag, samples*sizeof(int32_t));
+    error_large = test_dft_max_error(&fft, data_real, data_imag, false);
+    fail_unless(error_large <= error+1.0,
+            "False assumption: fft error of six-step = %f | "
+            "fft error of radix-2 = %f (Samples = %"PRIu32")\n", error_large, error, samples);
+
+    lfft_ifft_complex(&fft, data_real, data_imag);
+    error = test_dft_max_error(&fft, data_real, data_imag, true);
+    lfft_large_ifft_complex(&large, data_real, data_imag);
+    memcpy(fft.result_real, large.result_real, samples*sizeof(int32_t));
+    memcpy(fft.result_imag, large.result_imag, samples*sizeof(int32_t));
+    error_large = test_dft_max_error(&fft, data_real, data_imag, true);
+    fail_unless(error_large <= error+1.0,
+            "False assumption: ifft error of six-step = %f | "
+            "ifft error of radix-2 = %f (Samples = %"PRIu32")\n", error_large, error, samples);
+
+    lfft_large_delete(&large);
+    lfft_fft_delete(&fft);
+    free(data_real);
+    free(data_imag);
+}
+
+START_TEST(test_large)
+{
+    lfft_Large large;
+
+    fail_unless(lfft_large_new(&large, 2) == 1, "False assumption: lfft_large_new(&large, 2) == 1\n");
+    fail_unless(lfft_large_new(&large, 48) == 1, "False assumption: lfft_large_new(&large, 48) == 1\n");
+
+    test_large_loop(4);
+    test_large_loop(64);
+    test_large_loop(512);
+    test_large_loop(2048);
+}
+END_TEST
+
+void test_mixed_loop(uint16_t samples, double max_error)
+{
+    uint16_t i;
+    int32_t * data_real = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * data_imag = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * buffer_real = (int32_t *) calloc(samples, sizeof(int32_t));
+    int32_t * buffer_imag = (int32_t *) calloc(samples, sizeof(int32_t));
+    double error;
+    lfft_Fft fft;
+
+    srand(samples);
+    for(i = 0; i < samples; ++i)
+    {
+        data_real[i] = (rand()%128)-64;
+        data_imag[i] = (rand()%128)-64;
+    }
+
+    fail_unless(lfft_fft_new(&fft, samples) == 0,
+            "False assumption: lfft_fft_new(&fft, %"PRIu16") == 0\n", samples);
+
+    lfft_fft_complex(&fft, data_real, data_imag);
+    error = test_dft_max_error(&fft, data_real, data_imag, false);
+    fail_unless(error <= max_error,
+            "False assumption: fft error = %f <= %f (Samples = %"PRIu16")\n", error, max_error, samples);
+
+    // the in place calculation has the same result
+    lfft_fft_import(data_real, buffer_real, samples);
+    lfft_fft_import(data_imag, buffer_imag, samples);
+    lfft_fft_inplace(&fft, buffer_real, buffer_imag, fft.workspace);
+    fail_unless(!memcmp(buffer_real, fft.result_real, samples*sizeof(int32_t)) &&
+            !memcmp(buffer_imag, fft.result_imag, samples*sizeof(int32_t)),
+            "False assumption: lfft_fft_inplace() == lfft_fft_complex() (Samples = %"PRIu16")\n", samples);
+
+    // the batch functions calculate one signal after the other
+    lfft_fft_batch_complex(&fft, 1, data_real, data_imag, samples, buffer_real, buffer_imag, samples);
+    fail_unless(!memcmp(buffer_real, fft.result_real, samples*sizeof(int32_t)) &&
+            !memcmp(buffer_imag, fft.result_imag, samples*sizeof(int32_t)),
+            "False assumption: lfft_fft_batch_complex() == lfft_fft_complex() (Samples = %"PRIu16")\n", samples);
+
+    lfft_ifft_complex(&fft, data_real, data_imag);
+    error = test_dft_max_error(&fft, data_real, data_imag, true);
+    fail_unless(error <= max_error/samples+1.0,
+            "False assumption: ifft error = %f <= %f (Samples = %"PRIu16")\n", error, max_error/samples+1.0, samples);
+
+    // real input data uses the complex calculation with imaginary part 0
+    memset(data_imag, 0, samples*sizeof(int32_t));
+    lfft_fft(&fft, data_real);
+    error = test_dft_max_error(&fft, data_real, data_imag, false);
+    fail_unless(error <= max_error,
+            "False assumption: real fft error = %f <= %f (Samples = %"PRIu16")\n", error, max_error, samples);
+
+    lfft_fft_delete(&fft);
+    free(data_real);
+    free(data_imag);
+    free(buffer_real);
+    free(buffer_imag);
+}
+
+START_TEST(test_mixed_radix)
+{
+    lfft_Fft fft;
+
+    fail_unless(lfft_fft_new(&fft, 0) == 1, "False assumption: lfft_fft_new(&fft, 0) == 1\n");
+
+    // the inner fft of bluestein sizes above 2^30 would have more than 2^31 samples
+    fail_unless(lfft_plan_is_supported(LFFT_BLUESTEIN_MAX_SAMPLES-1) && lfft_plan_is_supported(1UL<<31)
+            && lfft_plan_is_supported(3UL<<29), "False assumption: lfft_plan_is_supported() of supported sizes\n");
+    fail_unless(!lfft_plan_is_supported(0) && !lfft_plan_is_supported(LFFT_BLUESTEIN_MAX_SAMPLES+1)
+            && !lfft_plan_is_supported((1UL<<31)+1) && !lfft_plan_is_supported(0xFFFFFFFF),
+            "False assumption: lfft_plan_is_supported() of unsupported sizes\n");
+    fail_unless(lfft_fft_new(&fft, (1UL<<31)+1) == 1, "False assumption: lfft_fft_new(&fft, 2^31+1) == 1\n");
+
+    // products of 2, 3, 5 and 7
+    // the error is about the error of a radix-2 fft of the same size
+    test_mixed_loop(3, 2.0);
+    test_mixed_loop(6, 2.0);
+    test_mixed_loop(15, 4.0);
+    test_mixed_loop(35, 8.0);
+    test_mixed_loop(480, 50.0);
+    test_mixed_loop(1000, 80.0);
+}
+END_TEST
+
+START_TEST(test_bluestein)
+{
+    lfft_Fft fft;
+
+    // the bluestein algorithm is used for all other sizes
+    // the error is about twice the error of a radix-2 fft of the same size
+    test_mixed_loop(11, 4.0);
+    test_mixed_loop(22, 8.0);
+    test_mixed_loop(221, 48.0);
+    test_mixed_loop(1009, 140.0);
+
+    lfft_fft_new(&fft, 1009);
+    fail_unless((fft.plan->inner != NULL) && (fft.plan->inner->samples == 2048),
+            "False assumption: the bluestein algorithm of 1009 samples uses a fft with 2048 samples\n");
+    lfft_fft_delete(&fft);
+}
+END_TEST
+
+START_TEST(test_q15)
+{
+    lfft_Q15 q15;
+    uint32_t i;
+    uint32_t samples;
+    int8_t exponent;
+    double error;
+    int16_t * data_real;
+    int16_t * data_imag;
+    int16_t * copy_real;
+    int16_t * copy_imag;
+
+    fail_unless(lfft_q15_new(&q15, 48) == 1, "False assumption: lfft_q15_new(&q15, 48) == 1\n");
+
+    for(samples = 2; samples <= 1024; samples <<= 1)
+    {
+        data_real = (int16_t *) malloc(samples*sizeof(int16_t));
+        data_imag = (int16_t *) malloc(samples*sizeof(int16_t));
+        copy_real = (int16_t *) malloc(samples*sizeof(int16_t));
+        copy_imag = (int16_t *) malloc(samples*sizeof(int16_t));
+
+        fail_unless(lfft_q15_new(&q15, samples) == 0, "False assumption: lfft_q15_new(&q15, %u) == 0\n", samples);
+
+        // full scale input
+        srand(samples);
+        for(i = 0; i < samples; i++)
+        {
+            data_real[i] = (int16_t) ((rand()%65535)-32767);
+            data_imag[i] = (int16_t) ((rand()%65535)-32767);
+        }
+
+        // the rounding errors of all steps add up to a few 2^exponent, about 65 dB snr
+        error = test_q15_max_error(&q15, data_real, data_imag, false);
+        fail_unless(error < 2.0*sqrt(samples)*ldexp(1.0, q15.exponent),
+                "False assumption: q15 fft with %u samples has an error of %f (exponent %d)\n", samples, error, q15.exponent);
+        error = test_q15_max_error(&q15, data_real, data_imag, true);
+        fail_unless(error < 2.0*sqrt(samples)*ldexp(1.0, q15.exponent),
+                "False assumption: q15 ifft with %u samples has an error of %f (exponent %d)\n", samples, error, q15.exponent);
+
+        // small input is not shifted
+        for(i = 0; i < samples; i++)
+        {
+            data_real[i] = (int16_t) ((rand()%201)-100);
+            data_imag[i] = 0;
+        }
+        lfft_q15_fft(&q15, data_real);
+        if(samples <= 128)
+        {
+            fail_unless(q15.exponent == 0, "False assumption: q15 fft of small input with %u samples is not shifted\n", samples);
+        }
+
+        // in place calculation, fft followed by ifft returns the input
+        for(i = 0; i < samples; i++)
+        {
+            copy_real[i] = data_real[i];
+            copy_imag[i] = data_imag[i];
+        }
+        exponent = lfft_q15_fft_inplace(&q15, copy_real, copy_imag);
+        fail_unless(exponent == q15.exponent, "False assumption: lfft_q15_fft_inplace() == q15.exponent\n");
+        for(i = 0; i < samples; i++)
+        {
+            fail_unless((copy_real[i] == q15.result_real[i]) && (copy_imag[i] == q15.result_imag[i]),
+                    "False assumption: lfft_q15_fft_inplace() == lfft_q15_fft()\n");
+        }
+        exponent += lfft_q15_ifft_inplace(&q15, copy_real, copy_imag);
+        for(i = 0; i < samples; i++)
+        {
+            error = fabs(ldexp(copy_real[i], exponent)-data_real[i]);
+            fail_unless(error <= 4.0*ldexp(1.0, exponent+q15.steps),
+                    "False assumption: q15 ifft(fft(x)) == x with %u samples (error %f)\n", samples, error);
+        }
+
+#ifdef LFFT_USE_AVX2
+        // the avx2 steps are bit for bit the same as the portable step
+        for(i = 0; i < samples; i++)
+        {
+            data_real[i] = (int16_t) ((rand()%27145)-13572);
+            data_imag[i] = (int16_t) ((rand()%27145)-13572);
+            copy_real[i] = data_real[i];
+            copy_imag[i] = data_imag[i];
+        }
+        for(i = 1; (samples >= 32) && (i < samples); i <<= 1)
+        {
+            error = _lfft_q15_step(&q15, data_real, data_imag, i, (i == 1) ? 0 : 2, (i&2) != 0);
+            if(i >= 16)
+            {
+                error -= _lfft_q15_step_avx2(&q15, copy_real, copy_imag, i, (i == 1) ? 0 : 2, (i&2) != 0);
+            }
+            else
+            {
+                error -= _lfft_q15_step_avx2_small(&q15, copy_real, copy_imag, i, (i == 1) ? 0 : 2, (i&2) != 0);
+            }
+            fail_unless(error == 0.0, "False assumption: the avx2 step returns the same maximum as the portable step\n");
+        }
+        for(i = 0; i < samples; i++)
+        {
+            fail_unless((data_real[i] == copy_real[i]) && (data_imag[i] == copy_imag[i]),
+                    "False assumption: _lfft_q15_step_avx2() == _lfft_q15_step() with %u samples\n", samples);
+        }
+#endif /* LFFT_USE_AVX2 */
+
+        lfft_q15_delete(&q15);
+        free(data_real);
+        free(data_imag);
+        free(copy_real);
+        free(copy_imag);
+    }
+
+    // the headroom is checked after the rounding of the scaling
+    fail_unless((_lfft_q15_shift(13572) == 0) && (_lfft_q15_shift(13573) == 1) && (_lfft_q15_shift(27144) == 1)
+            && (_lfft_q15_shift(27145) == 2) && (_lfft_q15_shift(32768) == 2),
+            "False assumption: _lfft_q15_shift() of the rounded maximum\n");
+
+    samples = 2048;
+    lfft_q15_new(&q15, samples);
+    data_real = (int16_t *) calloc(samples, sizeof(int16_t));
+    data_imag = (int16_t *) calloc(samples, sizeof(int16_t));
+    copy_real = (int16_t *) calloc(samples, sizeof(int16_t));
+    copy_imag = (int16_t *) calloc(samples, sizeof(int16_t));
+
+    // 27145 with a shift of 1 bit wraps the butterfly at 45 degrees
+    data_real[255] = data_real[1279] = data_imag[1279] = 27145;
+    copy_real[255] = copy_real[1279] = copy_imag[1279] = 27145;
+    fail_unless(_lfft_q15_step(&q15, data_real, data_imag, 1024, _lfft_q15_shift(27145), false) <= INT16_MAX,
+            "False assumption: _lfft_q15_step() at the headroom doesn't overflow\n");
+    fail_unless(data_real[255] > 0,
+            "False assumption: _lfft_q15_step() at the headroom doesn't wrap\n");
+#ifdef LFFT_USE_AVX2
+    fail_unless(_lfft_q15_step_avx2(&q15, copy_real, copy_imag, 1024, _lfft_q15_shift(27145), false) <= INT16_MAX,
+            "False assumption: _lfft_q15_step_avx2() at the headroom doesn't overflow\n");
+    for(i = 0; i < samples; i++)
+    {
+        fail_unless((data_real[i] == copy_real[i]) && (data_imag[i] == copy_imag[i]),
+                "False assumption: _lfft_q15_step_avx2() == _lfft_q15_step() at the headroom\n");
+    }
+#endif /* LFFT_USE_AVX2 */
+
+    lfft_q15_delete(&q15);
+    free(data_real);
+    free(data_imag);
+    free(copy_real);
+    free(copy_imag);
+}
+END_TEST
+
+START_TEST(test_float)
+{
+    lfft_Float fft;
+    lfft_Float fft_inverse;
+    uint32_t i;
+    uint32_t samples;
+    double error;
+    lfft_float * data_real;
+    lfft_float * data_imag;
+    // rounding error of one operation
+    double epsilon = (sizeof(lfft_float) == sizeof(double)) ? DBL_EPSILON : FLT_EPSILON;
+
+    fail_unless(lfft_float_new(&fft, 48) == 1, "False assumption: lfft_float_new(&fft, 48) == 1\n");
+
+    for(samples = 1; samples <= 2048; samples <<= 1)
+    {
+        data_real = (lfft_float *) malloc(samples*sizeof(lfft_float));
+        data_imag = (lfft_float *) malloc(samples*sizeof(lfft_float));
+
+        fail_unless(lfft_float_new(&fft, samples) == 0, "False assumption: lfft_float_new(&fft, %u) == 0\n", samples);
+        fail_unless(lfft_float_new(&fft_inverse, samples) == 0, "False assumption: lfft_float_new(&fft_inverse, %u) == 0\n", samples);
+        fail_unless(fft.plan == fft_inverse.plan, "False assumption: lfft_Float structs share the plan\n");
+
+        srand(samples);
+        for(i = 0; i < samples; i++)
+        {
+            data_real[i] = (lfft_float) ((rand()%2001)-1000)/1000;
+            data_imag[i] = (lfft_float) ((rand()%2001)-1000)/1000;
+        }
+
+        // the error of the reference dft grows with samples too
+        error = test_float_max_error(&fft, data_real, data_imag, false);
+        fail_unless(error < 2.0*(samples+1)*epsilon,
+                "False assumption: float fft with %u samples has an error of %e\n", samples, error);
+        error = test_float_max_error(&fft, data_real, data_imag, true);
+        fail_unless(error < 2.0*(samples+1)*epsilon/samples,
+                "False assumption: float ifft with %u samples has an error of %e\n", samples, error);
+
+        // ifft(fft(x)) == x
+        lfft_float_fft_complex(&fft, data_real, data_imag);
+        lfft_float_ifft_complex(&fft_inverse, fft.result_real, fft.result_imag);
+        for(i = 0; i < samples; i++)
+        {
+            error = fabs(fft_inverse.result_real[i]-data_real[i]);
+            error = (fabs(fft_inverse.result_imag[i]-data_imag[i]) > error) ? fabs(fft_inverse.result_imag[i]-data_imag[i]) : error;
+            fail_unless(error < 4.0*(fft.steps+1)*epsilon,
+                    "False assumption: float ifft(fft(x)) == x with %u samples (error %e)\n", samples, error);
+        }
+
+        // real input
+        lfft_float_fft(&fft, data_real);
+        for(i = 0; i < samples; i++)
+        {
+            data_imag[i] = 0;
+        }
+        lfft_float_fft_complex(&fft_inverse, data_real, data_imag);
+        for(i = 0; i < samples; i++)
+        {
+            fail_unless((fft.result_real[i] == fft_inverse.result_real[i]) && (fft.result_imag[i] == fft_inverse.result_imag[i]),
+                    "False assumption: lfft_float_fft() == lfft_float_fft_complex() with imag = 0\n");
+        }
+
+        lfft_float_delete(&fft);
+        lfft_float_delete(&fft_inverse);
+        free(data_real);
+        free(data_imag);
+    }
+}
+END_TEST
+
+static void test_stft_callback(void * argument, const lfft_Stft * stft)
+{
+    // the callback is called once with every spectrum
+    *((uint32_t *) argument) += 1;
+    fail_unless(stft->ready && (stft->frames == *((uint32_t *) argument)),
+            "False assumption: callback is called with spectrum %u\n", *((uint32_t *) argument));
+}
+
+START_TEST(test_stft)
+{
+    lfft_Stft stft;
+    lfft_Stft chunked;
+    lfft_Fft fft;
+    uint32_t samples;
+    uint32_t hop;
+    uint32_t total;
+    uint32_t used;
+    uint32_t offset;
+    uint32_t frames;
+    uint32_t calls;
+    uint32_t i;
+    uint32_t k;
+    int32_t * data;
+    int32_t * frame;
+    double angle;
+    double window;
+    double dft_real;
+    double dft_imag;
+    double error;
+
+    fail_unless(lfft_stft_new(&stft, 48, 12, LFFT_WINDOW_HANN) == 1, "False assumption: lfft_stft_new(&stft, 48, 12, LFFT_WINDOW_HANN) == 1\n");
+    fail_unless(lfft_stft_new(&stft, 64, 0, LFFT_WINDOW_HANN) == 2, "False assumption: lfft_stft_new(&stft, 64, 0, LFFT_WINDOW_HANN) == 2\n");
+    fail_unless(lfft_stft_new(&stft, 64, 65, LFFT_WINDOW_HANN) == 2, "False assumption: lfft_stft_new(&stft, 64, 65, LFFT_WINDOW_HANN) == 2\n");
+
+    for(samples = 2; samples <= 256; samples <<= 1)
+    {
+        for(hop = 1; hop <= samples; hop <<= 1)
+        {
+            total = 3*samples+hop;
+            data = (int32_t *) malloc(total*sizeof(int32_t));
+            frame = (int32_t *) malloc(samples*sizeof(int32_t));
+
+            srand(samples+hop);
+            for(i = 0; i < total; i++)
+            {
+                data[i] = (rand()%201)-100;
+            }
+
+            // rectangular window: every spectrum is the real fft of the last samples input samples
+            fail_unless(lfft_stft_new(&stft, samples, hop, LFFT_WINDOW_RECTANGULAR) == 0, "False assumption: lfft_stft_new(&stft, %u, %u, LFFT_WINDOW_RECTANGULAR) == 0\n", samples, hop);
+            fail_unless(lfft_fft_new(&fft, samples) == 0, "False assumption: lfft_fft_new(&fft, %u) == 0\n", samples);
+            for(offset = 0; offset < total; offset += used)
+            {
+                used = lfft_stft_write(&stft, &data[offset], total-offset);
+                fail_unless(stft.ready, "False assumption: lfft_stft_write() calculates a spectrum after every hop\n");
+
+                // the samples before the input are zero
+                for(i = 0; i < samples; i++)
+                {
+                    frame[i] = (offset+used+i >= samples) ? data[offset+used+i-samples] : 0;
+                }
+                lfft_rfft(&fft, frame);
+                for(k = 0; k <= samples/2; k++)
+                {
+                    fail_unless((stft.fft.result_real[k] == fft.result_real[k]) && (stft.fft.result_imag[k] == fft.result_imag[k]),
+                            "False assumption: stft spectrum %u with %u samples and hop %u == lfft_rfft()\n", stft.frames, samples, hop);
+                }
+            }
+            fail_unless(stft.frames == total/hop, "False assumption: %u spectra with %u samples and hop %u\n", stft.frames, samples, hop);
+            lfft_fft_delete(&fft);
+            lfft_stft_delete(&stft);
+
+            // hann window: chunks which are not aligned to the hop give the same spectra
+            fail_unless(lfft_stft_new(&stft, samples, hop, LFFT_WINDOW_HANN) == 0, "False assumption: lfft_stft_new(&stft, %u, %u, LFFT_WINDOW_HANN) == 0\n", samples, hop);
+            fail_unless(lfft_stft_new(&chunked, samples, hop, LFFT_WINDOW_HANN) == 0, "False assumption: lfft_stft_new(&chunked, %u, %u, LFFT_WINDOW_HANN) == 0\n", samples, hop);
+            calls = 0;
+            frames = lfft_stft_process(&stft, data, total, test_stft_callback, &calls);
+            fail_unless(frames == total/hop, "False assumption: lfft_stft_process() returns %u spectra\n", frames);
+
+            frames = 0;
+            calls = 0;
+            for(offset = 0; offset < total; offset += used)
+            {
+                used = ((offset%7)+1 < total-offset) ? (offset%7)+1 : total-offset;
+                frames += lfft_stft_process(&chunked, &data[offset], used, test_stft_callback, &calls);
+            }
+            fail_unless((frames == total/hop) && (calls == total/hop),
+                    "False assumption: chunked lfft_stft_process() calculates %u spectra\n", frames);
+
+            // the last spectrum is close to the dft of the windowed frame
+            for(k = 0; k <= samples/2; k++)
+            {
+                fail_unless((stft.fft.result_real[k] == chunked.fft.result_real[k]) && (stft.fft.result_imag[k] == chunked.fft.result_imag[k]),
+                        "False assumption: chunked stft with %u samples and hop %u == stft\n", samples, hop);
+
+                dft_real = 0.0;
+                dft_imag = 0.0;
+                for(i = 0; i < samples; i++)
+                {
+                    window = (0.5-0.5*cos((2.0*M_PI*i)/samples))*(1<<LFFT_RHS_BITS);
+                    angle = -2.0*M_PI*((k*i)%samples)/samples;
+                    dft_real += data[total-samples+i]*window*cos(angle);
+                    dft_imag += data[total-samples+i]*window*sin(angle);
+                }
+
+                // rounding of the window values and of every step
+                error = fabs(stft.fft.result_real[k]-dft_real);
+                error = (fabs(stft.fft.result_imag[k]-dft_imag) > error) ? fabs(stft.fft.result_imag[k]-dft_imag) : error;
+                fail_unless(error < 50.0*samples+2.0*(stft.fft.steps+1),
+                        "False assumption: hann stft bin %u with %u samples and hop %u has an error of %f\n", k, samples, hop, error);
+            }
+
+            lfft_stft_delete(&stft);
+            lfft_stft_delete(&chunked);
+            free(data);
+            free(frame);
+        }
+    }
+}
+END_TEST
+
+START_TEST(test_sdft)
+{
+    lfft_Sdft sdft;
+    lfft_Sdft fresh;
+    lfft_Sdft subset;
+    uint32_t bins[3];
+    uint32_t samples;
+    uint32_t total;
+    uint32_t i;
+    uint32_t k;
+    int32_t * data;
+    double angle;
+    double dft_real;
+    double dft_imag;
+    double error;
+
+    fail_unless(lfft_sdft_new(&sdft, 48, NULL, 0) == 1, "False assumption: lfft_sdft_new(&sdft, 48, NULL, 0) == 1\n");
+    bins[0] = 64;
+    fail_unless(lfft_sdft_new(&sdft, 64, bins, 1) == 2, "False assumption: lfft_sdft_new(&sdft, 64, {64}, 1) == 2\n");
+    fail_unless(lfft_sdft_new(&sdft, 64, bins, 0) == 2, "False assumption: lfft_sdft_new(&sdft, 64, bins, 0) == 2\n");
+
+    for(samples = 1; samples <= 256; samples <<= 1)
+    {
+        total = 100*samples+3;
+        data = (int32_t *) malloc(total*sizeof(int32_t));
+
+        srand(samples);
+        for(i = 0; i < total; i++)
+        {
+            data[i] = (rand()%201)-100;
+        }
+
+        bins[0] = 0;
+        bins[1] = samples/2;
+        bins[2] = samples-1;
+        fail_unless(lfft_sdft_new(&sdft, samples, NULL, 0) == 0, "False assumption: lfft_sdft_new(&sdft, %u, NULL, 0) == 0\n", samples);
+        fail_unless(lfft_sdft_new(&fresh, samples, NULL, 0) == 0, "False assumption: lfft_sdft_new(&fresh, %u, NULL, 0) == 0\n", samples);
+        fail_unless(lfft_sdft_new(&subset, samples, bins, 3) == 0, "False assumption: lfft_sdft_new(&subset, %u, bins, 3) == 0\n", samples);
+        fail_unless(sdft.bin_count == samples, "False assumption: lfft_sdft_new() with bins == NULL calculates all bins\n");
+
+        // one sample after another and all samples at once give the same result
+        for(i = 0; i < total; i++)
+        {
+            lfft_sdft_write(&sdft, &data[i], 1);
+        }
+        lfft_sdft_write(&subset, data, total);
+
+        // the sums don't drift: a long stream gives the same result as the
+        // last samples input samples at the same position of the ring buffer
+        lfft_sdft_write(&fresh, &data[total-samples-(total%samples)], samples+(total%samples));
+
+        for(k = 0; k < samples; k++)
+        {
+            fail_unless((sdft.result_real[k] == fresh.result_real[k]) && (sdft.result_imag[k] == fresh.result_imag[k]),
+                    "False assumption: sdft bin %u with %u samples doesn't drift\n", k, samples);
+
+            dft_real = 0.0;
+            dft_imag = 0.0;
+            for(i = 0; i < samples; i++)
+            {
+                angle = -2.0*M_PI*((k*i)%samples)/samples;
+                dft_real += data[total-samples+i]*cos(angle)*(1<<LFFT_RHS_BITS);
+                dft_imag += data[total-samples+i]*sin(angle)*(1<<LFFT_RHS_BITS);
+            }
+
+            // rounding of the wk values
+            error = fabs(sdft.result_real[k]-dft_real);
+            error = (fabs(sdft.result_imag[k]-dft_imag) > error) ? fabs(sdft.result_imag[k]-dft_imag) : error;
+            fail_unless(error < 100.0*samples+1.0,
+                    "False assumption: sdft bin %u with %u samples has an error of %f\n", k, samples, error);
+        }
+
+        for(k = 0; k < 3; k++)
+        {
+            fail_unless((subset.result_real[k] == sdft.result_real[bins[k]]) && (subset.result_imag[k] == sdft.result_imag[bins[k]]),
+                    "False assumption: sdft with selected bins == sdft with all bins\n");
+        }
+
+        lfft_sdft_delete(&sdft);
+        lfft_sdft_delete(&fresh);
+        lfft_sdft_delete(&subset);
+        free(data);
+    }
+}
+END_TEST
+
+START_TEST(test_pruned)
+{
+    lfft_Pruned pruned;
+    lfft_Pruned goertzel;
+    lfft_Fft fft;
+    uint32_t bins[6];
+    uint32_t samples;
+    uint32_t i;
+    uint32_t k;
+    int32_t * data_real;
+    int32_t * data_imag;
+    double angle;
+    double dft_real;
+    double dft_imag;
+    double error;
+
+    bins[0] = 64;
+    fail_unless(lfft_pruned_new(&pruned, 48, bins, 1) == 1, "False assumption: lfft_pruned_new(&pruned, 48, bins, 1) == 1\n");
+    fail_unless(lfft_pruned_new(&pruned, 64, bins, 1) == 2, "False assumption: lfft_pruned_new(&pruned, 64, {64}, 1) == 2\n");
+    fail_unless(lfft_pruned_new(&pruned, 64, bins, 0) == 2, "False assumption: lfft_pruned_new(&pruned, 64, bins, 0) == 2\n");
+
+    // many bins use the pruned fft
+    for(i = 0; i < 6; i++)
+    {
+        bins[i] = 5*i+1;
+    }
+    fail_unless(lfft_pruned_new(&pruned, 64, bins, 6) == 0, "False assumption: lfft_pruned_new(&pruned, 64, bins, 6) == 0\n");
+    fail_unless(pruned.pruning == LFFT_PRUNING_FFT, "False assumption: 6 of 64 bins use LFFT_PRUNING_FFT\n");
+    lfft_pruned_delete(&pruned);
+    fail_unless(lfft_pruned_new_pruning(&pruned, 64, bins, 6, (lfft_Pruning) 3) == 2, "False assumption: lfft_pruned_new_pruning() with unknown pruning == 2\n");
+
+    for(samples = 1; samples <= 1024; samples <<= 1)
+    {
+        data_real = (int32_t *) malloc(samples*sizeof(int32_t));
+        data_imag = (int32_t *) malloc(samples*sizeof(int32_t));
+
+        srand(samples);
+        for(i = 0; i < samples; i++)
+        {
+            data_real[i] = (rand()%201)-100;
+            data_imag[i] = (rand()%201)-100;
+        }
+
+        // bins with duplicates and neighbours
+        bins[0] = 0;
+        bins[1] = samples/2;
+        bins[2] = samples-1;
+        bins[3] = (7*samples)/16;
+        bins[4] = ((7*samples)/16+1)&(samples-1);
+        bins[5] = samples/2;
+
+        fail_unless(lfft_fft_new_kernel(&fft, samples, LFFT_KERNEL_RADIX_2) == 0, "False assumption: lfft_fft_new_kernel(&fft, %u, LFFT_KERNEL_RADIX_2) == 0\n", samples);
+        fail_unless(lfft_pruned_new_pruning(&pruned, samples, bins, 6, LFFT_PRUNING_FFT) == 0, "False assumption: lfft_pruned_new_pruning(&pruned, %u, bins, 6, LFFT_PRUNING_FFT) == 0\n", samples);
+        fail_unless(lfft_pruned_new_pruning(&goertzel, samples, bins, 6, LFFT_PRUNING_GOERTZEL) == 0, "False assumption: lfft_pruned_new_pruning(&goertzel, %u, bins, 6, LFFT_PRUNING_GOERTZEL) == 0\n", samples);
+
+        // the pruned fft calculates the same butterflies as the radix-2 kernel
+        lfft_fft_complex(&fft, data_real, data_imag);
+        lfft_pruned_fft_complex(&pruned, data_real, data_imag);
+        lfft_pruned_fft_complex(&goertzel, data_real, data_imag);
+        for(k = 0; k < 6; k++)
+        {
+            fail_unless((pruned.result_real[k] == fft.result_real[bins[k]]) && (pruned.result_imag[k] == fft.result_imag[bins[k]]),
+                    "False assumption: pruned fft bin %u with %u samples == lfft_fft_complex()\n", bins[k], samples);
+
+            dft_real = 0.0;
+            dft_imag = 0.0;
+            for(i = 0; i < samples; i++)
+            {
+                angle = -2.0*M_PI*(((uint64_t) bins[k]*i)%samples)/samples;
+                dft_real += (data_real[i]*cos(angle)-data_imag[i]*sin(angle))*(1<<LFFT_RHS_BITS);
+                dft_imag += (data_real[i]*sin(angle)+data_imag[i]*cos(angle))*(1<<LFFT_RHS_BITS);
+            }
+
+            // the goertzel coefficients have LFFT_GOERTZEL_BITS decimal places
+            error = fabs(goertzel.result_real[k]-dft_real);
+            error = (fabs(goertzel.result_imag[k]-dft_imag) > error) ? fabs(goertzel.result_imag[k]-dft_imag) : error;
+            fail_unless(error < 1.0+samples/16.0,
+                    "False assumption: goertzel bin %u with %u samples has an error of %f\n", bins[k], samples, error);
+        }
+
+        // real input data uses the real fft of half the size like lfft_fft()
+        lfft_fft(&fft, data_real);
+        lfft_pruned_fft(&pruned, data_real);
+        lfft_pruned_fft(&goertzel, data_real);
+        for(k = 0; k < 6; k++)
+        {
+            fail_unless((pruned.result_real[k] == fft.result_real[bins[k]]) && (pruned.result_imag[k] == fft.result_imag[bins[k]]),
+                    "False assumption: pruned fft bin %u with %u samples == lfft_fft()\n", bins[k], samples);
+            error = fabs(goertzel.result_real[k]-(double) fft.result_real[bins[k]]);
+            error = (fabs(goertzel.result_imag[k]-(double) fft.result_imag[bins[k]]) > error) ? fabs(goertzel.result_imag[k]-(double) fft.result_imag[bins[k]]) : error;
+            fail_unless(error < 100.0*samples+1.0,
+                    "False assumption: goertzel bin %u with %u samples and real input data has an error of %f\n", bins[k], samples, error);
+        }
+
+        lfft_fft_delete(&fft);
+        lfft_pruned_delete(&pruned);
+        lfft_pruned_delete(&goertzel);
+        free(data_real);
+        free(data_imag);
+    }
+}
+END_TEST
+
+START_TEST(test_conv)
+{
+    const uint32_t taps_list[3] = {1, 7, 33};
+    const uint32_t block_list[4] = {0, 16, 5, 1};
+    lfft_Conv conv;
+    int32_t filter[33];
+    int32_t * input;
+    int32_t * output;
+    uint32_t length;
+    uint32_t taps;
+    uint32_t block;
+    uint32_t n;
+    uint32_t i;
+    uint32_t k;
+    uint8_t t;
+    uint8_t b;
+    uint8_t overlap;
+    uint8_t correlation;
+    double expected;
+    double error;
+    double max_error;
+    double bound;
+
+    srand(21);
+    for(i = 0; i < 33; i++)
+    {
+        filter[i] = (rand()%21)-10;
+    }
+
+    fail_unless(lfft_conv_new(&conv, filter, 0, 16, LFFT_OVERLAP_ADD) == 2, "False assumption: lfft_conv_new() with 0 taps == 2\n");
+    fail_unless(lfft_conv_new(&conv, filter, 7, 16, (lfft_Overlap) 2) == 2, "False assumption: lfft_conv_new() with unknown overlap == 2\n");
+    fail_unless(lfft_conv_new(&conv, filter, 7, 0xFFFFFFFF, LFFT_OVERLAP_ADD) == 1, "False assumption: lfft_conv_new() with a too big block == 1\n");
+
+    // the decimation in frequency butterflies give the bit reversed spectrum
+    for(n = 1; n <= 1024; n <<= 1)
+    {
+        input  = (int32_t *) malloc(n*sizeof(int32_t));
+        output = (int32_t *) malloc(n*sizeof(int32_t));
+        for(i = 0; i < n; i++)
+        {
+            input[i]  = (rand()%201)-100;
+            output[i] = (rand()%201)-100;
+        }
+
+        fail_unless(lfft_fft_new(&conv.fft, n) == 0, "False assumption: lfft_fft_new(&fft, %u) == 0\n", n);
+        lfft_fft_complex(&conv.fft, input, output);
+        for(i = 0; i < n; i++)
+        {
+            input[i]  <<= LFFT_RHS_BITS;
+            output[i] <<= LFFT_RHS_BITS;
+        }
+        _lfft_fft_dif(&conv.fft, input, output, false);
+        max_error = 0.0;
+        for(i = 0; i < n; i++)
+        {
+            k = conv.fft.switching_table[i];
+            error = fabs((double) input[i]-conv.fft.result_real[k]);
+            error = (fabs((double) output[i]-conv.fft.result_imag[k]) > error) ? fabs((double) output[i]-conv.fft.result_imag[k]) : error;
+            max_error = (error > max_error) ? error : max_error;
+        }
+        fail_unless(max_error < 64.0*n, "False assumption: _lfft_fft_dif() with %u samples has an error of %f\n", n, max_error);
+        lfft_fft_delete(&conv.fft);
+        free(input);
+        free(output);
+    }
+
+    // the selected block size has the least operations per output sample
+    fail_unless(lfft_conv_new(&conv, filter, 33, 0, LFFT_OVERLAP_SAVE) == 0, "False assumption: lfft_conv_new(&conv, filter, 33, 0, LFFT_OVERLAP_SAVE) == 0\n");
+    fail_unless((conv.samples == 256) && (conv.block == 448), "False assumption: 33 taps select 256 samples and blocks of 448, not %u and %u\n", conv.samples, conv.block);
+    lfft_conv_delete(&conv);
+
+    for(t = 0; t < 3; t++)
+    {
+        for(b = 0; b < 4; b++)
+        {
+            for(overlap = LFFT_OVERLAP_ADD; overlap <= LFFT_OVERLAP_SAVE; overlap++)
+            {
+                for(correlation = 0; correlation < 2; correlation++)
+                {
+                    taps = taps_list[t];
+                    if(correlation)
+                    {
+                        fail_unless(lfft_conv_new_correlation(&conv, filter, taps, block_list[b], (lfft_Overlap) overlap) == 0,
+                                "False assumption: lfft_conv_new_correlation() with %u taps == 0\n", taps);
+                    }
+                    else
+                    {
+                        fail_unless(lfft_conv_new(&conv, filter, taps, block_list[b], (lfft_Overlap) overlap) == 0,
+                                "False assumption: lfft_conv_new() with %u taps == 0\n", taps);
+                    }
+                    block = conv.block;
+                    fail_unless((block_list[b] == 0) || (block == block_list[b]), "False assumption: conv.block == %u\n", block_list[b]);
+                    fail_unless(conv.samples >= (block+1)/2+taps-1, "False assumption: conv.samples >= (block+1)/2+taps-1\n");
+
+                    // several blocks of a stream which is longer than the filter
+                    length = block*(4+(2*taps)/block);
+                    input  = (int32_t *) malloc(length*sizeof(int32_t));
+                    output = (int32_t *) malloc(length*sizeof(int32_t));
+                    for(i = 0; i < length; i++)
+                    {
+                        input[i] = (rand()%201)-100;
+                    }
+
+                    for(i = 0; i < length; i += block)
+                    {
+                        lfft_conv_process(&conv, &input[i], &output[i]);
+                    }
+
+                    // direct convolution, the correlation is delayed by taps-1 samples
+                    // the error of the 8 bit wk values is relative to the largest possible output sample
+                    bound = 0.0;
+                    for(k = 0; k < taps; k++)
+                    {
+                        bound += 100.0*abs(filter[k])*(1<<LFFT_RHS_BITS);
+                    }
+
+                    max_error = 0.0;
+                    for(n = 0; n < length; n++)
+                    {
+                        expected = 0.0;
+                        for(k = 0; (k < taps) && (k <= n); k++)
+                        {
+                            expected += (double) (correlation ? filter[taps-1-k] : filter[k])*input[n-k];
+                        }
+                        error = fabs(output[n]-expected*(1<<LFFT_RHS_BITS));
+                        max_error = (error > max_error) ? error : max_error;
+                    }
+                    fail_unless(max_error < bound/64.0+1.0,
+                            "False assumption: convolution with %u taps, blocks of %u and overlap %u has an error of %f\n",
+                            taps, block, overlap, max_error);
+
+                    // a new stream starts with zeros
+                    lfft_conv_reset(&conv);
+                    lfft_conv_process(&conv, input, output);
+                    expected = (double) (correlation ? filter[taps-1] : filter[0])*input[0];
+                    fail_unless(fabs(output[0]-expected*(1<<LFFT_RHS_BITS)) < bound/64.0+1.0,
+                            "False assumption: lfft_conv_reset() clears the previous samples\n");
+
+                    lfft_conv_delete(&conv);
+                    free(input);
+                    free(output);
+                }
+            }
+        }
+    }
+}
+END_TEST
+
+START_TEST(test_partitioned)
+{
+    const uint32_t block_list[3] = {1, 4, 16};
+    const uint32_t taps_list[3] = {1, 50, 200};
+    lfft_Partitioned partitioned;
+    int32_t filter[200];
+    int32_t * input;
+    int32_t * output;
+    uint32_t * loaded;
+    uint32_t length;
+    uint32_t taps;
+    uint32_t block;
+    uint32_t first;
+    uint32_t n;
+    uint32_t i;
+    uint32_t k;
+    uint8_t b;
+    uint8_t t;
+    double expected;
+    double error;
+    double max_error;
+    double bound;
+
+    fail_unless(lfft_partitioned_new(&partitioned, 12, 100) == 1, "False assumption: lfft_partitioned_new(&partitioned, 12, 100) == 1\n");
+    fail_unless(lfft_partitioned_new(&partitioned, 16, 0) == 2, "False assumption: lfft_partitioned_new(&partitioned, 16, 0) == 2\n");
+
+    srand(22);
+    for(i = 0; i < 200; i++)
+    {
+        filter[i] = (rand()%21)-10;
+    }
+
+    for(b = 0; b < 3; b++)
+    {
+        for(t = 0; t < 3; t++)
+        {
+            block = block_list[b];
+            taps  = taps_list[t];
+            fail_unless(lfft_partitioned_new(&partitioned, block, taps) == 0,
+                    "False assumption: lfft_partitioned_new(&partitioned, %u, %u) == 0\n", block, taps);
+            fail_unless(partitioned.partitions*block >= taps, "False assumption: partitions*block >= max_taps\n");
+
+            length = block*(8+(3*taps)/block);
+            input  = (int32_t *) malloc(length*sizeof(int32_t));
+            output = (int32_t *) malloc(length*sizeof(int32_t));
+            loaded = (uint32_t *) malloc(length*sizeof(uint32_t));
+            for(i = 0; i < length; i++)
+            {
+                input[i] = (rand()%201)-100;
+            }
+
+            // the filter is loaded in two parts while the stream is filtered,
+            // the first part doesn't end at the end of a partition
+            first = (taps+1)/3;
+            fail_unless(lfft_partitioned_add(&partitioned, filter, first) == 0, "False assumption: lfft_partitioned_add() of %u taps == 0\n", first);
+            for(i = 0; i < length; i += block)
+            {
+                if(i == block*(2+taps/(2*block)))
+                {
+                    fail_unless(lfft_partitioned_add(&partitioned, filter, partitioned.partitions*block-first+1) == 2, "False assumption: lfft_partitioned_add() of too many taps == 2\n");
+                    fail_unless(lfft_partitioned_add(&partitioned, &filter[first], taps-first) == 0, "False assumption: lfft_partitioned_add() of %u taps == 0\n", taps-first);
+                }
+                for(k = 0; k < block; k++)
+                {
+                    loaded[i+k] = partitioned.taps;
+                }
+                lfft_partitioned_process(&partitioned, &input[i], &output[i]);
+            }
+            fail_unless(partitioned.count == partitioned.partitions, "False assumption: all partitions are loaded\n");
+
+            // the error of the 8 bit wk values is relative to the largest possible output sample
+            bound = 0.0;
+            for(k = 0; k < taps; k++)
+            {
+                bound += 100.0*abs(filter[k])*(1<<LFFT_RHS_BITS);
+            }
+
+            // direct convolution with the taps which were loaded for the block
+            max_error = 0.0;
+            for(n = 0; n < length; n++)
+            {
+                expected = 0.0;
+                for(k = 0; (k < loaded[n]) && (k <= n); k++)
+                {
+                    expected += (double) filter[k]*input[n-k];
+                }
+                error = fabs(output[n]-expected*(1<<LFFT_RHS_BITS));
+                max_error = (error > max_error) ? error : max_error;
+            }
+            fail_unless(max_error < bound/64.0+1.0,
+                    "False assumption: partitioned convolution with %u taps and blocks of %u has an error of %f\n",
+                    taps, block, max_error);
+
+            // a new stream starts with zeros
+            lfft_partitioned_reset(&partitioned);
+            lfft_partitioned_process(&partitioned, input, output);
+            fail_unless(fabs(output[0]-(double) filter[0]*input[0]*(1<<LFFT_RHS_BITS)) < bound/64.0+1.0,
+                    "False assumption: lfft_partitioned_reset() clears the previous samples\n");
+
+            lfft_partitioned_delete(&partitioned);
+            free(input);
+            free(output);
+            free(loaded);
+        }
+    }
+}
+END_TEST
+
+START_TEST(test_spectrum)
+{
+    const uint32_t n = 37;
+    int32_t real[37];
+    int32_t imag[37];
+    uint64_t power[37];
+    uint32_t magnitude[37];
+    uint32_t approximate[37];
+    int32_t log2_power[37];
+    int32_t db[37];
+    uint64_t x;
+    uint64_t root;
+    uint32_t i;
+    double exact;
+    lfft_Fft fft;
+
+    // floor(sqrt(x)) at the squares, their neighbours and random numbers
+    fail_unless(lfft_isqrt64(0) == 0, "False assumption: lfft_isqrt64(0) == 0\n");
+    fail_unless(lfft_isqrt64(UINT64_MAX) == 0xFFFFFFFF, "False assumption: lfft_isqrt64(UINT64_MAX) == 0xFFFFFFFF\n");
+    srand(23);
+    for(i = 0; i < 100000; i++)
+    {
+        root = (i < 50000) ? i : (((uint64_t) rand()<<16)^rand())&0xFFFFFFFF;
+        x = root*root;
+        fail_unless((lfft_isqrt64(x) == root) && ((root == 0) || (lfft_isqrt64(x-1) == root-1)) && (lfft_isqrt64(x+2*root) == root),
+                "False assumption: lfft_isqrt64() of the square of %"PRIu64" and its neighbours\n", root);
+        x = ((uint64_t) rand()<<42)^((uint64_t) rand()<<21)^rand();
+        root = lfft_isqrt64(x);
+        fail_unless((root*root <= x) && ((root+1)*(root+1) > x), "False assumption: lfft_isqrt64(%"PRIu64")=%"PRIu64"\n", x, root);
+    }
+
+    // the squares of big bins don't overflow, the result is limited
+    lfft_fft_new(&fft, 4);
+    fft.result_real[0] = 100000<<LFFT_RHS_BITS;
+    fft.result_imag[0] = 0;
+    fft.result_real[1] = 30000<<LFFT_RHS_BITS;
+    fft.result_imag[1] = -40000<<LFFT_RHS_BITS;
+    fail_unless(lfft_fft_abs_at(&fft, 0) == 0xFFFF, "False assumption: lfft_fft_abs_at() of 100000 == 0xFFFF\n");
+    fail_unless(lfft_fft_abs_at(&fft, 1) == 50000, "False assumption: lfft_fft_abs_at() of 30000-40000j == 50000\n");
+    fail_unless(lfft_fft_abs_and_norm_at(&fft, 1) == 12500,
+            "False assumption: lfft_fft_abs_and_norm_at() of 30000-40000j == 12500\n");
+    // the norm of 2^24 and more samples shifts by 32 and more bits
+    fft.steps = 24;
+    fail_unless(lfft_fft_abs_and_norm_at(&fft, 0) == 0, "False assumption: lfft_fft_abs_and_norm_at() of 2^24 samples == 0\n");
+    fft.steps = 2;
+    lfft_fft_delete(&fft);
+
+    // extreme values, zero and random values of different sizes
+    for(i = 0; i < n; i++)
+    {
+        real[i] = (rand()%201-100)<<(rand()%24);
+        imag[i] = (rand()%201-100)<<(rand()%24);
+    }
+    real[0] = INT32_MIN;
+    imag[0] = INT32_MIN;
+    real[1] = INT32_MAX;
+    imag[1] = INT32_MIN;
+    real[2] = 0;
+    imag[2] = 0;
+    real[3] = 1;
+    imag[3] = 0;
+    real[4] = 3<<LFFT_RHS_BITS;
+    imag[4] = -4<<LFFT_RHS_BITS;
+
+    lfft_spectrum_power(real, imag, power, n);
+    lfft_spectrum_magnitude(real, imag, magnitude, n, LFFT_MAGNITUDE_EXACT);
+    lfft_spectrum_magnitude(real, imag, approximate, n, LFFT_MAGNITUDE_APPROXIMATE);
+    lfft_spectrum_log2(real, imag, log2_power, n);
+    lfft_spectrum_db(real, imag, db, n);
+
+    fail_unless(magnitude[4] == 5<<LFFT_RHS_BITS, "False assumption: magnitude of 3-4j == 5\n");
+    fail_unless((log2_power[2] == LFFT_LOG_ZERO) && (db[2] == LFFT_LOG_ZERO), "False assumption: log2 and db of zero == LFFT_LOG_ZERO\n");
+    for(i = 0; i < n; i++)
+    {
+        fail_unless(power[i] == (uint64_t) ((int64_t) real[i]*real[i])+(uint64_t) ((int64_t) imag[i]*imag[i]),
+                "False assumption: power[%u] is the exact power\n", i);
+        fail_unless(magnitude[i] == lfft_isqrt64(power[i]),
+                "False assumption: magnitude[%u]=%u == lfft_isqrt64(power[%u])\n", i, magnitude[i], i);
+
+        exact = sqrt((double) real[i]*real[i]+(double) imag[i]*imag[i]);
+        fail_unless((approximate[i] >= 0.969*exact-1.0) && (approximate[i] <= 1.008*exact+1.0),
+                "False assumption: approximate magnitude[%u]=%u | magnitude=%f\n", i, approximate[i], exact);
+
+        if(power[i] != 0)
+        {
+            exact = log2((double) real[i]*real[i]+(double) imag[i]*imag[i])-2*LFFT_RHS_BITS;
+            fail_unless(fabs(log2_power[i]-exact*(1<<LFFT_RHS_BITS)) <= 1.0,
+                    "False assumption: log2_power[%u]=%d | log2=%f\n", i, log2_power[i], exact);
+            fail_unless(fabs(db[i]-10.0*log10(2.0)*exact*(1<<LFFT_RHS_BITS)) <= 1.0,
+                    "False assumption: db[%u]=%d | db=%f\n", i, db[i], 10.0*log10(2.0)*exact);
+        }
+    }
+}
+END_TEST
+
+#ifdef LFFT_USE_THREADS
+static void test_pool_task(void * argument, void * workspace)
+{
+    *((uint32_t *) argument) += 1;
+}
+
+START_TEST(test_pool)
+{
+    const uint16_t samples = 64;
+    const uint32_t count = 100;
+    const uint32_t tasks = 1000;
+    lfft_Pool pool;
+    lfft_Fft fft;
+    lfft_Fft2 fft2[6];
+    lfft_Large large;
+    int32_t ** real2[6];
+    int32_t * real = (int32_t *) malloc(count*samples*sizeof(int32_t));
+    int32_t * imag = (int32_t *) malloc(count*samples*sizeof(int32_t));
+    int32_t * pool_real = (int32_t *) malloc(count*samples*sizeof(int32_t));
+    int32_t * pool_imag = (int32_t *) malloc(count*samples*sizeof(int32_t));
+    int32_t * batch_real = (int32_t *) malloc(count*samples*sizeof(int32_t));
+    int32_t * batch_imag = (int32_t *) malloc(count*samples*sizeof(int32_t));
+    uint32_t * counters = (uint32_t *) calloc(tasks, sizeof(uint32_t));
+    uint32_t i;
+    uint16_t j;
+    uint16_t k;
+
+    lfft_fft_new(&fft, samples);
+    for(i = 0; i < count*samples; i++)
+    {
+        real[i] = (int32_t) ((i*37)%61) - 30;
+        imag[i] = (int32_t) ((i*53)%29) - 14;
+    }
+
+    fail_unless(lfft_pool_new(&pool, 4, LFFT_BATCH_WORKSPACE(samples/2)*sizeof(int32_t)) == 0,
+            "False assumption: lfft_pool_new() == 0\n");
+    fail_unless(pool.threads == 4, "False assumption: pool.threads=%"PRIu16" == 4\n", pool.threads);
+    fail_unless(lfft_pool_set_affinity(&pool, 4, 0) == 1, "False assumption: worker 4 doesn't exist\n");
+    fail_unless(lfft_pool_set_affinity(&pool, 0, 0) != 1, "False assumption: worker 0 can be bound to cpu 0\n");
+
+    // every task is calculated exactly once
+    for(i = 0; i < tasks; i++)
+    {
+        lfft_pool_submit(&pool, test_pool_task, &counters[i]);
+    }
+    lfft_pool_wait(&pool);
+    for(i = 0; i < tasks; i++)
+    {
+        fail_unless(counters[i] == 1, "False assumption: counters[%"PRIu32"]=%"PRIu32" == 1\n", i, counters[i]);
+    }
+
+    // the workspace of the workers is too small for 64 samples
+    fail_unless(lfft_pool_fft_batch(&pool, &fft, count, real, imag, samples,
+            pool_real, pool_imag, samples, false) == 2,
+            "False assumption: lfft_pool_fft_batch() == 2\n");
+    lfft_pool_delete(&pool);
+
+    lfft_pool_new(&pool, 3, LFFT_BATCH_WORKSPACE(samples)*sizeof(int32_t));
+    fail_unless(lfft_pool_fft_batch(&pool, &fft, count, real, imag, samples,
+            pool_real, pool_imag, samples, true) == 0,
+            "False assumption: lfft_pool_fft_batch() == 0\n");
+    lfft_ifft_batch_complex(&fft, count, real, imag, samples, batch_real, batch_imag, samples);
+    for(i = 0; i < count*samples; i++)
+    {
+        fail_unless((pool_real[i] == batch_real[i]) && (pool_imag[i] == batch_imag[i]),
+                "False assumption: result of the pool at %"PRIu32" equals lfft_ifft_batch_complex()\n", i);
+    }
+
+    // the bluestein algorithm uses the workspace of the workers
+    lfft_fft_delete(&fft);
+    lfft_fft_new(&fft, 61);
+    fail_unless(lfft_pool_fft_batch(&pool, &fft, count, real, imag, 61,
+            pool_real, pool_imag, 61, false) == 0,
+            "False assumption: lfft_pool_fft_batch() with 61 samples == 0\n");
+    lfft_fft_batch_complex(&fft, count, real, imag, 61, batch_real, batch_imag, 61);
+    for(i = 0; i < count*61; i++)
+    {
+        fail_unless((pool_real[i] == batch_real[i]) && (pool_imag[i] == batch_imag[i]),
+                "False assumption: result of the pool at %"PRIu32" equals lfft_fft_batch_complex()\n", i);
+    }
+
+    // six-step fft with the workers of the pool
+    lfft_large_new(&large, 4096);
+    lfft_pool_delete(&pool);
+    lfft_pool_new(&pool, 3, LFFT_LARGE_WORKSPACE(&large)*sizeof(int32_t));
+    for(i = 0; i < 4096; i++)
+    {
+        batch_real[i] = (int32_t) ((i*37)%5) - 2;
+        batch_imag[i] = (int32_t) ((i*53)%3) - 1;
+    }
+    fail_unless(lfft_pool_large_fft(&pool, &large, batch_real, batch_imag, false) == 0,
+            "False assumption: lfft_pool_large_fft() == 0\n");
+    memcpy(pool_real, large.result_real, 4096*sizeof(int32_t));
+    memcpy(pool_imag, large.result_imag, 4096*sizeof(int32_t));
+    lfft_large_fft_complex(&large, batch_real, batch_imag);
+    for(i = 0; i < 4096; i++)
+    {
+        fail_unless((pool_real[i] == large.result_real[i]) && (pool_imag[i] == large.result_imag[i]),
+                "False assumption: result of the pool at %"PRIu32" equals lfft_large_fft_complex()\n", i);
+    }
+    lfft_large_delete(&large);
+
+    // independent 2D-ffts of impulses
+    for(i = 0; i < 6; i++)
+    {
+        lfft_fft2_new(&fft2[i], 4, 8);
+        real2[i] = (int32_t **) malloc(4*sizeof(int32_t *));
+        for(j = 0; j < 4; j++)
+        {
+            real2[i][j] = (int32_t *) calloc(8, sizeof(int32_t));
+        }
+        real2[i][0][0] = (int32_t) i;
+    }
+    fail_unless(lfft_pool_fft2(&pool, fft2, real2, NULL, 6, false) == 0, "False assumption: lfft_pool_fft2() == 0\n");
+    for(i = 0; i < 6; i++)
+    {
+        for(j = 0; j < 4; j++)
+        {
+            for(k = 0; k < 8; k++)
+            {
+                fail_unless(lfft_fft2_result_real_at(&fft2[i], j, k) == (int32_t) i,
+                        "False assumption: 2D-fft %"PRIu32" at [%"PRIu16"][%"PRIu16"] == %"PRIu32"\n", i, j, k, i);
+            }
+            free(real2[i][j]);
+        }
+        free(real2[i]);
+        lfft_fft2_delete(&fft2[i]);
+    }
+
+    lfft_pool_delete(&pool);
+    lfft_fft_delete(&fft);
+    free(real);
+    free(imag);
+    free(pool_real);
+    free(pool_imag);
+    free(batch_real);
+    free(batch_imag);
+    free(counters);
+}
+END_TEST
+
+static void * test_plan_thread(void * argument)
+{
+    // sizes with shared power of 2, mixed radix and bluestein plans; the
+    // bluestein plans share their inner plans with the power of 2 sizes
+    const uint32_t sizes[4] = {64, 60, 61, 128};
+    lfft_Fft fft;
+    uint32_t i;
+
+    for(i = 0; i < 200; i++)
+    {
+        if(lfft_fft_new(&fft, sizes[(i+*((uint32_t *) argument))%4]) != 0)
+        {
+            return argument;
+        }
+        lfft_fft_delete(&fft);
+    }
+
+    return NULL;
+}
+
+START_TEST(test_plan_threads)
+{
+    pthread_t threads[8];
+    uint32_t arguments[8];
+    void * result;
+    uint32_t i;
+
+    // the registry of the plans is shared by all threads
+    for(i = 0; i < 8; i++)
+    {
+        arguments[i] = i;
+        pthread_create(&threads[i], NULL, test_plan_thread, &arguments[i]);
+    }
+    for(i = 0; i < 8; i++)
+    {
+        pthread_join(threads[i], &result);
+        fail_unless(result == NULL, "False assumption: lfft_fft_new() in thread %"PRIu32" == 0\n", i);
+    }
+
+    fail_unless(_lfft_plans == NULL, "False assumption: all plans are released\n");
+}
+END_TEST
+#endif /* LFFT_USE_THREADS */
+
 Suite* a_suite()
 {
     Suite * suite = suite_create ("lfft");
@@ -267,6 +2618,36 @@ Suite* a_suite()
     tcase_add_test(tcase, test_f_lfft_isqrt);
     tcase_add_test(tcase, test_switching_table);
     tcase_add_test(tcase, test_fft_ifft);
+    tcase_add_test(tcase, test_rfft);
+    tcase_add_test(tcase, test_kernel_radix4);
+    tcase_add_test(tcase, test_kernel_stockham);
+    tcase_add_test(tcase, test_radix2_avx2);
+    tcase_add_test(tcase, test_fft_input);
+    tcase_add_test(tcase, test_buffer_api);
+    tcase_add_test(tcase, test_plan_sharing);
+    tcase_add_test(tcase, test_step_wk);
+#ifdef LFFT_USE_GENERATED
+    tcase_add_test(tcase, test_generated);
+#endif /* LFFT_USE_GENERATED */
+    tcase_add_test(tcase, test_fft2_tiles);
+    tcase_add_test(tcase, test_rfft2);
+    tcase_add_test(tcase, test_shared_plan_buffers);
+    tcase_add_test(tcase, test_batch);
+    tcase_add_test(tcase, test_large);
+    tcase_add_test(tcase, test_mixed_radix);
+    tcase_add_test(tcase, test_bluestein);
+    tcase_add_test(tcase, test_q15);
+    tcase_add_test(tcase, test_float);
+    tcase_add_test(tcase, test_stft);
+    tcase_add_test(tcase, test_sdft);
+    tcase_add_test(tcase, test_pruned);
+    tcase_add_test(tcase, test_conv);
+    tcase_add_test(tcase, test_partitioned);
+    tcase_add_test(tcase, test_spectrum);
+#ifdef LFFT_USE_THREADS
+    tcase_add_test(tcase, test_pool);
+    tcase_add_test(tcase, test_plan_threads);
+#endif /* LFFT_USE_THREADS */
     suite_add_tcase(suite, tcase);
 
     return suite;
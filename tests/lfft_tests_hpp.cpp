@@ -0,0 +1,250 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+
+#include <check.h>
+
+#include "lfft.hpp"
+
+// N values of the same random signal for every type
+template<typename Sample>
+void test_hpp_signal(Sample real[], Sample imag[], uint32_t n, double amplitude)
+{
+    uint32_t i;
+
+    srand(n);
+    for(i = 0; i < n; i++)
+    {
+        real[i] = static_cast<Sample>(amplitude*((rand()%2001)-1000)/1000);
+        imag[i] = static_cast<Sample>(amplitude*((rand()%2001)-1000)/1000);
+    }
+}
+
+// largest difference between the result and the dft of the input
+template<typename Sample>
+double test_hpp_dft_error(const Sample input_real[], const Sample input_imag[],
+        const Sample real[], const Sample imag[], uint32_t n)
+{
+    uint32_t i;
+    uint32_t k;
+    double angle;
+    double dft_real;
+    double dft_imag;
+    double max_error = 0.0;
+
+    for(k = 0; k < n; k++)
+    {
+        dft_real = 0.0;
+        dft_imag = 0.0;
+        for(i = 0; i < n; i++)
+        {
+            angle = -2.0*M_PI*((static_cast<uint64_t>(i)*k)%n)/n;
+            dft_real += input_real[i]*cos(angle)-input_imag[i]*sin(angle);
+            dft_imag += input_real[i]*sin(angle)+input_imag[i]*cos(angle);
+        }
+        max_error = std::fmax(max_error, std::fabs(real[k]-dft_real));
+        max_error = std::fmax(max_error, std::fabs(imag[k]-dft_imag));
+    }
+
+    return max_error;
+}
+
+// lfft::Plan<N> has the same result as the C library
+template<uint32_t N>
+void test_hpp_plan_loop()
+{
+    uint32_t i;
+    uint32_t differences;
+    int32_t real[N];
+    int32_t imag[N];
+    int32_t real_c[N];
+    int32_t imag_c[N];
+    lfft::Plan<N> plan;
+    lfft::Fft fft(N);
+
+    // the products of the C library are int32_t values
+    test_hpp_signal(real, imag, N, 4*(1<<LFFT_RHS_BITS));
+    for(i = 0; i < N; i++)
+    {
+        real_c[i] = real[i];
+        imag_c[i] = imag[i];
+    }
+
+    plan.fft(real, imag);
+    fft.fft(real_c, imag_c);
+    differences = 0;
+    for(i = 0; i < N; i++)
+    {
+        differences += (real[i] != real_c[i]) || (imag[i] != imag_c[i]);
+    }
+    fail_unless(differences == 0, "False assumption: lfft::Plan<%u>::fft() == lfft_fft_inplace()\n", N);
+
+    plan.ifft(real, imag);
+    fft.ifft(real_c, imag_c);
+    differences = 0;
+    for(i = 0; i < N; i++)
+    {
+        differences += (real[i] != real_c[i]) || (imag[i] != imag_c[i]);
+    }
+    fail_unless(differences == 0, "False assumption: lfft::Plan<%u>::ifft() == lfft_ifft_inplace()\n", N);
+}
+
+START_TEST(test_hpp_plan)
+{
+    test_hpp_plan_loop<1>();
+    test_hpp_plan_loop<2>();
+    test_hpp_plan_loop<16>();
+    test_hpp_plan_loop<256>();
+    test_hpp_plan_loop<1024>();
+}
+END_TEST
+
+START_TEST(test_hpp_formats)
+{
+    const uint32_t n = 256;
+    uint32_t i;
+    double error;
+    int16_t input_q14_real[n];
+    int16_t input_q14_imag[n];
+    int16_t q14_real[n];
+    int16_t q14_imag[n];
+    int32_t q24_real[n];
+    int32_t q24_imag[n];
+    double input_real[n];
+    double input_imag[n];
+    double double_real[n];
+    double double_imag[n];
+
+    // three formats side by side
+    lfft::Plan<n, 14, int16_t> plan_q14;
+    lfft::Plan<n, 24, int32_t> plan_q24;
+    lfft::Plan<n, 0, double> plan_double;
+
+    fail_unless((plan_q14.plan() == plan_q24.plan()) && (plan_q14.plan() == plan_double.plan()),
+            "False assumption: all formats share the plan of the C library\n");
+    fail_unless(lfft::Plan<n>::steps == 8, "False assumption: lfft::Plan<256>::steps == 8\n");
+
+    // 8 bits of headroom for 8 steps
+    test_hpp_signal(input_q14_real, input_q14_imag, n, 120);
+    for(i = 0; i < n; i++)
+    {
+        q14_real[i] = input_q14_real[i];
+        q14_imag[i] = input_q14_imag[i];
+        q24_real[i] = static_cast<int32_t>(input_q14_real[i]);
+        q24_imag[i] = static_cast<int32_t>(input_q14_imag[i]);
+    }
+
+    // every product is rounded down, the errors of the steps add up
+    plan_q14.fft(q14_real, q14_imag);
+    error = test_hpp_dft_error(input_q14_real, input_q14_imag, q14_real, q14_imag, n);
+    fail_unless(error < 80.0, "False assumption: error of lfft::Plan<256, 14, int16_t> %f < 80\n", error);
+
+    plan_q24.fft(q24_real, q24_imag);
+    for(i = 0; i < n; i++)
+    {
+        input_real[i] = input_q14_real[i];
+        input_imag[i] = input_q14_imag[i];
+        double_real[i] = q24_real[i];
+        double_imag[i] = q24_imag[i];
+    }
+    error = test_hpp_dft_error(input_real, input_imag, double_real, double_imag, n);
+    fail_unless(error < 80.0, "False assumption: error of lfft::Plan<256, 24, int32_t> %f < 80\n", error);
+
+    test_hpp_signal(input_real, input_imag, n, 1.0);
+    for(i = 0; i < n; i++)
+    {
+        double_real[i] = input_real[i];
+        double_imag[i] = input_imag[i];
+    }
+    plan_double.fft(double_real, double_imag);
+    error = test_hpp_dft_error(input_real, input_imag, double_real, double_imag, n);
+    fail_unless(error < 1e-12, "False assumption: error of lfft::Plan<256, 0, double> %e < 1e-12\n", error);
+
+    plan_double.ifft(double_real, double_imag);
+    for(i = 0; i < n; i++)
+    {
+        fail_unless((std::fabs(double_real[i]-input_real[i]) < 1e-14) && (std::fabs(double_imag[i]-input_imag[i]) < 1e-14),
+                "False assumption: ifft(fft(x)) == x with lfft::Plan<256, 0, double>\n");
+    }
+}
+END_TEST
+
+START_TEST(test_hpp_ownership)
+{
+    lfft::Plan<64> plan;
+    const lfft_Plan * shared = plan.plan();
+
+    // moving transfers the plan, only the owner releases it
+    lfft::Plan<64> moved(std::move(plan));
+    fail_unless((moved.plan() == shared) && (plan.plan() == NULL), "False assumption: lfft::Plan is moved\n");
+    plan = std::move(moved);
+    fail_unless((plan.plan() == shared) && (moved.plan() == NULL), "False assumption: lfft::Plan is move assigned\n");
+    fail_unless(shared->references == 1, "False assumption: the moved plan has one user\n");
+
+    lfft::Fft fft(48);
+    lfft::Fft fft_moved(std::move(fft));
+    fail_unless((fft_moved.samples() == 48) && (fft_moved.get()->plan->references == 1),
+            "False assumption: lfft::Fft is moved\n");
+
+    bool thrown = false;
+    try
+    {
+        lfft::Fft invalid(0);
+    }
+    catch(const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    fail_unless(thrown, "False assumption: lfft::Fft(0) throws std::invalid_argument\n");
+}
+END_TEST
+
+Suite * a_suite()
+{
+    Suite * suite = suite_create ("lfft_hpp");
+    TCase * tcase = tcase_create ("case");
+    tcase_add_test(tcase, test_hpp_plan);
+    tcase_add_test(tcase, test_hpp_formats);
+    tcase_add_test(tcase, test_hpp_ownership);
+    suite_add_tcase(suite, tcase);
+
+    return suite;
+}
+
+int main()
+{
+    int number_failed;
+    Suite * suite = a_suite();
+    SRunner * runner = srunner_create(suite);
+    srunner_run_all(runner, CK_NORMAL);
+    number_failed = srunner_ntests_failed(runner);
+    srunner_free(runner);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
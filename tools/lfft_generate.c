@@ -0,0 +1,399 @@
+/* LambdaFFT is covered by the new BSD license
+ *
+ * Copyright (c) 2011-2013, Clemens Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*! \file
+ * This file contains the generator of the tables and codelets which are
+ * created at build time (cmake option ENABLE_GENERATED_TABLES).
+ * It writes two headers into the output directory:
+ *  - lfft_generated_tables.h: const switching tables and wk values of the
+ *    plans of the fixed sizes given on the command line
+ *  - lfft_generated_codelets.h: fully unrolled radix-2 butterflies of the
+ *    ffts with 2 to LFFT_GENERATED_CODELET_MAX samples
+ * The values are calculated with the same expressions as lfft_plan.c, so the
+ * results are bit for bit the same as the results of the computed tables.
+ *
+ * usage: lfft_generate output_directory [samples...]
+ *
+ * \author Clemens Korner
+ * \version 0.1.0
+ */
+
+#include "lfft_config.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*!
+ * largest fft calculated by a codelet
+ */
+#define LFFT_GENERATED_CODELET_MAX 64
+
+/*!
+ * Calculates a wk value like _lfft_plan_power_2().
+ * \param i index of the wk value
+ * \param samples number of samples of the plan
+ * \param real true: real part false: imaginary part
+ * \return wk value with LFFT_RHS_BITS decimal places
+ */
+static int32_t _lfft_generate_wk(uint32_t i, uint32_t samples, bool real);
+
+/*!
+ * Writes the tables of one plan.
+ * \param file output file
+ * \param samples number of samples; must be to the power of 2 and at least 2
+ */
+static void _lfft_generate_tables(FILE * file, uint32_t samples);
+
+/*!
+ * Writes the codelet of a fft or ifft with samples elements.
+ * \param file output file
+ * \param samples number of samples; must be to the power of 2
+ * \param calculate_ifft false to generate the fft, true to generate the ifft
+ */
+static void _lfft_generate_codelet(FILE * file, uint32_t samples, bool calculate_ifft);
+
+/*!
+ * Appends operant*wk>>LFFT_RHS_BITS with constant wk to an expression.
+ * Multiplications with 0 and +-(1<<LFFT_RHS_BITS) are left out, they have
+ * the same result.
+ * \param expression expression with at least 64 free characters
+ * \param sign '+' or '-' in front of the term
+ * \param operant name of the operant
+ * \param wk constant wk value
+ */
+static void _lfft_generate_product(char expression[], char sign, const char * operant, int32_t wk);
+
+/*!
+ * Writes an expression of _lfft_generate_product().
+ * \param file output file
+ * \param expression expression; an empty expression is 0
+ */
+static void _lfft_generate_expression(FILE * file, const char expression[]);
+
+/*!
+ * Writes the license and the include guard of a header.
+ * \param file output file
+ * \param guard name of the include guard
+ */
+static void _lfft_generate_header(FILE * file, const char * guard);
+
+int main(int argc, char * argv[])
+{
+    int i;
+    uint32_t samples;
+    char path[4096];
+    FILE * file;
+
+    if(argc < 2)
+    {
+        fprintf(stderr, "usage: %s output_directory [samples...]\n", argv[0]);
+        return 1;
+    }
+
+    // tables of the fixed sizes
+    snprintf(path, sizeof(path), "%s/lfft_generated_tables.h", argv[1]);
+    file = fopen(path, "w");
+    if(file == NULL)
+    {
+        fprintf(stderr, "%s: can't write %s\n", argv[0], path);
+        return 1;
+    }
+
+    _lfft_generate_header(file, "_LFFT_GENERATED_TABLES_H");
+    fprintf(file, "#ifdef __GNUC__\n");
+    fprintf(file, "#define LFFT_GENERATED_ALIGNED __attribute__((aligned(LFFT_ALIGNMENT)))\n");
+    fprintf(file, "#else\n");
+    fprintf(file, "#define LFFT_GENERATED_ALIGNED\n");
+    fprintf(file, "#endif\n\n");
+
+    fprintf(file, "typedef struct _lfft_GeneratedTables\n{\n");
+    fprintf(file, "    uint32_t samples; //!< number of samples\n");
+    fprintf(file, "    uint8_t steps; //!< number of steps\n");
+    fprintf(file, "    const uint32_t * switching_table; //!< table containing switching values for the input data\n");
+    fprintf(file, "    const int32_t * wk_real; //!< real wk values\n");
+    fprintf(file, "    const int32_t * wk_imag; //!< imaginary wk values\n");
+    fprintf(file, "    const int32_t * step_wk; //!< wk values of every step\n");
+    fprintf(file, "} lfft_GeneratedTables;\n\n");
+
+    for(i = 2; i < argc; i++)
+    {
+        samples = (uint32_t) strtoul(argv[i], NULL, 10);
+        if((samples < 2)||(samples&(samples-1)))
+        {
+            fprintf(stderr, "%s: %s is not to the power of 2 or smaller than 2\n", argv[0], argv[i]);
+            fclose(file);
+            return 1;
+        }
+        _lfft_generate_tables(file, samples);
+    }
+
+    fprintf(file, "/*!\n * number of plans with generated tables\n */\n");
+    fprintf(file, "#define LFFT_GENERATED_COUNT %d\n\n", (argc > 2) ? argc-2 : 1);
+    fprintf(file, "static const lfft_GeneratedTables _lfft_generated_tables[LFFT_GENERATED_COUNT] = {\n");
+    for(i = 2; i < argc; i++)
+    {
+        samples = (uint32_t) strtoul(argv[i], NULL, 10);
+        fprintf(file, "    {%"PRIu32", %d, _lfft_generated_switching_table_%"PRIu32", "
+                "_lfft_generated_wk_real_%"PRIu32", _lfft_generated_wk_imag_%"PRIu32", "
+                "_lfft_generated_step_wk_%"PRIu32"}%s\n", samples, (int) log2(samples),
+                samples, samples, samples, samples, (i < argc-1) ? "," : "");
+    }
+    if(argc == 2)
+    {
+        // no fixed size, the entry is never used
+        fprintf(file, "    {0, 0, NULL, NULL, NULL, NULL}\n");
+    }
+    fprintf(file, "};\n\n");
+    fprintf(file, "#endif /* _LFFT_GENERATED_TABLES_H */\n");
+    fclose(file);
+
+    // codelets
+    snprintf(path, sizeof(path), "%s/lfft_generated_codelets.h", argv[1]);
+    file = fopen(path, "w");
+    if(file == NULL)
+    {
+        fprintf(stderr, "%s: can't write %s\n", argv[0], path);
+        return 1;
+    }
+
+    _lfft_generate_header(file, "_LFFT_GENERATED_CODELETS_H");
+    fprintf(file, "/*!\n * largest fft calculated by a codelet\n */\n");
+    fprintf(file, "#define LFFT_CODELET_MAX %d\n\n", LFFT_GENERATED_CODELET_MAX);
+
+    for(samples = 2; samples <= LFFT_GENERATED_CODELET_MAX; samples <<= 1)
+    {
+        _lfft_generate_codelet(file, samples, false);
+        _lfft_generate_codelet(file, samples, true);
+    }
+
+    fprintf(file, "/*!\n * Calculates the radix-2 butterflies of a fft with samples reordered elements\n");
+    fprintf(file, " * with a codelet. The result is not divided by samples.\n");
+    fprintf(file, " * \\param samples number of samples; must be to the power of 2 and at most LFFT_CODELET_MAX\n");
+    fprintf(file, " * \\param real reordered real data; replaced by the real result\n");
+    fprintf(file, " * \\param imag reordered imaginary data; replaced by the imaginary result\n");
+    fprintf(file, " * \\param calculate_ifft false to calculate fft, true to calculate ifft\n */\n");
+    fprintf(file, "static void _lfft_codelet(uint32_t samples, int32_t real[], int32_t imag[], bool calculate_ifft)\n{\n");
+    fprintf(file, "    switch(samples)\n    {\n");
+    for(samples = 2; samples <= LFFT_GENERATED_CODELET_MAX; samples <<= 1)
+    {
+        fprintf(file, "        case %"PRIu32":\n", samples);
+        fprintf(file, "            if(calculate_ifft)\n            {\n");
+        fprintf(file, "                _lfft_codelet_ifft_%"PRIu32"(real, imag);\n", samples);
+        fprintf(file, "            }\n            else\n            {\n");
+        fprintf(file, "                _lfft_codelet_fft_%"PRIu32"(real, imag);\n", samples);
+        fprintf(file, "            }\n            break;\n");
+    }
+    fprintf(file, "        default:\n            break;\n    }\n}\n\n");
+    fprintf(file, "#endif /* _LFFT_GENERATED_CODELETS_H */\n");
+    fclose(file);
+
+    return 0;
+}
+
+static int32_t _lfft_generate_wk(uint32_t i, uint32_t samples, bool real)
+{
+    // the same expressions as _lfft_plan_power_2()
+    if(real)
+    {
+        return (int32_t) (cos((2.0f*M_PI*i)/samples)*(1<<LFFT_RHS_BITS));
+    }
+    return (int32_t) ((-sin((2.0f*M_PI*i)/samples))*(1<<LFFT_RHS_BITS));
+}
+
+static void _lfft_generate_tables(FILE * file, uint32_t samples)
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t half;
+    uint32_t new_place;
+    uint8_t steps = (uint8_t) log2(samples);
+
+    // bit-reverse
+    fprintf(file, "static const uint32_t _lfft_generated_switching_table_%"PRIu32"[%"PRIu32"] = {", samples, samples);
+    for(i = 0; i < samples; i++)
+    {
+        new_place = 0;
+        for(j = 0; j < steps; j++)
+        {
+            new_place <<= 1;
+            new_place += (i>>j)&1;
+        }
+        fprintf(file, "%s%s%"PRIu32, (i > 0) ? "," : "", (i%16 == 0) ? "\n    " : " ", new_place);
+    }
+    fprintf(file, "};\n\n");
+
+    // samples/2+1 wk values like the allocated tables
+    fprintf(file, "static const int32_t _lfft_generated_wk_real_%"PRIu32"[%"PRIu32"] = {", samples, samples/2+1);
+    for(i = 0; i <= samples/2; i++)
+    {
+        fprintf(file, "%s%s%"PRId32, (i > 0) ? "," : "", (i%16 == 0) ? "\n    " : " ",
+                (i < samples/2) ? _lfft_generate_wk(i, samples, true) : 0);
+    }
+    fprintf(file, "};\n\n");
+
+    fprintf(file, "static const int32_t _lfft_generated_wk_imag_%"PRIu32"[%"PRIu32"] = {", samples, samples/2+1);
+    for(i = 0; i <= samples/2; i++)
+    {
+        fprintf(file, "%s%s%"PRId32, (i > 0) ? "," : "", (i%16 == 0) ? "\n    " : " ",
+                (i < samples/2) ? _lfft_generate_wk(i, samples, false) : 0);
+    }
+    fprintf(file, "};\n\n");
+
+    // wk values of the steps, see LFFT_STEP_WK()
+    fprintf(file, "static const int32_t _lfft_generated_step_wk_%"PRIu32"[%"PRIu32"] LFFT_GENERATED_ALIGNED = {\n    0, 0",
+            samples, 2*samples);
+    for(half = 1; half < samples; half <<= 1)
+    {
+        for(i = 0; i < half; i++)
+        {
+            fprintf(file, ",%s%"PRId32", %"PRId32, (((half+i)%8) == 0) ? "\n    " : " ",
+                    _lfft_generate_wk(i*(samples/(2*half)), samples, true),
+                    _lfft_generate_wk(i*(samples/(2*half)), samples, false));
+        }
+    }
+    fprintf(file, "};\n\n");
+}
+
+static void _lfft_generate_codelet(FILE * file, uint32_t samples, bool calculate_ifft)
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t k;
+    uint32_t space;
+    int32_t wk_real;
+    int32_t wk_imag;
+    char name_real[32];
+    char name_imag[32];
+    char expression[256];
+
+    fprintf(file, "/*!\n * Calculates the radix-2 butterflies of a%s with %"PRIu32" reordered elements.\n",
+            calculate_ifft ? "n ifft" : " fft", samples);
+    fprintf(file, " * \\param real reordered real data; replaced by the real result\n");
+    fprintf(file, " * \\param imag reordered imaginary data; replaced by the imaginary result\n */\n");
+    fprintf(file, "static void _lfft_codelet_%s_%"PRIu32"(int32_t real[], int32_t imag[])\n{\n",
+            calculate_ifft ? "ifft" : "fft", samples);
+
+    for(i = 0; i < samples; i++)
+    {
+        fprintf(file, "    int32_t real_%"PRIu32" = real[%"PRIu32"];\n", i, i);
+        fprintf(file, "    int32_t imag_%"PRIu32" = imag[%"PRIu32"];\n", i, i);
+    }
+    fprintf(file, "    int32_t real_wk;\n    int32_t imag_wk;\n\n");
+
+    // the same butterflies as _lfft_fft_radix2()
+    for(space = 1; space < samples; space <<= 1)
+    {
+        fprintf(file, "    // space between the operants = %"PRIu32"\n", space);
+        for(j = 0; j < samples; j += 2*space)
+        {
+            for(k = 0; k < space; k++)
+            {
+                // e^(-j*2*pi*k/(2*space)) of the step, see LFFT_STEP_WK()
+                wk_real = _lfft_generate_wk(k, 2*space, true);
+                wk_imag = _lfft_generate_wk(k, 2*space, false);
+                // -sin(x) == sin(-x)
+                wk_imag = calculate_ifft ? -wk_imag : wk_imag;
+
+                snprintf(name_real, sizeof(name_real), "real_%"PRIu32, j+k+space);
+                snprintf(name_imag, sizeof(name_imag), "imag_%"PRIu32, j+k+space);
+
+                expression[0] = '\0';
+                _lfft_generate_product(expression, '+', name_real, wk_real);
+                _lfft_generate_product(expression, '-', name_imag, wk_imag);
+                fprintf(file, "    real_wk = ");
+                _lfft_generate_expression(file, expression);
+
+                expression[0] = '\0';
+                _lfft_generate_product(expression, '+', name_imag, wk_real);
+                _lfft_generate_product(expression, '+', name_real, wk_imag);
+                fprintf(file, "    imag_wk = ");
+                _lfft_generate_expression(file, expression);
+
+                fprintf(file, "    real_%"PRIu32" = real_%"PRIu32"-real_wk;\n", j+k+space, j+k);
+                fprintf(file, "    imag_%"PRIu32" = imag_%"PRIu32"-imag_wk;\n", j+k+space, j+k);
+                fprintf(file, "    real_%"PRIu32" += real_wk;\n", j+k);
+                fprintf(file, "    imag_%"PRIu32" += imag_wk;\n", j+k);
+            }
+        }
+    }
+
+    fprintf(file, "\n");
+    for(i = 0; i < samples; i++)
+    {
+        fprintf(file, "    real[%"PRIu32"] = real_%"PRIu32";\n", i, i);
+        fprintf(file, "    imag[%"PRIu32"] = imag_%"PRIu32";\n", i, i);
+    }
+    fprintf(file, "}\n\n");
+}
+
+static void _lfft_generate_product(char expression[], char sign, const char * operant, int32_t wk)
+{
+    char * end = &expression[strlen(expression)];
+
+    if(wk == 0)
+    {
+        return;
+    }
+
+    // (x*(1<<LFFT_RHS_BITS))>>LFFT_RHS_BITS == x
+    if(wk == (1<<LFFT_RHS_BITS))
+    {
+        sprintf(end, "%c%s", sign, operant);
+    }
+    else if(wk == -(1<<LFFT_RHS_BITS))
+    {
+        sprintf(end, "%c%s", (sign == '+') ? '-' : '+', operant);
+    }
+    else
+    {
+        sprintf(end, "%c((%s*(%"PRId32"))>>LFFT_RHS_BITS)", sign, operant, wk);
+    }
+}
+
+static void _lfft_generate_expression(FILE * file, const char expression[])
+{
+    if(expression[0] == '\0')
+    {
+        fprintf(file, "0;\n");
+    }
+    else
+    {
+        // a leading + is left out
+        fprintf(file, "%s;\n", (expression[0] == '+') ? &expression[1] : expression);
+    }
+}
+
+static void _lfft_generate_header(FILE * file, const char * guard)
+{
+    fprintf(file, "/* generated by lfft_generate, don't edit */\n\n");
+    fprintf(file, "#ifndef %s\n#define %s\n\n", guard, guard);
+    fprintf(file, "#include \"lfft_config.h\"\n\n");
+    fprintf(file, "#include <stddef.h>\n\n");
+}